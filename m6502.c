@@ -1,5 +1,29 @@
+#if defined(M6502_JIT) && !defined(_DEFAULT_SOURCE)
+    #define _DEFAULT_SOURCE
+#endif
+
+#if defined(M6502_JOBS) && !defined(_GNU_SOURCE)
+    #define _GNU_SOURCE
+#endif
+
+#include <stddef.h>
+#include <string.h>
+
 #include "m6502.h"
 
+#ifdef M6502_JIT
+    #include <sys/mman.h>
+#endif
+
+#if defined(M6502_JOBS) || defined(M6502_PARALLEL)
+    #include <pthread.h>
+    #include <sched.h>
+#endif
+
+#if defined(M6502_COMPUTED_GOTO) && !defined(__GNUC__)
+    #undef M6502_COMPUTED_GOTO
+#endif
+
 static const uint16_t M6502_NMIVECTOR_ADDRESS   = 0xFFFAu;
 static const uint16_t M6502_RESETVECTOR_ADDRESS = 0xFFFCu;
 static const uint16_t M6502_IRQVECTOR_ADDRESS   = 0xFFFEu;
@@ -16,42 +40,340 @@ static const uint8_t M6502_FLAG_UNUSED      = 0x20u;
 static const uint8_t M6502_FLAG_OVERFLOW    = 0x40u;
 static const uint8_t M6502_FLAG_NEGATIVE    = 0x80u;
 
-static const uint8_t M6502_INTERRUPT_NMI    = 0xF0u;
-static const uint8_t M6502_INTERRUPT_IRQ    = 0x0Fu;
+/* pendingInterrupts doubles as the attention byte: any bit set sends the run loops to their slow path. */
+static const uint8_t M6502_INTERRUPT_NMI    = 0x01u;
+static const uint8_t M6502_INTERRUPT_IRQ    = 0x02u;
+static const uint8_t M6502_ATTENTION_STOP   = 0x10u;
+static const uint8_t M6502_ATTENTION_JAM    = 0x20u;
+#ifdef M6502_IDLE_SKIP
+static const uint8_t M6502_ATTENTION_IDLE   = 0x40u;
+#endif
+#ifdef M6502_STALL
+static const uint8_t M6502_ATTENTION_STALL  = 0x80u;
+#endif
+
+#ifdef M6502_ATOMIC
+/* Posted to cpu->requests by other threads, next to the NMI, IRQ and stop bits. */
+static const uint8_t M6502_REQUEST_RELEASE  = 0x04u;
+#endif
 
 static const uint8_t M6502_MAGIC_CONSTANT   = 0x00u;
 
 static const uint16_t M6502_JAMMED_ADDRESS  = 0xFFFFu;
 
+#ifdef M6502_PINS
+/* pinStep once the instruction needs no more bus data. */
+static const uint8_t M6502_PINS_STEP_DONE   = 0xFFu;
+#endif
+
+/* OP(opcode, mnemonic, addressing mode, base cycles, memory access) */
+#define M6502_OPCODE_TABLE(OP) \
+    OP(0x00u, BRK , None,        7u, None  ) \
+    OP(0x01u, ORA , IndirectX,   6u, Read  ) \
+    OP(0x02u, JAM , Implied,     2u, None  ) \
+    OP(0x03u, SLO , IndirectX,   8u, Modify) \
+    OP(0x04u, NOP , ZeroPage,    3u, Read  ) \
+    OP(0x05u, ORA , ZeroPage,    3u, Read  ) \
+    OP(0x06u, ASL , ZeroPage,    5u, Modify) \
+    OP(0x07u, SLO , ZeroPage,    5u, Modify) \
+    OP(0x08u, PHP , Implied,     3u, None  ) \
+    OP(0x09u, ORA , Immediate,   2u, Read  ) \
+    OP(0x0Au, ASL , Accumulator, 2u, Modify) \
+    OP(0x0Bu, ANC , Immediate,   2u, Read  ) \
+    OP(0x0Cu, NOP , Absolute,    4u, Read  ) \
+    OP(0x0Du, ORA , Absolute,    4u, Read  ) \
+    OP(0x0Eu, ASL , Absolute,    6u, Modify) \
+    OP(0x0Fu, SLO , Absolute,    6u, Modify) \
+    OP(0x10u, BPL , Relative,    2u, None  ) \
+    OP(0x11u, ORA , IndirectY,   5u, Read  ) \
+    OP(0x12u, JAM , Implied,     2u, None  ) \
+    OP(0x13u, SLO , IndirectY,   8u, Modify) \
+    OP(0x14u, NOP , ZeroPageX,   4u, Read  ) \
+    OP(0x15u, ORA , ZeroPageX,   4u, Read  ) \
+    OP(0x16u, ASL , ZeroPageX,   6u, Modify) \
+    OP(0x17u, SLO , ZeroPageX,   6u, Modify) \
+    OP(0x18u, CLC , Implied,     2u, None  ) \
+    OP(0x19u, ORA , AbsoluteY,   4u, Read  ) \
+    OP(0x1Au, NOP , Implied,     2u, None  ) \
+    OP(0x1Bu, SLO , AbsoluteY,   7u, Modify) \
+    OP(0x1Cu, NOP , AbsoluteX,   4u, Read  ) \
+    OP(0x1Du, ORA , AbsoluteX,   4u, Read  ) \
+    OP(0x1Eu, ASL , AbsoluteX,   7u, Modify) \
+    OP(0x1Fu, SLO , AbsoluteX,   7u, Modify) \
+    OP(0x20u, JSR , None,        6u, None  ) \
+    OP(0x21u, AND , IndirectX,   6u, Read  ) \
+    OP(0x22u, JAM , Implied,     2u, None  ) \
+    OP(0x23u, RLA , IndirectX,   8u, Modify) \
+    OP(0x24u, BIT , ZeroPage,    3u, Read  ) \
+    OP(0x25u, AND , ZeroPage,    3u, Read  ) \
+    OP(0x26u, ROL , ZeroPage,    5u, Modify) \
+    OP(0x27u, RLA , ZeroPage,    5u, Modify) \
+    OP(0x28u, PLP , Implied,     4u, None  ) \
+    OP(0x29u, AND , Immediate,   2u, Read  ) \
+    OP(0x2Au, ROL , Accumulator, 2u, Modify) \
+    OP(0x2Bu, ANC , Immediate,   2u, Read  ) \
+    OP(0x2Cu, BIT , Absolute,    4u, Read  ) \
+    OP(0x2Du, AND , Absolute,    4u, Read  ) \
+    OP(0x2Eu, ROL , Absolute,    6u, Modify) \
+    OP(0x2Fu, RLA , Absolute,    6u, Modify) \
+    OP(0x30u, BMI , Relative,    2u, None  ) \
+    OP(0x31u, AND , IndirectY,   5u, Read  ) \
+    OP(0x32u, JAM , Implied,     2u, None  ) \
+    OP(0x33u, RLA , IndirectY,   8u, Modify) \
+    OP(0x34u, NOP , ZeroPageX,   4u, Read  ) \
+    OP(0x35u, AND , ZeroPageX,   4u, Read  ) \
+    OP(0x36u, ROL , ZeroPageX,   6u, Modify) \
+    OP(0x37u, RLA , ZeroPageX,   6u, Modify) \
+    OP(0x38u, SEC , Implied,     2u, None  ) \
+    OP(0x39u, AND , AbsoluteY,   4u, Read  ) \
+    OP(0x3Au, NOP , Implied,     2u, None  ) \
+    OP(0x3Bu, RLA , AbsoluteY,   7u, Modify) \
+    OP(0x3Cu, NOP , AbsoluteX,   4u, Read  ) \
+    OP(0x3Du, AND , AbsoluteX,   4u, Read  ) \
+    OP(0x3Eu, ROL , AbsoluteX,   7u, Modify) \
+    OP(0x3Fu, RLA , AbsoluteX,   7u, Modify) \
+    OP(0x40u, RTI , None,        6u, None  ) \
+    OP(0x41u, EOR , IndirectX,   6u, Read  ) \
+    OP(0x42u, JAM , Implied,     2u, None  ) \
+    OP(0x43u, SRE , IndirectX,   8u, Modify) \
+    OP(0x44u, NOP , ZeroPage,    3u, Read  ) \
+    OP(0x45u, EOR , ZeroPage,    3u, Read  ) \
+    OP(0x46u, LSR , ZeroPage,    5u, Modify) \
+    OP(0x47u, SRE , ZeroPage,    5u, Modify) \
+    OP(0x48u, PHA , Implied,     3u, None  ) \
+    OP(0x49u, EOR , Immediate,   2u, Read  ) \
+    OP(0x4Au, LSR , Accumulator, 2u, Modify) \
+    OP(0x4Bu, ALR , Immediate,   2u, Read  ) \
+    OP(0x4Cu, JMP , Absolute,    3u, None  ) \
+    OP(0x4Du, EOR , Absolute,    4u, Read  ) \
+    OP(0x4Eu, LSR , Absolute,    6u, Modify) \
+    OP(0x4Fu, SRE , Absolute,    6u, Modify) \
+    OP(0x50u, BVC , Relative,    2u, None  ) \
+    OP(0x51u, EOR , IndirectY,   5u, Read  ) \
+    OP(0x52u, JAM , Implied,     2u, None  ) \
+    OP(0x53u, SRE , IndirectY,   8u, Modify) \
+    OP(0x54u, NOP , ZeroPageX,   4u, Read  ) \
+    OP(0x55u, EOR , ZeroPageX,   4u, Read  ) \
+    OP(0x56u, LSR , ZeroPageX,   6u, Modify) \
+    OP(0x57u, SRE , ZeroPageX,   6u, Modify) \
+    OP(0x58u, CLI , Implied,     2u, None  ) \
+    OP(0x59u, EOR , AbsoluteY,   4u, Read  ) \
+    OP(0x5Au, NOP , Implied,     2u, None  ) \
+    OP(0x5Bu, SRE , AbsoluteY,   7u, Modify) \
+    OP(0x5Cu, NOP , AbsoluteX,   4u, Read  ) \
+    OP(0x5Du, EOR , AbsoluteX,   4u, Read  ) \
+    OP(0x5Eu, LSR , AbsoluteX,   7u, Modify) \
+    OP(0x5Fu, SRE , AbsoluteX,   7u, Modify) \
+    OP(0x60u, RTS , None,        6u, None  ) \
+    OP(0x61u, ADC , IndirectX,   6u, Read  ) \
+    OP(0x62u, JAM , Implied,     2u, None  ) \
+    OP(0x63u, RRA , IndirectX,   8u, Modify) \
+    OP(0x64u, NOP , ZeroPage,    3u, Read  ) \
+    OP(0x65u, ADC , ZeroPage,    3u, Read  ) \
+    OP(0x66u, ROR , ZeroPage,    5u, Modify) \
+    OP(0x67u, RRA , ZeroPage,    5u, Modify) \
+    OP(0x68u, PLA , Implied,     4u, None  ) \
+    OP(0x69u, ADC , Immediate,   2u, Read  ) \
+    OP(0x6Au, ROR , Accumulator, 2u, Modify) \
+    OP(0x6Bu, ARR , Immediate,   2u, Read  ) \
+    OP(0x6Cu, JMP , Indirect,    5u, None  ) \
+    OP(0x6Du, ADC , Absolute,    4u, Read  ) \
+    OP(0x6Eu, ROR , Absolute,    6u, Modify) \
+    OP(0x6Fu, RRA , Absolute,    6u, Modify) \
+    OP(0x70u, BVS , Relative,    2u, None  ) \
+    OP(0x71u, ADC , IndirectY,   5u, Read  ) \
+    OP(0x72u, JAM , Implied,     2u, None  ) \
+    OP(0x73u, RRA , IndirectY,   8u, Modify) \
+    OP(0x74u, NOP , ZeroPageX,   4u, Read  ) \
+    OP(0x75u, ADC , ZeroPageX,   4u, Read  ) \
+    OP(0x76u, ROR , ZeroPageX,   6u, Modify) \
+    OP(0x77u, RRA , ZeroPageX,   6u, Modify) \
+    OP(0x78u, SEI , Implied,     2u, None  ) \
+    OP(0x79u, ADC , AbsoluteY,   4u, Read  ) \
+    OP(0x7Au, NOP , Implied,     2u, None  ) \
+    OP(0x7Bu, RRA , AbsoluteY,   7u, Modify) \
+    OP(0x7Cu, NOP , AbsoluteX,   4u, Read  ) \
+    OP(0x7Du, ADC , AbsoluteX,   4u, Read  ) \
+    OP(0x7Eu, ROR , AbsoluteX,   7u, Modify) \
+    OP(0x7Fu, RRA , AbsoluteX,   7u, Modify) \
+    OP(0x80u, NOP , Immediate,   2u, Read  ) \
+    OP(0x81u, STA , IndirectX,   6u, Write ) \
+    OP(0x82u, NOP , Immediate,   2u, Read  ) \
+    OP(0x83u, SAX , IndirectX,   6u, Write ) \
+    OP(0x84u, STY , ZeroPage,    3u, Write ) \
+    OP(0x85u, STA , ZeroPage,    3u, Write ) \
+    OP(0x86u, STX , ZeroPage,    3u, Write ) \
+    OP(0x87u, SAX , ZeroPage,    3u, Write ) \
+    OP(0x88u, DEY , Implied,     2u, None  ) \
+    OP(0x89u, NOP , Immediate,   2u, Read  ) \
+    OP(0x8Au, TXA , Implied,     2u, None  ) \
+    OP(0x8Bu, ANE , Immediate,   2u, Read  ) \
+    OP(0x8Cu, STY , Absolute,    4u, Write ) \
+    OP(0x8Du, STA , Absolute,    4u, Write ) \
+    OP(0x8Eu, STX , Absolute,    4u, Write ) \
+    OP(0x8Fu, SAX , Absolute,    4u, Write ) \
+    OP(0x90u, BCC , Relative,    2u, None  ) \
+    OP(0x91u, STA , IndirectY,   6u, Write ) \
+    OP(0x92u, JAM , Implied,     2u, None  ) \
+    OP(0x93u, SHA , IndirectY,   6u, Write ) \
+    OP(0x94u, STY , ZeroPageX,   4u, Write ) \
+    OP(0x95u, STA , ZeroPageX,   4u, Write ) \
+    OP(0x96u, STX , ZeroPageY,   4u, Write ) \
+    OP(0x97u, SAX , ZeroPageY,   4u, Write ) \
+    OP(0x98u, TYA , Implied,     2u, None  ) \
+    OP(0x99u, STA , AbsoluteY,   5u, Write ) \
+    OP(0x9Au, TXS , Implied,     2u, None  ) \
+    OP(0x9Bu, TAS , AbsoluteY,   5u, Write ) \
+    OP(0x9Cu, SHY , AbsoluteX,   5u, Write ) \
+    OP(0x9Du, STA , AbsoluteX,   5u, Write ) \
+    OP(0x9Eu, SHX , AbsoluteY,   5u, Write ) \
+    OP(0x9Fu, SHA , AbsoluteY,   5u, Write ) \
+    OP(0xA0u, LDY , Immediate,   2u, Read  ) \
+    OP(0xA1u, LDA , IndirectX,   6u, Read  ) \
+    OP(0xA2u, LDX , Immediate,   2u, Read  ) \
+    OP(0xA3u, LAX , IndirectX,   6u, Read  ) \
+    OP(0xA4u, LDY , ZeroPage,    3u, Read  ) \
+    OP(0xA5u, LDA , ZeroPage,    3u, Read  ) \
+    OP(0xA6u, LDX , ZeroPage,    3u, Read  ) \
+    OP(0xA7u, LAX , ZeroPage,    3u, Read  ) \
+    OP(0xA8u, TAY , Implied,     2u, None  ) \
+    OP(0xA9u, LDA , Immediate,   2u, Read  ) \
+    OP(0xAAu, TAX , Implied,     2u, None  ) \
+    OP(0xABu, LXA , Immediate,   2u, Read  ) \
+    OP(0xACu, LDY , Absolute,    4u, Read  ) \
+    OP(0xADu, LDA , Absolute,    4u, Read  ) \
+    OP(0xAEu, LDX , Absolute,    4u, Read  ) \
+    OP(0xAFu, LAX , Absolute,    4u, Read  ) \
+    OP(0xB0u, BCS , Relative,    2u, None  ) \
+    OP(0xB1u, LDA , IndirectY,   5u, Read  ) \
+    OP(0xB2u, JAM , Implied,     2u, None  ) \
+    OP(0xB3u, LAX , IndirectY,   5u, Read  ) \
+    OP(0xB4u, LDY , ZeroPageX,   4u, Read  ) \
+    OP(0xB5u, LDA , ZeroPageX,   4u, Read  ) \
+    OP(0xB6u, LDX , ZeroPageY,   4u, Read  ) \
+    OP(0xB7u, LAX , ZeroPageY,   4u, Read  ) \
+    OP(0xB8u, CLV , Implied,     2u, None  ) \
+    OP(0xB9u, LDA , AbsoluteY,   4u, Read  ) \
+    OP(0xBAu, TSX , Implied,     2u, None  ) \
+    OP(0xBBu, LAS , AbsoluteY,   4u, Read  ) \
+    OP(0xBCu, LDY , AbsoluteX,   4u, Read  ) \
+    OP(0xBDu, LDA , AbsoluteX,   4u, Read  ) \
+    OP(0xBEu, LDX , AbsoluteY,   4u, Read  ) \
+    OP(0xBFu, LAX , AbsoluteY,   4u, Read  ) \
+    OP(0xC0u, CPY , Immediate,   2u, Read  ) \
+    OP(0xC1u, CMP , IndirectX,   6u, Read  ) \
+    OP(0xC2u, NOP , Immediate,   2u, Read  ) \
+    OP(0xC3u, DCP , IndirectX,   8u, Modify) \
+    OP(0xC4u, CPY , ZeroPage,    3u, Read  ) \
+    OP(0xC5u, CMP , ZeroPage,    3u, Read  ) \
+    OP(0xC6u, DEC , ZeroPage,    5u, Modify) \
+    OP(0xC7u, DCP , ZeroPage,    5u, Modify) \
+    OP(0xC8u, INY , Implied,     2u, None  ) \
+    OP(0xC9u, CMP , Immediate,   2u, Read  ) \
+    OP(0xCAu, DEX , Implied,     2u, None  ) \
+    OP(0xCBu, SBX , Immediate,   2u, Read  ) \
+    OP(0xCCu, CPY , Absolute,    4u, Read  ) \
+    OP(0xCDu, CMP , Absolute,    4u, Read  ) \
+    OP(0xCEu, DEC , Absolute,    6u, Modify) \
+    OP(0xCFu, DCP , Absolute,    6u, Modify) \
+    OP(0xD0u, BNE , Relative,    2u, None  ) \
+    OP(0xD1u, CMP , IndirectY,   5u, Read  ) \
+    OP(0xD2u, JAM , Implied,     2u, None  ) \
+    OP(0xD3u, DCP , IndirectY,   8u, Modify) \
+    OP(0xD4u, NOP , ZeroPageX,   4u, Read  ) \
+    OP(0xD5u, CMP , ZeroPageX,   4u, Read  ) \
+    OP(0xD6u, DEC , ZeroPageX,   6u, Modify) \
+    OP(0xD7u, DCP , ZeroPageX,   6u, Modify) \
+    OP(0xD8u, CLD , Implied,     2u, None  ) \
+    OP(0xD9u, CMP , AbsoluteY,   4u, Read  ) \
+    OP(0xDAu, NOP , Implied,     2u, None  ) \
+    OP(0xDBu, DCP , AbsoluteY,   7u, Modify) \
+    OP(0xDCu, NOP , AbsoluteX,   4u, Read  ) \
+    OP(0xDDu, CMP , AbsoluteX,   4u, Read  ) \
+    OP(0xDEu, DEC , AbsoluteX,   7u, Modify) \
+    OP(0xDFu, DCP , AbsoluteX,   7u, Modify) \
+    OP(0xE0u, CPX , Immediate,   2u, Read  ) \
+    OP(0xE1u, SBC , IndirectX,   6u, Read  ) \
+    OP(0xE2u, NOP , Immediate,   2u, Read  ) \
+    OP(0xE3u, ISC , IndirectX,   8u, Modify) \
+    OP(0xE4u, CPX , ZeroPage,    3u, Read  ) \
+    OP(0xE5u, SBC , ZeroPage,    3u, Read  ) \
+    OP(0xE6u, INC , ZeroPage,    5u, Modify) \
+    OP(0xE7u, ISC , ZeroPage,    5u, Modify) \
+    OP(0xE8u, INX , Implied,     2u, None  ) \
+    OP(0xE9u, SBC , Immediate,   2u, Read  ) \
+    OP(0xEAu, NOP , Implied,     2u, None  ) \
+    OP(0xEBu, USBC, Immediate,   2u, Read  ) \
+    OP(0xECu, CPX , Absolute,    4u, Read  ) \
+    OP(0xEDu, SBC , Absolute,    4u, Read  ) \
+    OP(0xEEu, INC , Absolute,    6u, Modify) \
+    OP(0xEFu, ISC , Absolute,    6u, Modify) \
+    OP(0xF0u, BEQ , Relative,    2u, None  ) \
+    OP(0xF1u, SBC , IndirectY,   5u, Read  ) \
+    OP(0xF2u, JAM , Implied,     2u, None  ) \
+    OP(0xF3u, ISC , IndirectY,   8u, Modify) \
+    OP(0xF4u, NOP , ZeroPageX,   4u, Read  ) \
+    OP(0xF5u, SBC , ZeroPageX,   4u, Read  ) \
+    OP(0xF6u, INC , ZeroPageX,   6u, Modify) \
+    OP(0xF7u, ISC , ZeroPageX,   6u, Modify) \
+    OP(0xF8u, SED , Implied,     2u, None  ) \
+    OP(0xF9u, SBC , AbsoluteY,   4u, Read  ) \
+    OP(0xFAu, NOP , Implied,     2u, None  ) \
+    OP(0xFBu, ISC , AbsoluteY,   7u, Modify) \
+    OP(0xFCu, NOP , AbsoluteX,   4u, Read  ) \
+    OP(0xFDu, SBC , AbsoluteX,   4u, Read  ) \
+    OP(0xFEu, INC , AbsoluteX,   7u, Modify) \
+    OP(0xFFu, ISC , AbsoluteX,   7u, Modify)
+
+#define M6502_OPCODE_CYCLES_ENTRY(opcode, mnemonic, mode, cycles, access) \
+    [opcode] = cycles,
+
+#define M6502_OPCODE_INFO_ENTRY(opcode, mnemonic, mode, cycles, access) \
+    [opcode] = { #mnemonic, M6502_Instruction_##mnemonic, M6502_AddressMode_##mode, M6502_Access_##access, cycles },
+
 static const uint8_t M6502_OPCODE_CYCLES[0x100] = {
-    7u, 6u, 2u, 8u, 3u, 3u, 5u, 5u, 3u, 2u, 2u, 2u, 4u, 4u, 6u, 6u,
-    2u, 5u, 2u, 8u, 4u, 4u, 6u, 6u, 2u, 4u, 2u, 7u, 4u, 4u, 7u, 7u,
-    6u, 6u, 2u, 8u, 3u, 3u, 5u, 5u, 4u, 2u, 2u, 2u, 4u, 4u, 6u, 6u,
-    2u, 5u, 2u, 8u, 4u, 4u, 6u, 6u, 2u, 4u, 2u, 7u, 4u, 4u, 7u, 7u,
-    6u, 6u, 2u, 8u, 3u, 3u, 5u, 5u, 3u, 2u, 2u, 2u, 3u, 4u, 6u, 6u,
-    2u, 5u, 2u, 8u, 4u, 4u, 6u, 6u, 2u, 4u, 2u, 7u, 4u, 4u, 7u, 7u,
-    6u, 6u, 2u, 8u, 3u, 3u, 5u, 5u, 4u, 2u, 2u, 2u, 5u, 4u, 6u, 6u,
-    2u, 5u, 2u, 8u, 4u, 4u, 6u, 6u, 2u, 4u, 2u, 7u, 4u, 4u, 7u, 7u,
-    2u, 6u, 2u, 6u, 3u, 3u, 3u, 3u, 2u, 2u, 2u, 2u, 4u, 4u, 4u, 4u,
-    2u, 6u, 2u, 6u, 4u, 4u, 4u, 4u, 2u, 5u, 2u, 5u, 5u, 5u, 5u, 5u,
-    2u, 6u, 2u, 6u, 3u, 3u, 3u, 3u, 2u, 2u, 2u, 2u, 4u, 4u, 4u, 4u,
-    2u, 5u, 2u, 5u, 4u, 4u, 4u, 4u, 2u, 4u, 2u, 4u, 4u, 4u, 4u, 4u,
-    2u, 6u, 2u, 8u, 3u, 3u, 5u, 5u, 2u, 2u, 2u, 2u, 4u, 4u, 6u, 6u,
-    2u, 5u, 2u, 8u, 4u, 4u, 6u, 6u, 2u, 4u, 2u, 7u, 4u, 4u, 7u, 7u,
-    2u, 6u, 2u, 8u, 3u, 3u, 5u, 5u, 2u, 2u, 2u, 2u, 4u, 4u, 6u, 6u,
-    2u, 5u, 2u, 8u, 4u, 4u, 6u, 6u, 2u, 4u, 2u, 7u, 4u, 4u, 7u, 7u 
+    M6502_OPCODE_TABLE(M6502_OPCODE_CYCLES_ENTRY)
+};
+
+static const M6502_OpcodeInfo_t M6502_OPCODE_INFO[0x100] = {
+    M6502_OPCODE_TABLE(M6502_OPCODE_INFO_ENTRY)
 };
 
-static inline uint8_t   M6502_ReadMemoryByte(const uint16_t address);
-static inline uint16_t  M6502_ReadMemoryWord(const uint16_t address);
-static inline void      M6502_WriteMemoryByte(const uint16_t address, const uint8_t value);
-static inline void      M6502_WriteMemoryWord(const uint16_t address, const uint16_t value);
+#if defined(M6502_IDLE_SKIP) || defined(M6502_BLOCK_CACHE) || defined(M6502_BATCH_SIMD)
+static const uint8_t M6502_OPERAND_BYTES[] = {
+    [M6502_AddressMode_None]        = 0u,
+    [M6502_AddressMode_Implied]     = 0u,
+    [M6502_AddressMode_Accumulator] = 0u,
+    [M6502_AddressMode_Immediate]   = 1u,
+    [M6502_AddressMode_Relative]    = 1u,
+    [M6502_AddressMode_Absolute]    = 2u,
+    [M6502_AddressMode_AbsoluteX]   = 2u,
+    [M6502_AddressMode_AbsoluteY]   = 2u,
+    [M6502_AddressMode_ZeroPage]    = 1u,
+    [M6502_AddressMode_ZeroPageX]   = 1u,
+    [M6502_AddressMode_ZeroPageY]   = 1u,
+    [M6502_AddressMode_Indirect]    = 2u,
+    [M6502_AddressMode_IndirectX]   = 1u,
+    [M6502_AddressMode_IndirectY]   = 1u
+};
+#endif
+
+static inline uint8_t   M6502_ReadMemoryByte(M6502_t *cpu, const uint16_t address);
+static inline uint16_t  M6502_ReadMemoryWord(M6502_t *cpu, const uint16_t address);
+static inline uint16_t  M6502_ReadMemoryPair(M6502_t *cpu, const uint16_t low, const uint16_t high);
+#if defined(M6502_BLOCK_CACHE) || defined(M6502_IDLE_SKIP)
+static inline uint8_t   M6502_PeekMemoryByte(M6502_t *cpu, const uint16_t address, uint8_t *value);
+#endif
+static inline void      M6502_WriteMemoryByte(M6502_t *cpu, const uint16_t address, const uint8_t value);
+static inline void      M6502_WriteMemoryWord(M6502_t *cpu, const uint16_t address, const uint16_t value);
 
-static inline uint8_t   M6502_DummyRead(const uint16_t address);
-static inline void      M6502_DummyWrite(const uint16_t address, const uint8_t value);
+static inline uint8_t   M6502_DummyRead(M6502_t *cpu, const uint16_t address);
+static inline void      M6502_DummyWrite(M6502_t *cpu, const uint16_t address, const uint8_t value);
 
 static inline void      M6502_SetFlag(M6502_t *cpu, const uint8_t flag, const uint8_t value);
 static inline uint8_t   M6502_GetFlag(M6502_t *cpu, const uint8_t flag);
+static inline uint8_t   M6502_PackStatus(const M6502_t *cpu);
+static inline void      M6502_UnpackStatus(M6502_t *cpu, const uint8_t status);
 
 static inline void      M6502_PushByte(M6502_t *cpu, const uint8_t value);
 static inline void      M6502_PushWord(M6502_t *cpu, const uint16_t value);
@@ -63,29 +385,79 @@ static inline void M6502_ZeroTest(M6502_t *cpu, const uint16_t value);
 static inline void M6502_OverFlowTest(M6502_t *cpu, const uint16_t value, const uint16_t result);
 static inline void M6502_NegativeTest(M6502_t *cpu, const uint16_t value);
 
-static inline void M6502_Address_Implied(M6502_t *cpu);
-static inline void M6502_Address_Accumulator(M6502_t *cpu);
-static inline void M6502_Address_Immediate(M6502_t *cpu);
-static inline void M6502_Address_Relative(M6502_t *cpu);
-static inline void M6502_Address_Absolute(M6502_t *cpu);
-static inline void M6502_Address_AbsoluteX(M6502_t *cpu);
-static inline void M6502_Address_AbsoluteY(M6502_t *cpu);
-static inline void M6502_Address_ZeroPage(M6502_t *cpu);
-static inline void M6502_Address_ZeroPageX(M6502_t *cpu);
-static inline void M6502_Address_ZeroPageY(M6502_t *cpu);
-static inline void M6502_Address_Indirect(M6502_t *cpu);
-static inline void M6502_Address_IndirectX(M6502_t *cpu);
-static inline void M6502_Address_IndirectY(M6502_t *cpu);
-
+static inline uint16_t M6502_Operand_Byte(M6502_t *cpu);
+static inline uint16_t M6502_Operand_Word(M6502_t *cpu);
+static inline uint16_t M6502_Operand_Fetch(M6502_t *cpu, const M6502_AddressMode_t mode);
+
+static inline void M6502_Address_None(M6502_t *cpu, const uint16_t operand, const M6502_Access_t access);
+static inline void M6502_Address_Implied(M6502_t *cpu, const uint16_t operand, const M6502_Access_t access);
+static inline void M6502_Address_Accumulator(M6502_t *cpu, const uint16_t operand, const M6502_Access_t access);
+static inline void M6502_Address_Immediate(M6502_t *cpu, const uint16_t operand, const M6502_Access_t access);
+static inline void M6502_Address_Relative(M6502_t *cpu, const uint16_t operand, const M6502_Access_t access);
+static inline void M6502_Address_Absolute(M6502_t *cpu, const uint16_t operand, const M6502_Access_t access);
+static inline void M6502_Address_AbsoluteX(M6502_t *cpu, const uint16_t operand, const M6502_Access_t access);
+static inline void M6502_Address_AbsoluteY(M6502_t *cpu, const uint16_t operand, const M6502_Access_t access);
+static inline void M6502_Address_ZeroPage(M6502_t *cpu, const uint16_t operand, const M6502_Access_t access);
+static inline void M6502_Address_ZeroPageX(M6502_t *cpu, const uint16_t operand, const M6502_Access_t access);
+static inline void M6502_Address_ZeroPageY(M6502_t *cpu, const uint16_t operand, const M6502_Access_t access);
+static inline void M6502_Address_Indirect(M6502_t *cpu, const uint16_t operand, const M6502_Access_t access);
+static inline void M6502_Address_IndirectX(M6502_t *cpu, const uint16_t operand, const M6502_Access_t access);
+static inline void M6502_Address_IndirectY(M6502_t *cpu, const uint16_t operand, const M6502_Access_t access);
+
+static inline void M6502_Util_ReadOperand(M6502_t *cpu, const M6502_Access_t access);
+static inline void M6502_Util_PageCross(M6502_t *cpu, const uint16_t base, const M6502_Access_t access);
 static inline void M6502_Util_WriteResult(M6502_t *cpu, const uint16_t result);
 static inline void M6502_Util_Branch(M6502_t *cpu);
 static inline void M6502_Util_Interrupt(M6502_t *cpu);
 
-static inline void M6502_Opcode_Group01(M6502_t *cpu);
-static inline void M6502_Opcode_Group10(M6502_t *cpu);
-static inline void M6502_Opcode_Group11(M6502_t *cpu);
-static inline void M6502_Opcode_Group00(M6502_t *cpu);
-static inline void M6502_Opcode_Group00_Branch(M6502_t *cpu);
+static inline void    M6502_Raise(M6502_t *cpu, const uint8_t bits);
+static inline uint32_t M6502_Lines_IRQ(M6502_t *cpu);
+static inline uint8_t M6502_InterruptDue(M6502_t *cpu);
+static inline __attribute__((always_inline)) void M6502_Execute(M6502_t *cpu);
+static uint32_t    M6502_Run_Slice(M6502_t *cpu, const uint32_t cycles);
+
+#ifdef M6502_PINS
+static uint8_t     M6502_Pins_Access(M6502_t *cpu, const uint16_t address, const uint8_t value, const uint32_t read);
+#endif
+
+#ifdef M6502_ATOMIC
+static inline void              M6502_Requests_Take(M6502_t *cpu);
+#endif
+
+#ifdef M6502_STALL
+static inline uint32_t          M6502_Stall_Skip(M6502_t *cpu, uint32_t elapsed, const uint32_t cycles);
+#endif
+
+#ifdef M6502_HLE
+static inline uint8_t           M6502_Trap_At(const M6502_t *cpu, const uint16_t address);
+static void                     M6502_Trap_Call(M6502_t *cpu);
+#endif
+
+#ifdef M6502_SCHEDULER
+static inline uint8_t           M6502_Scheduler_Before(const M6502_t *cpu, const uint8_t first, const uint8_t second);
+static void                     M6502_Scheduler_Swap(M6502_t *cpu, const uint8_t first, const uint8_t second);
+static void                     M6502_Scheduler_Sift(M6502_t *cpu, uint8_t position);
+static void                     M6502_Scheduler_Remove(M6502_t *cpu, const uint8_t position);
+static inline void              M6502_Scheduler_Fire(M6502_t *cpu);
+#endif
+
+#ifdef M6502_IDLE_SKIP
+static void                     M6502_Idle_Arrive(M6502_t *cpu, const uint16_t jump, const uint16_t target);
+static inline uint32_t          M6502_Idle_Skip(M6502_t *cpu, uint32_t elapsed, const uint32_t cycles);
+#endif
+
+#ifdef M6502_BLOCK_CACHE
+static inline void              M6502_BlockCache_InvalidatePage(M6502_BlockCache_t *cache, const uint8_t page);
+static inline uint8_t           M6502_BlockCache_EndsBlock(const uint8_t opcode);
+static M6502_Block_t           *M6502_BlockCache_Translate(M6502_t *cpu, const uint16_t start);
+static inline M6502_Block_t    *M6502_BlockCache_Lookup(M6502_t *cpu, const uint16_t address);
+static uint32_t                 M6502_BlockCache_Run(M6502_t *cpu, uint32_t elapsed, const uint32_t cycles);
+#endif
+
+#ifdef M6502_JIT
+static void M6502_Jit_Compile(M6502_t *cpu, M6502_Block_t *block);
+static void M6502_Jit_Flush(M6502_BlockCache_t *cache);
+#endif
 
 static inline void M6502_Opcode_ADC(M6502_t *cpu);
 static inline void M6502_Opcode_AND(M6502_t *cpu);
@@ -166,57 +538,238 @@ static inline void M6502_Opcode_TAS(M6502_t *cpu);
 static inline void M6502_Opcode_USBC(M6502_t *cpu);
 static inline void M6502_Opcode_JAM(M6502_t *cpu);
 
-static inline uint8_t M6502_ReadMemoryByte(const uint16_t address)
+static inline uint8_t M6502_ReadMemoryByte(M6502_t *cpu, const uint16_t address)
 {
+#ifdef M6502_FLAT_MEMORY
+    return cpu->memory[address];
+#else
+#ifdef M6502_PAGE_TABLE
+    const uintptr_t bias = cpu->readPages[address >> 8u];
+
+    if (bias != 0u)
+    {
+        return *(const uint8_t *)(bias + address);
+    }
+#endif
+
+#ifdef M6502_BUS
+    return cpu->bus.read(cpu->bus.context, address);
+#else
+    (void)cpu;
+
     return M6502_ExternalReadMemory(address);
+#endif
+#endif
 }
 
-static inline uint16_t M6502_ReadMemoryWord(const uint16_t address)
+static inline uint16_t M6502_ReadMemoryWord(M6502_t *cpu, const uint16_t address)
 {
-    const uint16_t low  = (uint16_t)M6502_ExternalReadMemory(address);
-    const uint16_t high = (uint16_t)M6502_ExternalReadMemory(address + 1u) << 8u;
+    return M6502_ReadMemoryPair(cpu, address, address + 1u);
+}
 
-    return (high | low);
+static inline uint16_t M6502_ReadMemoryPair(M6502_t *cpu, const uint16_t low, const uint16_t high)
+{
+#if defined(M6502_FLAT_MEMORY) && defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+    /* One host load, unless the high byte wraps around a page or the address space. */
+    if (((uint32_t)low + 1u) == high)
+    {
+        uint16_t word;
+
+        memcpy(&word, cpu->memory + low, sizeof(word));
+
+        return word;
+    }
+#endif
+
+    const uint16_t lowByte  = (uint16_t)M6502_ReadMemoryByte(cpu, low);
+    const uint16_t highByte = (uint16_t)M6502_ReadMemoryByte(cpu, high) << 8u;
+
+    return (highByte | lowByte);
+}
+
+#if defined(M6502_BLOCK_CACHE) || defined(M6502_IDLE_SKIP)
+/*
+ * Reads memory the CPU is not accessing only where nobody can tell: flat memory, pages mapped
+ * with M6502_MapMemory and pages marked side-effect free. Returns 0 for bytes behind the bus.
+ */
+static inline uint8_t M6502_PeekMemoryByte(M6502_t *cpu, const uint16_t address, uint8_t *value)
+{
+#ifdef M6502_FLAT_MEMORY
+    *value = cpu->memory[address];
+    return 1u;
+#else
+#ifdef M6502_PAGE_TABLE
+    const uintptr_t bias = cpu->readPages[address >> 8u];
+
+    if (bias != 0u)
+    {
+        *value = *(const uint8_t *)(bias + address);
+        return 1u;
+    }
+#endif
+
+#ifdef M6502_SIDE_EFFECT_FREE
+    if (cpu->sideEffectFree[address >> 8u] != 0u)
+    {
+        *value = M6502_ReadMemoryByte(cpu, address);
+        return 1u;
+    }
+#endif
+
+    (void)cpu;
+    (void)address;
+    (void)value;
+    return 0u;
+#endif
 }
+#endif
 
-static inline void M6502_WriteMemoryByte(const uint16_t address, const uint8_t value)
+static inline void M6502_WriteMemoryByte(M6502_t *cpu, const uint16_t address, const uint8_t value)
 {
-    M6502_ExternalWriteMemory(address, value);
+#ifdef M6502_FLAT_MEMORY
+    cpu->memory[address] = value;
+#else
+#ifdef M6502_PAGE_TABLE
+    const uintptr_t bias = cpu->writePages[address >> 8u];
+
+    if (bias != 0u)
+    {
+        *(uint8_t *)(bias + address) = value;
+    }
+    else
+#endif
+    {
+#ifdef M6502_BUS
+        cpu->bus.write(cpu->bus.context, address, value);
+#else
+        M6502_ExternalWriteMemory(address, value);
+#endif
+    }
+#endif
+
+#ifdef M6502_BLOCK_CACHE
+    if ((cpu->blockCache != NULL) && (cpu->blockCache->codePages[address >> 8u] != 0u))
+    {
+        M6502_BlockCache_InvalidatePage(cpu->blockCache, (uint8_t)(address >> 8u));
+    }
+#else
+    (void)cpu;
+#endif
 }
 
-static inline void M6502_WriteMemoryWord(const uint16_t address, const uint16_t value)
+static inline void M6502_WriteMemoryWord(M6502_t *cpu, const uint16_t address, const uint16_t value)
 {
     const uint8_t low  = (uint8_t)(value & 0xFFu);
     const uint8_t high = (uint8_t)((value >> 8u) & 0xFFu);
 
-    M6502_ExternalWriteMemory(address,      high);
-    M6502_ExternalWriteMemory(address + 1u,  low);
+    M6502_WriteMemoryByte(cpu, address,      high);
+    M6502_WriteMemoryByte(cpu, address + 1u,  low);
 }
 
-static inline uint8_t M6502_DummyRead(const uint16_t address)
+static inline uint8_t M6502_DummyRead(M6502_t *cpu, const uint16_t address)
 {
-    return M6502_ReadMemoryByte(address);
+#ifdef M6502_FLAT_MEMORY
+    /* Plain RAM has no side effects to reproduce. */
+    (void)cpu;
+    (void)address;
+
+    return 0x00u;
+#else
+#ifdef M6502_SIDE_EFFECT_FREE
+    if (cpu->sideEffectFree[address >> 8u] != 0u)
+    {
+        return 0x00u;
+    }
+#endif
+
+    return M6502_ReadMemoryByte(cpu, address);
+#endif
 }
 
-static inline void M6502_DummyWrite(const uint16_t address, const uint8_t value)
+static inline void M6502_DummyWrite(M6502_t *cpu, const uint16_t address, const uint8_t value)
 {
-    M6502_WriteMemoryByte(address, value);
+#ifdef M6502_PINS
+    if (cpu->pinTicking != 0u)
+    {
+        M6502_Pins_Access(cpu, address, value, 0u);
+        return;
+    }
+#endif
+
+#ifdef M6502_FLAT_MEMORY
+    (void)cpu;
+    (void)address;
+    (void)value;
+#else
+#ifdef M6502_SIDE_EFFECT_FREE
+    if (cpu->sideEffectFree[address >> 8u] != 0u)
+    {
+        return;
+    }
+#endif
+
+    M6502_WriteMemoryByte(cpu, address, value);
+#endif
 }
 
 static inline void M6502_SetFlag(M6502_t *cpu, const uint8_t flag, const uint8_t value)
 {
+#ifdef M6502_LAZY_FLAGS
+    /* N, Z, C and V live outside the status register until P is needed. */
+    if (flag == M6502_FLAG_NEGATIVE)    { cpu->negativeResult = value ? 0x80u : 0x00u;  return; }
+    if (flag == M6502_FLAG_ZERO)        { cpu->zeroResult = value ? 0x00u : 0x01u;      return; }
+    if (flag == M6502_FLAG_CARRY)       { cpu->carryFlag = value ? 1u : 0u;             return; }
+    if (flag == M6502_FLAG_OVERFLOW)    { cpu->overflowFlag = value ? 1u : 0u;          return; }
+#endif
+
     if (value)  cpu->statusRegister |= flag;
 	else        cpu->statusRegister &= ~flag;
 }
 
 static inline uint8_t M6502_GetFlag(M6502_t *cpu, const uint8_t flag)
 {
+#ifdef M6502_LAZY_FLAGS
+    if (flag == M6502_FLAG_NEGATIVE)    return (cpu->negativeResult >> 7u);
+    if (flag == M6502_FLAG_ZERO)        return (cpu->zeroResult == 0u) ? 1u : 0u;
+    if (flag == M6502_FLAG_CARRY)       return cpu->carryFlag;
+    if (flag == M6502_FLAG_OVERFLOW)    return cpu->overflowFlag;
+#endif
+
     return ((cpu->statusRegister & flag) > 0u) ? 1u : 0u;
 }
 
+static inline uint8_t M6502_PackStatus(const M6502_t *cpu)
+{
+#ifdef M6502_LAZY_FLAGS
+    uint8_t status = cpu->statusRegister
+        & (uint8_t)~(M6502_FLAG_NEGATIVE | M6502_FLAG_OVERFLOW | M6502_FLAG_ZERO | M6502_FLAG_CARRY);
+
+    status |= (cpu->negativeResult & M6502_FLAG_NEGATIVE);
+    status |= (cpu->zeroResult == 0u) ? M6502_FLAG_ZERO : 0u;
+    status |= (cpu->carryFlag != 0u) ? M6502_FLAG_CARRY : 0u;
+    status |= (cpu->overflowFlag != 0u) ? M6502_FLAG_OVERFLOW : 0u;
+
+    return status;
+#else
+    return cpu->statusRegister;
+#endif
+}
+
+static inline void M6502_UnpackStatus(M6502_t *cpu, const uint8_t status)
+{
+    cpu->statusRegister = status;
+
+#ifdef M6502_LAZY_FLAGS
+    cpu->negativeResult = status & M6502_FLAG_NEGATIVE;
+    cpu->zeroResult     = (status & M6502_FLAG_ZERO) ? 0x00u : 0x01u;
+    cpu->carryFlag      = (status & M6502_FLAG_CARRY) ? 1u : 0u;
+    cpu->overflowFlag   = (status & M6502_FLAG_OVERFLOW) ? 1u : 0u;
+#endif
+}
+
 static inline void M6502_PushByte(M6502_t *cpu, const uint8_t value)
 {
-    M6502_ExternalWriteMemory(M6502_STACK_ADDRESS + cpu->stackPointer, value);
+    M6502_WriteMemoryByte(cpu, M6502_STACK_ADDRESS + cpu->stackPointer, value);
     
     cpu->stackPointer = (cpu->stackPointer - 1u) & 0xFFu;
 }
@@ -234,7 +787,7 @@ static inline uint8_t M6502_PullByte(M6502_t *cpu)
 {
     cpu->stackPointer = (cpu->stackPointer + 1u) & 0xFFu;
 
-    return M6502_ExternalReadMemory(M6502_STACK_ADDRESS + cpu->stackPointer);
+    return M6502_ReadMemoryByte(cpu, M6502_STACK_ADDRESS + cpu->stackPointer);
 }
 
 static inline uint16_t M6502_PullWord(M6502_t *cpu)
@@ -248,12 +801,20 @@ static inline uint16_t M6502_PullWord(M6502_t *cpu)
 
 static inline void M6502_CarryTest(M6502_t *cpu, const uint16_t value)
 {
+#ifdef M6502_LAZY_FLAGS
+    cpu->carryFlag = (uint8_t)((value >> 8u) != 0u);
+#else
     M6502_SetFlag(cpu, M6502_FLAG_CARRY, !!(value & 0xFF00u));
+#endif
 }
 
 static inline void M6502_ZeroTest(M6502_t *cpu, const uint16_t value)
 {
+#ifdef M6502_LAZY_FLAGS
+    cpu->zeroResult = (uint8_t)(value & 0x00FFu);
+#else
     M6502_SetFlag(cpu, M6502_FLAG_ZERO, !(value & 0x00FFu));
+#endif
 }
 
 static inline void M6502_OverFlowTest(M6502_t *cpu, const uint16_t value, const uint16_t result)
@@ -267,169 +828,221 @@ static inline void M6502_OverFlowTest(M6502_t *cpu, const uint16_t value, const
 
 static inline void M6502_NegativeTest(M6502_t *cpu, const uint16_t value)
 {
+#ifdef M6502_LAZY_FLAGS
+    cpu->negativeResult = (uint8_t)(value & 0x00FFu);
+#else
     M6502_SetFlag(cpu, M6502_FLAG_NEGATIVE, (value & 0x0080u));
+#endif
 }
 
 
-static inline void M6502_Address_Implied(M6502_t *cpu)
+static inline uint16_t M6502_Operand_Byte(M6502_t *cpu)
 {
-    M6502_DummyRead(cpu->programCounter);
+    return (uint16_t)M6502_ReadMemoryByte(cpu, cpu->programCounter++);
 }
 
-static inline void M6502_Address_Accumulator(M6502_t *cpu)
+static inline uint16_t M6502_Operand_Word(M6502_t *cpu)
 {
-    cpu->address    = cpu->accumulator;
-    cpu->target     = cpu->accumulator;
+    const uint16_t operand = M6502_ReadMemoryWord(cpu, cpu->programCounter);
+    cpu->programCounter += 2u;
+
+    return operand;
+}
 
-    M6502_DummyRead(cpu->programCounter);
+static inline uint16_t M6502_Operand_Fetch(M6502_t *cpu, const M6502_AddressMode_t mode)
+{
+    /* On the mode itself rather than M6502_OPERAND_BYTES, so the inliner sees one case per handler. */
+    switch (mode)
+    {
+        case M6502_AddressMode_Immediate:
+        case M6502_AddressMode_Relative:
+        case M6502_AddressMode_ZeroPage:
+        case M6502_AddressMode_ZeroPageX:
+        case M6502_AddressMode_ZeroPageY:
+        case M6502_AddressMode_IndirectX:
+        case M6502_AddressMode_IndirectY:
+            return M6502_Operand_Byte(cpu);
+
+        case M6502_AddressMode_Absolute:
+        case M6502_AddressMode_AbsoluteX:
+        case M6502_AddressMode_AbsoluteY:
+        case M6502_AddressMode_Indirect:
+            return M6502_Operand_Word(cpu);
+
+        default:
+            return 0x0000u;
+    }
 }
 
-static inline void M6502_Address_Immediate(M6502_t *cpu)
+
+static inline void M6502_Address_None(M6502_t *cpu, const uint16_t operand, const M6502_Access_t access)
 {
-    cpu->address    = cpu->programCounter++;
-    cpu->target     = M6502_ExternalReadMemory(cpu->address);
+    /* The opcode sequences its own operand fetches. */
+    (void)cpu;
+    (void)operand;
+    (void)access;
 }
 
-static inline void M6502_Address_Relative(M6502_t *cpu)
+static inline void M6502_Address_Implied(M6502_t *cpu, const uint16_t operand, const M6502_Access_t access)
 {
-    cpu->address = (uint16_t)M6502_ExternalReadMemory(cpu->programCounter++);
+    (void)operand;
+    (void)access;
 
-    if (cpu->address & 0x80u)
-    {
-		cpu->address = cpu->address | 0xFF00u;
-    }
+    M6502_DummyRead(cpu, cpu->programCounter);
 }
 
-static inline void M6502_Address_Absolute(M6502_t *cpu)
+static inline void M6502_Address_Accumulator(M6502_t *cpu, const uint16_t operand, const M6502_Access_t access)
 {
-    cpu->address    = M6502_ReadMemoryWord(cpu->programCounter);
-    cpu->target     = M6502_ReadMemoryByte(cpu->address);
+    (void)operand;
+    (void)access;
 
-    cpu->programCounter += 2u;
+    cpu->address    = cpu->accumulator;
+    cpu->target     = cpu->accumulator;
+
+    M6502_DummyRead(cpu, cpu->programCounter);
 }
 
-static inline void M6502_Address_AbsoluteX(M6502_t *cpu)
+static inline void M6502_Address_Immediate(M6502_t *cpu, const uint16_t operand, const M6502_Access_t access)
 {
-    cpu->address = M6502_ReadMemoryWord(cpu->programCounter);
-    cpu->programCounter += 2u;
+    (void)access;
+
+    cpu->address    = cpu->programCounter - 1u;
+    cpu->target     = operand;
+}
 
-    const uint16_t pageTest = cpu->address & 0xFF00u;
+static inline void M6502_Address_Relative(M6502_t *cpu, const uint16_t operand, const M6502_Access_t access)
+{
+    (void)access;
 
-    cpu->address += (uint16_t)cpu->xRegister;
+    cpu->address = operand;
 
-    if(pageTest != (cpu->address & 0xFF00u))
+    if (cpu->address & 0x80u)
     {
-        uint16_t dummyAddress = pageTest | (cpu->address & 0x00FFu);
-        M6502_DummyRead(dummyAddress);
-
-        cpu->cycles++;
+		cpu->address = cpu->address | 0xFF00u;
     }
-
-    cpu->target = M6502_ReadMemoryByte(cpu->address);
 }
 
-static inline void M6502_Address_AbsoluteY(M6502_t *cpu)
+static inline void M6502_Address_Absolute(M6502_t *cpu, const uint16_t operand, const M6502_Access_t access)
 {
-    cpu->address = M6502_ReadMemoryWord(cpu->programCounter);
-    cpu->programCounter += 2u;
+    cpu->address    = operand;
 
-    const uint16_t pageTest = cpu->address & 0xFF00u;
+    M6502_Util_ReadOperand(cpu, access);
+}
 
-    cpu->address += (uint16_t)cpu->yRegister;
+static inline void M6502_Address_AbsoluteX(M6502_t *cpu, const uint16_t operand, const M6502_Access_t access)
+{
+    cpu->address = operand + (uint16_t)cpu->xRegister;
 
-    if(pageTest != (cpu->address & 0xFF00u))
-    {
-        uint16_t dummyAddress = pageTest | (cpu->address & 0x00FFu);
-        M6502_DummyRead(dummyAddress);
+    M6502_Util_PageCross(cpu, operand, access);
+    M6502_Util_ReadOperand(cpu, access);
+}
 
-        cpu->cycles++;
-    }
+static inline void M6502_Address_AbsoluteY(M6502_t *cpu, const uint16_t operand, const M6502_Access_t access)
+{
+    cpu->address = operand + (uint16_t)cpu->yRegister;
 
-    cpu->target = M6502_ReadMemoryByte(cpu->address);
+    M6502_Util_PageCross(cpu, operand, access);
+    M6502_Util_ReadOperand(cpu, access);
 }
 
-static inline void M6502_Address_ZeroPage(M6502_t *cpu)
+static inline void M6502_Address_ZeroPage(M6502_t *cpu, const uint16_t operand, const M6502_Access_t access)
 {
-    cpu->address    = (uint16_t)M6502_ReadMemoryByte(cpu->programCounter++);
-    cpu->target     = M6502_ReadMemoryByte(cpu->address);
+    cpu->address    = operand;
+
+    M6502_Util_ReadOperand(cpu, access);
 }
 
-static inline void M6502_Address_ZeroPageX(M6502_t *cpu)
+static inline void M6502_Address_ZeroPageX(M6502_t *cpu, const uint16_t operand, const M6502_Access_t access)
 {
-    uint16_t temporary = (uint16_t)M6502_ReadMemoryByte(cpu->programCounter++);
+    uint16_t temporary = operand;
 
-    M6502_DummyRead(temporary);
+    M6502_DummyRead(cpu, temporary);
 
     temporary += (uint16_t)cpu->xRegister;
     temporary &= 0x00FFu;
 
     cpu->address    = temporary;
-    cpu->target     = M6502_ReadMemoryByte(temporary);
+
+    M6502_Util_ReadOperand(cpu, access);
 }
 
-static inline void M6502_Address_ZeroPageY(M6502_t *cpu)
+static inline void M6502_Address_ZeroPageY(M6502_t *cpu, const uint16_t operand, const M6502_Access_t access)
 {
-    uint16_t temporary = (uint16_t)M6502_ReadMemoryByte(cpu->programCounter++);
+    uint16_t temporary = operand;
 
-    M6502_DummyRead(temporary);
+    M6502_DummyRead(cpu, temporary);
 
     temporary += (uint16_t)cpu->yRegister;
     temporary &= 0x00FFu;
 
     cpu->address    = temporary;
-    cpu->target     = M6502_ReadMemoryByte(temporary);
+
+    M6502_Util_ReadOperand(cpu, access);
 }
 
-static inline void M6502_Address_Indirect(M6502_t *cpu)
+static inline void M6502_Address_Indirect(M6502_t *cpu, const uint16_t operand, const M6502_Access_t access)
 {
-    const uint16_t temporary = M6502_ReadMemoryWord(cpu->programCounter);
-    cpu->programCounter += 2u;
+    (void)access;
 
+    const uint16_t temporary = operand;
     const uint16_t temporary2 = (temporary & 0xFF00u) | ((temporary + 1) & 0x00FFu);
 
-    const uint16_t low  = (uint16_t)M6502_ReadMemoryByte(temporary);
-    const uint16_t high = (uint16_t)M6502_ReadMemoryByte(temporary2) << 8u;
-
-    cpu->address = (high | low);
+    cpu->address = M6502_ReadMemoryPair(cpu, temporary, temporary2);
 }
 
-static inline void M6502_Address_IndirectX(M6502_t *cpu)
+static inline void M6502_Address_IndirectX(M6502_t *cpu, const uint16_t operand, const M6502_Access_t access)
 {
-    uint16_t pointer = (uint16_t)M6502_ReadMemoryByte(cpu->programCounter++);
-    M6502_DummyRead(pointer);
+    uint16_t pointer = operand;
+    M6502_DummyRead(cpu, pointer);
 
     pointer += (uint16_t)cpu->xRegister;
     pointer &= 0xFFu;
 
-    uint16_t low    = (uint16_t)M6502_ReadMemoryByte(pointer & 0xFFu);
-	uint16_t high   = (uint16_t)M6502_ReadMemoryByte((pointer + 1u) & 0xFFu);
+    cpu->address    = M6502_ReadMemoryPair(cpu, pointer, (pointer + 1u) & 0xFFu);
 
-	cpu->address    = (uint16_t)((high << 8u) | low);
-	cpu->target     = M6502_ReadMemoryByte(cpu->address);
+    M6502_Util_ReadOperand(cpu, access);
 }
 
-static inline void M6502_Address_IndirectY(M6502_t *cpu)
+static inline void M6502_Address_IndirectY(M6502_t *cpu, const uint16_t operand, const M6502_Access_t access)
 {
-    const uint16_t pointer = (uint16_t)M6502_ReadMemoryByte(cpu->programCounter++);
+    const uint16_t pointer = operand;
 
     const uint16_t pointer2 = (pointer & 0xFF00u) | ((pointer + 1u) & 0x00FFu);
 
-    const uint16_t low  = (uint16_t)M6502_ReadMemoryByte(pointer);
-	const uint16_t high = (uint16_t)M6502_ReadMemoryByte(pointer2) << 8u;
-
-    const uint16_t pointerResult = (high | low);
+    const uint16_t pointerResult = M6502_ReadMemoryPair(cpu, pointer, pointer2);
 
     cpu->address = pointerResult + (uint16_t)cpu->yRegister;
-	
-	if ((pointerResult & 0xFF00u) != (cpu->address & 0xFF00u))
+
+    M6502_Util_PageCross(cpu, pointerResult, access);
+    M6502_Util_ReadOperand(cpu, access);
+}
+
+
+static inline void M6502_Util_ReadOperand(M6502_t *cpu, const M6502_Access_t access)
+{
+    if (access == M6502_Access_Read || access == M6502_Access_Modify)
     {
-        M6502_DummyRead(pointerResult);
-        cpu->cycles++;
+        cpu->target = M6502_ReadMemoryByte(cpu, cpu->address);
     }
-
-    cpu->target = M6502_ReadMemoryByte(cpu->address);
 }
 
+static inline void M6502_Util_PageCross(M6502_t *cpu, const uint16_t base, const M6502_Access_t access)
+{
+    const uint16_t dummyAddress = (base & 0xFF00u) | (cpu->address & 0x00FFu);
+
+    if (access != M6502_Access_Read)
+    {
+        /* Stores and read-modify-write always spend the fix-up cycle. */
+        M6502_DummyRead(cpu, dummyAddress);
+        return;
+    }
+
+    if ((base & 0xFF00u) != (cpu->address & 0xFF00u))
+    {
+        M6502_DummyRead(cpu, dummyAddress);
+        cpu->cycles++;
+    }
+}
 
 static inline void M6502_Util_WriteResult(M6502_t *cpu, const uint16_t result)
 {
@@ -444,36 +1057,93 @@ static inline void M6502_Util_WriteResult(M6502_t *cpu, const uint16_t result)
         return;
     }
 
-    M6502_ExternalWriteMemory(cpu->address, resultToSave);
+#ifdef M6502_PINS
+    if (cpu->pinTicking != 0u)
+    {
+        cpu->pinResult  = resultToSave;
+        cpu->pinTicking = 2u;
+        return;
+    }
+#endif
+
+    M6502_WriteMemoryByte(cpu, cpu->address, resultToSave);
 }
 
 static inline void M6502_Util_Branch(M6502_t *cpu)
 {
     uint16_t address = cpu->programCounter + (int8_t)cpu->address;
 
-    M6502_DummyRead(cpu->programCounter);
+    M6502_DummyRead(cpu, cpu->programCounter);
     cpu->cycles++;
 
     if((address & 0xFF00u) != (cpu->programCounter & 0xFF00u))
     {
-        M6502_DummyRead(address);
+        M6502_DummyRead(cpu, address);
         cpu->cycles++;
     }
 
+#ifdef M6502_IDLE_SKIP
+    if (address < cpu->programCounter)
+    {
+        M6502_Idle_Arrive(cpu, cpu->programCounter - 2u, address);
+    }
+#endif
+
     cpu->programCounter = address;
 }
 
+/* Sets attention bits: posted for the CPU thread to take under M6502_ATOMIC. */
+static inline void M6502_Raise(M6502_t *cpu, const uint8_t bits)
+{
+#ifdef M6502_ATOMIC
+    __atomic_fetch_or(&cpu->requests, bits, __ATOMIC_RELEASE);
+#else
+    cpu->pendingInterrupts |= bits;
+#endif
+}
+
+static inline uint32_t M6502_Lines_IRQ(M6502_t *cpu)
+{
+#ifdef M6502_ATOMIC
+    return __atomic_load_n(&cpu->irqLines, __ATOMIC_RELAXED);
+#else
+    return cpu->irqLines;
+#endif
+}
+
+#ifdef M6502_ATOMIC
+/* Only the CPU thread writes pendingInterrupts: everything posted since the last take is merged here. */
+static inline void M6502_Requests_Take(M6502_t *cpu)
+{
+    const uint8_t requests = __atomic_exchange_n(&cpu->requests, 0u, __ATOMIC_ACQUIRE);
+
+    cpu->pendingInterrupts |= requests & (M6502_INTERRUPT_NMI | M6502_INTERRUPT_IRQ | M6502_ATTENTION_STOP);
+
+    /* A release only counts if no source asserted the line again since. */
+    if (((requests & M6502_REQUEST_RELEASE) != 0u) && (M6502_Lines_IRQ(cpu) == 0u))
+    {
+        cpu->pendingInterrupts &= ~M6502_INTERRUPT_IRQ;
+    }
+}
+
+/* A relaxed load is a plain load on the usual targets, so it costs as much as the pending test. */
+#define M6502_ATTENTION(cpu) \
+    (((cpu)->pendingInterrupts | __atomic_load_n(&(cpu)->requests, __ATOMIC_RELAXED)) != 0u)
+#else
+#define M6502_ATTENTION(cpu) ((cpu)->pendingInterrupts != 0u)
+#endif
+
 static inline void M6502_Util_Interrupt(M6502_t *cpu)
 {
-    M6502_DummyRead(cpu->programCounter);
+    M6502_DummyRead(cpu, cpu->programCounter);
 
     M6502_PushWord(cpu, cpu->programCounter);
-    M6502_PushByte(cpu, (cpu->statusRegister & ~M6502_FLAG_BREAK));
+    M6502_PushByte(cpu, (M6502_PackStatus(cpu) & ~M6502_FLAG_BREAK));
     M6502_SetFlag(cpu, M6502_FLAG_INTERRUPT, 1u);
 
     if ((cpu->pendingInterrupts & M6502_INTERRUPT_NMI) != 0u)
     {
-        cpu->programCounter = M6502_ReadMemoryWord(M6502_NMIVECTOR_ADDRESS);
+        cpu->programCounter = M6502_ReadMemoryWord(cpu, M6502_NMIVECTOR_ADDRESS);
 
         cpu->pendingInterrupts &= ~M6502_INTERRUPT_NMI;
         cpu->interruptFlags |= M6502_INTERRUPT_NMI;
@@ -482,759 +1152,5153 @@ static inline void M6502_Util_Interrupt(M6502_t *cpu)
     }
     else if ((cpu->pendingInterrupts & M6502_INTERRUPT_IRQ) != 0u)
     {
-        cpu->programCounter = M6502_ReadMemoryWord(M6502_IRQVECTOR_ADDRESS);
+        cpu->programCounter = M6502_ReadMemoryWord(cpu, M6502_IRQVECTOR_ADDRESS);
 
-        cpu->pendingInterrupts &= ~M6502_INTERRUPT_IRQ;
         cpu->interruptFlags |= M6502_INTERRUPT_IRQ;
 
+        /* A level IRQ stays pending until every source lets go of the line. */
+        if (M6502_Lines_IRQ(cpu) == 0u)
+        {
+            cpu->pendingInterrupts &= ~M6502_INTERRUPT_IRQ;
+        }
+
         cpu->cycles = 7u;
     }
+
+#ifdef M6502_IDLE_SKIP
+    /* The handler may change what the interrupted loop is waiting for. */
+    cpu->idleValid = 0u;
+#endif
 }
 
 
-void M6502_Init(M6502_t *cpu)
-{
-    cpu->programCounter = 0x0000u;
-    cpu->xRegister      = 0x00u;
-    cpu->yRegister      = 0x00u;
-    cpu->accumulator    = 0x00u;
-    cpu->stackPointer   = 0x00u;
-    cpu->statusRegister = 0x00u;
-    cpu->cycles         = 0u;
-    cpu->opcode         = 0x00u;
-    cpu->address        = 0x0000u;
-    cpu->target         = 0x0000u;
+#define M6502_OPCODE_BODY(opcode, mnemonic, mode, cycles, access)     \
+    static inline __attribute__((always_inline)) void M6502_Body_##opcode(M6502_t *cpu, const uint16_t operand) \
+    {                                                                   \
+        M6502_Address_##mode(cpu, operand, M6502_Access_##access);      \
+        M6502_Opcode_##mnemonic(cpu);                                   \
+    }
 
-    M6502_Reset(cpu);
-}
+#define M6502_OPCODE_HANDLER(opcode, mnemonic, mode, cycles, access)  \
+    static void M6502_Handler_##opcode(M6502_t *cpu)                    \
+    {                                                                   \
+        M6502_Body_##opcode(cpu, M6502_Operand_Fetch(cpu, M6502_AddressMode_##mode)); \
+    }
 
-void M6502_Reset(M6502_t *cpu)
-{
-    cpu->programCounter     = M6502_ReadMemoryWord(M6502_RESETVECTOR_ADDRESS);
-    cpu->stackPointer       = M6502_STACK_START_ADDRESS;
-    cpu->interruptFlags     = 0x00u;
-    cpu->pendingInterrupts  = 0x00u;
-    cpu->jammed             = 0x00u;
-    
-    M6502_SetFlag(cpu, M6502_FLAG_INTERRUPT, 1u);
-    M6502_SetFlag(cpu, M6502_FLAG_UNUSED, 1u);
+#define M6502_OPCODE_HANDLER_ENTRY(opcode, mnemonic, mode, cycles, access) \
+    [opcode] = M6502_Handler_##opcode,
 
-    cpu->cycles = 8u;
-}
+typedef void (*M6502_Handler_t)(M6502_t *cpu);
 
-void M6502_IRQ(M6502_t *cpu)
-{
-    cpu->pendingInterrupts |= M6502_INTERRUPT_IRQ;
-}
+M6502_OPCODE_TABLE(M6502_OPCODE_BODY)
+M6502_OPCODE_TABLE(M6502_OPCODE_HANDLER)
 
-void M6502_NMI(M6502_t *cpu)
-{
-    cpu->pendingInterrupts |= M6502_INTERRUPT_NMI;
-}
+static const M6502_Handler_t M6502_OPCODE_HANDLERS[0x100] = {
+    M6502_OPCODE_TABLE(M6502_OPCODE_HANDLER_ENTRY)
+};
 
-void M6502_Step(M6502_t *cpu)
+#ifdef M6502_PINS
+#define M6502_OPCODE_OPERATION_ENTRY(opcode, mnemonic, mode, cycles, access) \
+    [opcode] = M6502_Opcode_##mnemonic,
+
+/* Opcode bodies alone, for M6502_Tick to run once the addressing mode is done. */
+static const M6502_Handler_t M6502_OPCODE_OPERATIONS[0x100] = {
+    M6502_OPCODE_TABLE(M6502_OPCODE_OPERATION_ENTRY)
+};
+#endif
+
+#ifdef M6502_COMPUTED_GOTO
+/* Each opcode body ends in its own copy of the fetch and dispatch tail. */
+#define M6502_DISPATCH()                                                    \
+    do                                                                      \
+    {                                                                       \
+        elapsed += (uint32_t)cpu->cycles;                                   \
+        cpu->cycles = 0u;                                                   \
+                                                                            \
+        if ((elapsed >= cycles) || M6502_ATTENTION(cpu)                     \
+        || M6502_TRAPPED(cpu, cpu->programCounter))                         \
+        {                                                                   \
+            goto M6502_Label_Slow;                                          \
+        }                                                                   \
+                                                                            \
+        M6502_SetFlag(cpu, M6502_FLAG_UNUSED, 1u);                          \
+                                                                            \
+        cpu->opcode = M6502_ReadMemoryByte(cpu, cpu->programCounter++);      \
+        cpu->cycles = M6502_OPCODE_CYCLES[cpu->opcode];                     \
+                                                                            \
+        goto *labels[cpu->opcode];                                          \
+    } while (0)
+
+/*
+ * The labels call the handlers rather than spell the bodies out again: 256 bodies in one function
+ * run into GCC's large-function-growth limit, which left about half of them calling
+ * M6502_Operand_Fetch and the M6502_Address_* functions out of line.
+ */
+#define M6502_OPCODE_LABEL(opcode, mnemonic, mode, cycles, access)     \
+    M6502_Label_##opcode:                                               \
+        M6502_Handler_##opcode(cpu);                                    \
+        M6502_DISPATCH();
+
+#define M6502_OPCODE_LABEL_ENTRY(opcode, mnemonic, mode, cycles, access) \
+    [opcode] = &&M6502_Label_##opcode,
+#endif
+
+
+#ifdef M6502_STALL
+/* Charges as much of the stall as fits in the slice, the CPU does nothing meanwhile. */
+static inline uint32_t M6502_Stall_Skip(M6502_t *cpu, uint32_t elapsed, const uint32_t cycles)
 {
-    if(cpu->cycles > 0u)
+    if (cpu->stallAlign != 0u)
     {
-        cpu->cycles--;
-        return;
+        /* The transfer starts only on an even cycle. */
+        cpu->stallCycles += (uint32_t)((cpu->totalCycles + elapsed) & 1u);
+        cpu->stallAlign = 0u;
     }
 
-    if (cpu->jammed == 0xFFu)
+    const uint32_t budget   = (elapsed < cycles) ? (cycles - elapsed) : 0u;
+    const uint32_t stall    = (cpu->stallCycles < budget) ? cpu->stallCycles : budget;
+
+    cpu->stallCycles -= stall;
+
+    if (cpu->stallCycles == 0u)
     {
-        M6502_DummyRead(M6502_JAMMED_ADDRESS);
-        return;
+        cpu->pendingInterrupts &= ~M6502_ATTENTION_STALL;
     }
 
-    if ((cpu->pendingInterrupts & M6502_INTERRUPT_NMI) != 0u)
+    return elapsed + stall;
+}
+#endif
+
+#ifdef M6502_HLE
+static inline uint8_t M6502_Trap_At(const M6502_t *cpu, const uint16_t address)
+{
+    return (uint8_t)((cpu->trapMap[address >> 3u] >> (address & 7u)) & 1u);
+}
+
+static void M6502_Trap_Call(M6502_t *cpu)
+{
+    for (uint8_t slot = 0u; slot < M6502_TRAP_COUNT; ++slot)
     {
-        if ((cpu->interruptFlags & M6502_INTERRUPT_NMI) == 0u)
+        const M6502_Trap_t *trap = &cpu->traps[slot];
+
+        if ((trap->handler != NULL) && (trap->address == cpu->programCounter))
         {
-            M6502_Util_Interrupt(cpu);
+            const uint32_t cycles = trap->handler(cpu, trap->context);
+
+            /* Back to the caller like RTS, the routine's cycles run as a stall. */
+            cpu->programCounter = M6502_PullWord(cpu) + 1u;
+            cpu->cycles = 0u;
+            cpu->stallCycles += cycles;
+            cpu->pendingInterrupts |= M6502_ATTENTION_STALL;
             return;
         }
     }
-    else if((cpu->pendingInterrupts & M6502_INTERRUPT_IRQ) != 0u)
+}
+
+#define M6502_TRAPPED(cpu, address) M6502_Trap_At(cpu, address)
+#else
+#define M6502_TRAPPED(cpu, address) 0
+#endif
+
+#ifdef M6502_IDLE_SKIP
+static const uint16_t M6502_IDLE_LOOP_BYTES = 16u;
+
+/* Reads a byte of the loop without touching the bus, only from an idle-safe page. */
+static inline uint8_t M6502_Idle_Peek(M6502_t *cpu, const uint16_t address, uint8_t *value)
+{
+    if (cpu->idleSafe[address >> 8u] == 0u)
     {
-        if ((cpu->interruptFlags == 0u)
-        && (M6502_GetFlag(cpu, M6502_FLAG_INTERRUPT) == 0u))
-        {
-            M6502_Util_Interrupt(cpu);
-            return;
-        }
+        return 0u;
     }
 
-    M6502_SetFlag(cpu, M6502_FLAG_UNUSED, 1u);
+    return M6502_PeekMemoryByte(cpu, address, value);
+}
 
-    cpu->opcode = M6502_ExternalReadMemory(cpu->programCounter++);
-    cpu->cycles = M6502_OPCODE_CYCLES[cpu->opcode];
+/* Cycles of one pass through target..jump, or 0 if the loop may have effects. */
+static uint16_t M6502_Idle_Scan(M6502_t *cpu, const uint16_t target, const uint16_t jump)
+{
+    uint16_t address    = target;
+    uint16_t loopCycles = 0u;
 
-    switch (cpu->opcode)
+    while (address != jump)
     {
-        case 0x00u: M6502_Opcode_BRK(cpu);   return;
-        case 0x20u: M6502_Opcode_JSR(cpu);   return;
-        case 0x40u: M6502_Opcode_RTI(cpu);   return;
-        case 0x60u: M6502_Opcode_RTS(cpu);   return;
-
-        case 0x08u:
-        {
-            M6502_Address_Implied(cpu);
-            M6502_Opcode_PHP(cpu);
-            return;
-        }
-        case 0x18u:
-        {
-            M6502_Address_Implied(cpu);
-            M6502_Opcode_CLC(cpu);
-            return;
-        }
-        case 0x28u:
-        {
-            M6502_Address_Implied(cpu);
-            M6502_Opcode_PLP(cpu);
-            return;
-        }
-        case 0x38u:
-        {
-            M6502_Address_Implied(cpu);
-            M6502_Opcode_SEC(cpu);
-            return;
-        }
-        case 0x48u:
-        {
-            M6502_Address_Implied(cpu);
-            M6502_Opcode_PHA(cpu);
-            return;
-        }
-        case 0x58u:
-        {
-            M6502_Address_Implied(cpu);
-            M6502_Opcode_CLI(cpu);
-            return;
-        }
-        case 0x68u:
-        {
-            M6502_Address_Implied(cpu);
-            M6502_Opcode_PLA(cpu);
-            return;
-        }
-        case 0x78u:
+        if ((uint16_t)(jump - address) > M6502_IDLE_LOOP_BYTES)
         {
-            M6502_Address_Implied(cpu);
-            M6502_Opcode_SEI(cpu);
-            return;
+            return 0u;
         }
-        case 0x88u:
+
+        uint8_t opcode;
+
+        if (!M6502_Idle_Peek(cpu, address, &opcode))
         {
-            M6502_Address_Implied(cpu);
-            M6502_Opcode_DEY(cpu);
-            return;
+            return 0u;
         }
-        case 0x8Au:
+
+        const M6502_OpcodeInfo_t *info = &M6502_OPCODE_INFO[opcode];
+
+        switch (info->addressMode)
         {
-            M6502_Address_Implied(cpu);
-            M6502_Opcode_TXA(cpu);
-            return;
+            case M6502_AddressMode_Implied:
+                if ((info->instruction == M6502_Instruction_PHA) || (info->instruction == M6502_Instruction_PHP)
+                || (info->instruction == M6502_Instruction_PLA) || (info->instruction == M6502_Instruction_PLP)
+                || (info->instruction == M6502_Instruction_JAM))
+                {
+                    return 0u;
+                }
+                break;
+
+            case M6502_AddressMode_Accumulator:
+            case M6502_AddressMode_Immediate:
+                break;
+
+            case M6502_AddressMode_ZeroPage:
+            case M6502_AddressMode_Absolute:
+            {
+                uint8_t low     = 0x00u;
+                uint8_t high    = 0x00u;
+
+                if (!M6502_Idle_Peek(cpu, address + 1u, &low)
+                || ((info->addressMode == M6502_AddressMode_Absolute) && !M6502_Idle_Peek(cpu, address + 2u, &high)))
+                {
+                    return 0u;
+                }
+
+                const uint16_t operand = (uint16_t)(low | ((uint16_t)high << 8u));
+
+                if ((info->access != M6502_Access_Read) || (cpu->idleSafe[operand >> 8u] == 0u))
+                {
+                    return 0u;
+                }
+                break;
+            }
+
+            default:
+                return 0u;
         }
-        case 0x98u:
+
+        loopCycles += info->cycles;
+        address += 1u + M6502_OPERAND_BYTES[info->addressMode];
+    }
+
+    uint8_t opcode;
+
+    if (!M6502_Idle_Peek(cpu, jump, &opcode))
+    {
+        return 0u;
+    }
+
+    if (opcode == 0x4Cu)
+    {
+        return loopCycles + M6502_OPCODE_CYCLES[opcode];
+    }
+
+    if (M6502_OPCODE_INFO[opcode].addressMode == M6502_AddressMode_Relative)
+    {
+        /* Taken, plus one more when the target is on another page. */
+        const uint16_t next = jump + 2u;
+
+        return loopCycles + M6502_OPCODE_CYCLES[opcode] + 1u + (((next ^ target) & 0xFF00u) ? 1u : 0u);
+    }
+
+    return 0u;
+}
+
+static void M6502_Idle_Arrive(M6502_t *cpu, const uint16_t jump, const uint16_t target)
+{
+    if ((uint16_t)(jump - target) > M6502_IDLE_LOOP_BYTES)
+    {
+        return;
+    }
+
+    const uint8_t state[5] = {
+        cpu->accumulator, cpu->xRegister, cpu->yRegister, cpu->stackPointer, M6502_PackStatus(cpu)
+    };
+
+    if ((cpu->idleValid != 0u) && (cpu->idleTarget == target) && (cpu->idleJump == jump)
+    && (memcmp(cpu->idleState, state, sizeof(state)) == 0))
+    {
+        /* A whole pass changed nothing, so every further pass is the same. */
+        cpu->idleCycles = M6502_Idle_Scan(cpu, target, jump);
+
+        if (cpu->idleCycles != 0u)
         {
-            M6502_Address_Implied(cpu);
-            M6502_Opcode_TYA(cpu);
-            return;
+            cpu->pendingInterrupts |= M6502_ATTENTION_IDLE;
         }
-        case 0x9Au:
+        return;
+    }
+
+    cpu->idleValid  = 1u;
+    cpu->idleTarget = target;
+    cpu->idleJump   = jump;
+    memcpy(cpu->idleState, state, sizeof(state));
+}
+
+static inline uint32_t M6502_Idle_Skip(M6502_t *cpu, uint32_t elapsed, const uint32_t cycles)
+{
+    const uint32_t loopCycles = cpu->idleCycles;
+
+    cpu->idleCycles = 0u;
+    cpu->pendingInterrupts &= ~M6502_ATTENTION_IDLE;
+
+    /* Whole passes only: the last one runs for real and ends the slice as usual. */
+    if ((elapsed < cycles) && (cpu->pendingInterrupts == 0u))
+    {
+        elapsed += ((cycles - elapsed - 1u) / loopCycles) * loopCycles;
+    }
+
+    return elapsed;
+}
+#endif
+
+#ifdef M6502_BLOCK_CACHE
+#define M6502_CACHED_HANDLER_ENTRY(opcode, mnemonic, mode, cycles, access) \
+    [opcode] = M6502_Body_##opcode,
+
+typedef void (*M6502_CachedHandler_t)(M6502_t *cpu, uint16_t operand);
+
+static const M6502_CachedHandler_t M6502_CACHED_HANDLERS[0x100] = {
+    M6502_OPCODE_TABLE(M6502_CACHED_HANDLER_ENTRY)
+};
+
+#ifdef M6502_FUSION
+/* Pairs that dominate loop code: compare + branch, count + branch, indexed copy. */
+#define M6502_FUSION_TABLE(FUSE)                                        \
+    FUSE(0xC9u, 0xD0u) FUSE(0xC9u, 0xF0u)                               \
+    FUSE(0xC5u, 0xD0u) FUSE(0xC5u, 0xF0u)                               \
+    FUSE(0xCDu, 0xD0u) FUSE(0xCDu, 0xF0u)                               \
+    FUSE(0xE0u, 0xD0u) FUSE(0xE0u, 0xF0u)                               \
+    FUSE(0xE4u, 0xD0u) FUSE(0xE4u, 0xF0u)                               \
+    FUSE(0xECu, 0xD0u) FUSE(0xECu, 0xF0u)                               \
+    FUSE(0xC0u, 0xD0u) FUSE(0xC0u, 0xF0u)                               \
+    FUSE(0xC4u, 0xD0u) FUSE(0xC4u, 0xF0u)                               \
+    FUSE(0xCCu, 0xD0u) FUSE(0xCCu, 0xF0u)                               \
+    FUSE(0xCAu, 0xD0u) FUSE(0xCAu, 0xF0u)                               \
+    FUSE(0x88u, 0xD0u) FUSE(0x88u, 0xF0u)                               \
+    FUSE(0xB5u, 0x95u) FUSE(0xBDu, 0x9Du)                               \
+    FUSE(0xB9u, 0x99u) FUSE(0xB1u, 0x91u)
+
+/* The first instruction only reads, so it can not invalidate the block or jam. */
+#define M6502_FUSED_HANDLER(first, second)                              \
+    static uint8_t M6502_FusedHandler_##first##_##second(M6502_t *cpu, const M6502_MicroOp_t *op) \
+    {                                                                   \
+        M6502_Body_##first(cpu, op[0].operand);                         \
+                                                                        \
+        if (M6502_ATTENTION(cpu))                                       \
+        {                                                               \
+            return 0u;                                                  \
+        }                                                               \
+                                                                        \
+        cpu->opcode         = op[1].opcode;                             \
+        cpu->cycles         += op[1].cycles;                            \
+        cpu->programCounter = op[1].next;                               \
+                                                                        \
+        M6502_Body_##second(cpu, op[1].operand);                        \
+        return 1u;                                                      \
+    }
+
+#define M6502_FUSED_HANDLER_ENTRY(first, second) \
+    M6502_FusedHandler_##first##_##second,
+
+#define M6502_FUSION_PAIR_ENTRY(first, second) \
+    { first, second },
+
+typedef uint8_t (*M6502_FusedHandler_t)(M6502_t *cpu, const M6502_MicroOp_t *op);
+
+M6502_FUSION_TABLE(M6502_FUSED_HANDLER)
+
+/* Slot 0 means "not fused". */
+static const M6502_FusedHandler_t M6502_FUSED_HANDLERS[] = {
+    NULL,
+    M6502_FUSION_TABLE(M6502_FUSED_HANDLER_ENTRY)
+};
+
+static const uint8_t M6502_FUSION_PAIRS[][2] = {
+    { 0x00u, 0x00u },
+    M6502_FUSION_TABLE(M6502_FUSION_PAIR_ENTRY)
+};
+
+static uint8_t M6502_Fusion_Find(const uint8_t first, const uint8_t second)
+{
+    const uint8_t count = (uint8_t)(sizeof(M6502_FUSION_PAIRS) / sizeof(M6502_FUSION_PAIRS[0]));
+
+    for (uint8_t fusion = 1u; fusion < count; ++fusion)
+    {
+        if ((M6502_FUSION_PAIRS[fusion][0] == first) && (M6502_FUSION_PAIRS[fusion][1] == second))
         {
-            M6502_Address_Implied(cpu);
-            M6502_Opcode_TXS(cpu);
-            return;
+            return fusion;
         }
-        case 0xA8u:
+    }
+
+    return 0u;
+}
+#endif
+
+static inline void M6502_BlockCache_InvalidatePage(M6502_BlockCache_t *cache, const uint8_t page)
+{
+    cache->pageGeneration[page]++;
+    cache->codePages[page] = 0u;
+    cache->invalidations++;
+}
+
+/*
+ * Non-zero when the instruction may go through the bus, write memory or unmask an
+ * interrupt, so a callback, an invalidation or a pending IRQ can follow it.
+ */
+static inline uint8_t M6502_BlockCache_Reaches(const uint8_t opcode)
+{
+    const M6502_OpcodeInfo_t *info = &M6502_OPCODE_INFO[opcode];
+
+    switch (info->instruction)
+    {
+        case M6502_Instruction_PHA:
+        case M6502_Instruction_PHP:
+        case M6502_Instruction_PLA:
+        case M6502_Instruction_PLP:
+        case M6502_Instruction_CLI:
+        case M6502_Instruction_SEI:
+        case M6502_Instruction_JAM:         return 1u;
+        default:                            break;
+    }
+
+    switch (info->addressMode)
+    {
+        case M6502_AddressMode_Implied:
+        case M6502_AddressMode_Accumulator:
+        case M6502_AddressMode_Immediate:
+        case M6502_AddressMode_Relative:    return 0u;
+        default:                            return 1u;
+    }
+}
+
+/* Cycles an instruction can add to its base count: a taken branch, a page crossing. */
+static inline uint8_t M6502_BlockCache_Extra(const uint8_t opcode)
+{
+    const M6502_OpcodeInfo_t *info = &M6502_OPCODE_INFO[opcode];
+
+    switch (info->addressMode)
+    {
+        case M6502_AddressMode_Relative:    return 2u;
+        case M6502_AddressMode_AbsoluteX:
+        case M6502_AddressMode_AbsoluteY:
+        case M6502_AddressMode_IndirectY:   return 1u;
+        default:                            return 0u;
+    }
+}
+
+static inline uint8_t M6502_BlockCache_EndsBlock(const uint8_t opcode)
+{
+    switch (M6502_OPCODE_INFO[opcode].addressMode)
+    {
+        case M6502_AddressMode_None:
+        case M6502_AddressMode_Relative:
+        case M6502_AddressMode_Indirect:    return 1u;
+        default:                            break;
+    }
+
+    return (opcode == 0x4Cu) ? 1u : 0u;
+}
+
+static M6502_Block_t *M6502_BlockCache_Translate(M6502_t *cpu, const uint16_t start)
+{
+    M6502_BlockCache_t *cache = cpu->blockCache;
+    uint8_t bytes[3];
+
+    if (!M6502_PeekMemoryByte(cpu, start, &bytes[0]))
+    {
+        /* The CPU fetches this instruction itself, through the bus. */
+        return NULL;
+    }
+
+    if (cache->used >= M6502_BLOCK_CACHE_SIZE)
+    {
+        /* Recycle the whole pool, stale lookups fail the start check. */
+        cache->used = 0u;
+    }
+
+    const uint16_t index = cache->used++;
+    M6502_Block_t *block = &cache->blocks[index];
+
+    uint16_t address = start;
+
+    block->start    = start;
+    block->length   = 0u;
+    block->cycles   = 0u;
+#ifdef M6502_JIT
+    block->hits     = 0u;
+    block->native   = NULL;
+#endif
+
+    do
+    {
+        const uint8_t opcode = bytes[0];
+        const uint8_t length = M6502_OPERAND_BYTES[M6502_OPCODE_INFO[opcode].addressMode];
+
+        /* An instruction running into a page behind the bus ends the block before it. */
+        if (((length >= 1u) && !M6502_PeekMemoryByte(cpu, address + 1u, &bytes[1]))
+        || ((length == 2u) && !M6502_PeekMemoryByte(cpu, address + 2u, &bytes[2])))
         {
-            M6502_Address_Implied(cpu);
-            M6502_Opcode_TAY(cpu);
-            return;
+            break;
         }
-        case 0xAAu:
+
+        M6502_MicroOp_t *op = &block->ops[block->length++];
+
+        switch (length)
         {
-            M6502_Address_Implied(cpu);
-            M6502_Opcode_TAX(cpu);
-            return;
+            case 1u:    op->operand = bytes[1];                                         break;
+            case 2u:    op->operand = (uint16_t)(bytes[1] | ((uint16_t)bytes[2] << 8u)); break;
+            default:    op->operand = 0x0000u;                                          break;
         }
-        case 0xB8u:
+
+        address += 1u + length;
+
+        op->handler = M6502_CACHED_HANDLERS[opcode];
+        op->next    = address;
+        op->opcode  = opcode;
+        op->cycles  = M6502_OPCODE_CYCLES[opcode];
+        op->check   = M6502_BlockCache_Reaches(opcode);
+
+        block->cycles += op->cycles + M6502_BlockCache_Extra(opcode);
+#ifdef M6502_FUSION
+        op->fusion  = 0u;
+
+        if (block->length > 1u)
         {
-            M6502_Address_Implied(cpu);
-            M6502_Opcode_CLV(cpu);
-            return;
+            op[-1].fusion = M6502_Fusion_Find(op[-1].opcode, opcode);
         }
-        case 0xBAu:
+#endif
+
+        if (M6502_BlockCache_EndsBlock(opcode))
         {
-            M6502_Address_Implied(cpu);
-            M6502_Opcode_TSX(cpu);
-            return;
+            break;
         }
-        case 0xC8u:
+    /* A trapped address always starts a block, where the run loop checks for it. */
+    } while ((block->length < M6502_BLOCK_LENGTH) && !M6502_TRAPPED(cpu, address)
+        && M6502_PeekMemoryByte(cpu, address, &bytes[0]));
+
+    if (block->length == 0u)
+    {
+        /* Not even the first instruction could be read ahead. */
+        cache->used--;
+        return NULL;
+    }
+
+    block->firstPage        = (uint8_t)(start >> 8u);
+    block->lastPage         = (uint8_t)((uint16_t)(address - 1u) >> 8u);
+    block->firstGeneration  = cache->pageGeneration[block->firstPage];
+    block->lastGeneration   = cache->pageGeneration[block->lastPage];
+
+    cache->codePages[block->firstPage]  = 1u;
+    cache->codePages[block->lastPage]   = 1u;
+
+    cache->lookup[start] = index + 1u;
+
+    return block;
+}
+
+static inline M6502_Block_t *M6502_BlockCache_Lookup(M6502_t *cpu, const uint16_t address)
+{
+    M6502_BlockCache_t *cache = cpu->blockCache;
+    uint8_t opcode;
+
+    /* Code behind the bus is never cached, so builds without readable memory skip it all. */
+    if (!M6502_PeekMemoryByte(cpu, address, &opcode))
+    {
+        return NULL;
+    }
+
+    const uint16_t index = cache->lookup[address];
+
+    if (index != 0u)
+    {
+        M6502_Block_t *block = &cache->blocks[index - 1u];
+
+        if ((block->start == address)
+        && (block->firstGeneration == cache->pageGeneration[block->firstPage])
+        && (block->lastGeneration == cache->pageGeneration[block->lastPage]))
         {
-            M6502_Address_Implied(cpu);
-            M6502_Opcode_INY(cpu);
-            return;
+            return block;
         }
-        case 0xCAu:
+    }
+
+    return M6502_BlockCache_Translate(cpu, address);
+}
+
+static uint32_t M6502_BlockCache_Run(M6502_t *cpu, uint32_t elapsed, const uint32_t cycles)
+{
+    const M6502_BlockCache_t *cache = cpu->blockCache;
+
+    while (elapsed < cycles)
+    {
+        if (M6502_ATTENTION(cpu))
         {
-            M6502_Address_Implied(cpu);
-            M6502_Opcode_DEX(cpu);
-            return;
+#ifdef M6502_ATOMIC
+            M6502_Requests_Take(cpu);
+#endif
+
+            if ((cpu->pendingInterrupts & M6502_ATTENTION_STOP) != 0u)
+            {
+                return elapsed;
+            }
+
+            if (cpu->jammed == 0xFFu)
+            {
+                M6502_DummyRead(cpu, M6502_JAMMED_ADDRESS);
+                return cycles;
+            }
+
+#ifdef M6502_IDLE_SKIP
+            if ((cpu->pendingInterrupts & M6502_ATTENTION_IDLE) != 0u)
+            {
+                elapsed = M6502_Idle_Skip(cpu, elapsed, cycles);
+                continue;
+            }
+#endif
+
+#ifdef M6502_STALL
+            if ((cpu->pendingInterrupts & M6502_ATTENTION_STALL) != 0u)
+            {
+                elapsed = M6502_Stall_Skip(cpu, elapsed, cycles);
+                continue;
+            }
+#endif
+
+            M6502_Execute(cpu);
+
+            elapsed += (uint32_t)cpu->cycles;
+            cpu->cycles = 0u;
+            continue;
         }
-        case 0xD8u:
+
+#ifdef M6502_HLE
+        if (M6502_Trap_At(cpu, cpu->programCounter))
         {
-            M6502_Address_Implied(cpu);
-            M6502_Opcode_CLD(cpu);
-            return;
+            M6502_Trap_Call(cpu);
+            continue;
         }
-        case 0xE8u:
+#endif
+
+        M6502_Block_t *block = M6502_BlockCache_Lookup(cpu, cpu->programCounter);
+
+        if (block == NULL)
         {
-            M6502_Address_Implied(cpu);
-            M6502_Opcode_INX(cpu);
-            return;
+            M6502_Execute(cpu);
+
+            elapsed += (uint32_t)cpu->cycles;
+            cpu->cycles = 0u;
+            continue;
         }
-        case 0xF8u:
+
+        const uint32_t invalidations = cache->invalidations;
+
+#ifdef M6502_JIT
+        if ((block->native == NULL) && (cache->codeFailed == 0u) && (++block->hits >= M6502_JIT_THRESHOLD))
         {
-            M6502_Address_Implied(cpu);
-            M6502_Opcode_SED(cpu);
-            return;
+#ifdef M6502_IDLE_SKIP
+            /* Native code never reaches M6502_Idle_Arrive, so idle loops stay interpreted. */
+            if ((block->start == cpu->idleTarget)
+            && (M6502_Idle_Scan(cpu, cpu->idleTarget, cpu->idleJump) != 0u))
+            {
+                block->hits = 0u;
+            }
+            else
+#endif
+            M6502_Jit_Compile(cpu, block);
         }
 
-        case 0xEAu:
+        if (block->native != NULL)
         {
-            M6502_Address_Implied(cpu);
-            M6502_Opcode_NOP(cpu);
-            return;
+            const uint32_t budget = cycles - elapsed;
+
+            elapsed += block->native(cpu, (budget > (uint32_t)INT32_MAX) ? (uint32_t)INT32_MAX : budget);
+            continue;
         }
+#endif
+
+        M6502_SetFlag(cpu, M6502_FLAG_UNUSED, 1u);
 
-        case 0x1Au:
+        /* The whole block fits in the slice, so only ops that reach memory need a check after them. */
+        if ((uint32_t)(cycles - elapsed) > (uint32_t)block->cycles)
         {
-            M6502_Address_Implied(cpu);
-            M6502_Opcode_NOP(cpu);
-            return;
+            for (uint8_t index = 0u; index < block->length; ++index)
+            {
+                const M6502_MicroOp_t *op = &block->ops[index];
+
+                cpu->opcode         = op->opcode;
+                cpu->cycles         = op->cycles;
+                cpu->programCounter = op->next;
+
+#ifdef M6502_FUSION
+                if (op->fusion != 0u)
+                {
+                    index += M6502_FUSED_HANDLERS[op->fusion](cpu, op);
+                    op = &block->ops[index];
+                }
+                else
+#endif
+                op->handler(cpu, op->operand);
+
+                elapsed += (uint32_t)cpu->cycles;
+
+                if (op->check && (M6502_ATTENTION(cpu) || (cache->invalidations != invalidations)))
+                {
+                    break;
+                }
+            }
+
+            cpu->cycles = 0u;
+            continue;
         }
-        case 0x3Au:
+
+        for (uint8_t index = 0u; index < block->length; ++index)
         {
-            M6502_Address_Implied(cpu);
-            M6502_Opcode_NOP(cpu);
-            return;
-        }
-        case 0x5Au:
+            const M6502_MicroOp_t *op = &block->ops[index];
+
+            cpu->opcode         = op->opcode;
+            cpu->cycles         = op->cycles;
+            cpu->programCounter = op->next;
+
+#ifdef M6502_FUSION
+            /* One spare cycle covers a page crossing in the first half, so the slice never ends inside a pair. */
+            if ((op->fusion != 0u) && ((uint32_t)(cycles - elapsed) > (uint32_t)op->cycles + 1u))
+            {
+                index += M6502_FUSED_HANDLERS[op->fusion](cpu, op);
+            }
+            else
+#endif
+            op->handler(cpu, op->operand);
+
+            elapsed += (uint32_t)cpu->cycles;
+            cpu->cycles = 0u;
+
+            if ((elapsed >= cycles) || M6502_ATTENTION(cpu)
+            || (cache->invalidations != invalidations))
+            {
+                break;
+            }
+        }
+    }
+
+    return elapsed;
+}
+#endif
+#ifdef M6502_JIT
+/* Guest registers stay in callee-saved host registers across helper calls. */
+static const uint8_t M6502_JIT_RAX  = 0u;
+static const uint8_t M6502_JIT_RCX  = 1u;
+static const uint8_t M6502_JIT_RDX  = 2u;
+static const uint8_t M6502_JIT_RSP  = 4u;
+static const uint8_t M6502_JIT_RSI  = 6u;
+static const uint8_t M6502_JIT_RDI  = 7u;
+static const uint8_t M6502_JIT_CPU  = 3u;   /* rbx */
+static const uint8_t M6502_JIT_S    = 5u;   /* rbp */
+static const uint8_t M6502_JIT_A    = 12u;  /* r12 */
+static const uint8_t M6502_JIT_X    = 13u;  /* r13 */
+static const uint8_t M6502_JIT_Y    = 14u;  /* r14 */
+static const uint8_t M6502_JIT_P    = 15u;  /* r15 */
+
+static const uint8_t M6502_JIT_ADD  = 0u;
+static const uint8_t M6502_JIT_OR   = 1u;
+static const uint8_t M6502_JIT_AND  = 4u;
+static const uint8_t M6502_JIT_SUB  = 5u;
+static const uint8_t M6502_JIT_XOR  = 6u;
+static const uint8_t M6502_JIT_CMP  = 7u;
+static const uint8_t M6502_JIT_SHL  = 4u;
+static const uint8_t M6502_JIT_SHR  = 5u;
+
+static const uint8_t M6502_JIT_CC_AE    = 0x3u;
+static const uint8_t M6502_JIT_CC_E     = 0x4u;
+static const uint8_t M6502_JIT_CC_NE    = 0x5u;
+static const uint8_t M6502_JIT_CC_LE    = 0xEu;
+static const uint8_t M6502_JIT_ALWAYS   = 0xFFu;
+
+static const int32_t M6502_JIT_SLOT_REMAINING       = 0;
+static const int32_t M6502_JIT_SLOT_BUDGET          = 4;
+static const int32_t M6502_JIT_SLOT_INVALIDATIONS   = 8;
+static const int32_t M6502_JIT_SLOT_ADDRESS         = 12;
+static const int32_t M6502_JIT_SLOT_LOW             = 16;
+static const int32_t M6502_JIT_SLOT_BASE            = 20;
+static const int32_t M6502_JIT_SLOT_OLD             = 24;
+static const int32_t M6502_JIT_SLOT_SAVED           = 28;
+static const int32_t M6502_JIT_FRAME                = 40;
+
+static const int32_t M6502_JIT_KEEP_PC = -1;
+
+/* Worst case code for one instruction, checked before emitting it. */
+static const uint32_t M6502_JIT_OP_SPACE = 1024u;
+
+static const uint8_t M6502_JIT_NZ[0x100] = {
+    [0x00] = 0x02u,
+    [0x80] = 0x80u, 0x80u, 0x80u, 0x80u, 0x80u, 0x80u, 0x80u, 0x80u,
+    0x80u, 0x80u, 0x80u, 0x80u, 0x80u, 0x80u, 0x80u, 0x80u,
+    0x80u, 0x80u, 0x80u, 0x80u, 0x80u, 0x80u, 0x80u, 0x80u,
+    0x80u, 0x80u, 0x80u, 0x80u, 0x80u, 0x80u, 0x80u, 0x80u,
+    0x80u, 0x80u, 0x80u, 0x80u, 0x80u, 0x80u, 0x80u, 0x80u,
+    0x80u, 0x80u, 0x80u, 0x80u, 0x80u, 0x80u, 0x80u, 0x80u,
+    0x80u, 0x80u, 0x80u, 0x80u, 0x80u, 0x80u, 0x80u, 0x80u,
+    0x80u, 0x80u, 0x80u, 0x80u, 0x80u, 0x80u, 0x80u, 0x80u,
+    0x80u, 0x80u, 0x80u, 0x80u, 0x80u, 0x80u, 0x80u, 0x80u,
+    0x80u, 0x80u, 0x80u, 0x80u, 0x80u, 0x80u, 0x80u, 0x80u,
+    0x80u, 0x80u, 0x80u, 0x80u, 0x80u, 0x80u, 0x80u, 0x80u,
+    0x80u, 0x80u, 0x80u, 0x80u, 0x80u, 0x80u, 0x80u, 0x80u,
+    0x80u, 0x80u, 0x80u, 0x80u, 0x80u, 0x80u, 0x80u, 0x80u,
+    0x80u, 0x80u, 0x80u, 0x80u, 0x80u, 0x80u, 0x80u, 0x80u,
+    0x80u, 0x80u, 0x80u, 0x80u, 0x80u, 0x80u, 0x80u, 0x80u,
+    0x80u, 0x80u, 0x80u, 0x80u, 0x80u, 0x80u, 0x80u, 0x80u
+};
+
+typedef struct
+{
+    uint8_t     *patch;
+    int32_t     programCounter;
+} M6502_JitExit_t;
+
+typedef struct
+{
+    M6502_BlockCache_t  *cache;
+    const uintptr_t     *readPages;
+    const uintptr_t     *writePages;
+    const uint8_t       *sideEffectFree;
+    const M6502_Block_t *block;
+    uint8_t             *cursor;
+    uint8_t             *end;
+    uint8_t             *epilogue;
+    uint8_t             *body;
+    uint8_t             mayInvalidate;
+    uint8_t             terminated;
+    uint16_t            exitCount;
+    M6502_JitExit_t     exits[M6502_BLOCK_LENGTH * 8u];
+} M6502_Jit_t;
+
+static uint32_t M6502_Jit_Read(M6502_t *cpu, const uint32_t address)
+{
+    return M6502_ReadMemoryByte(cpu, (uint16_t)address);
+}
+
+static void M6502_Jit_Write(M6502_t *cpu, const uint32_t address, const uint32_t value)
+{
+    M6502_WriteMemoryByte(cpu, (uint16_t)address, (uint8_t)value);
+}
+
+static inline void M6502_Jit_Byte(M6502_Jit_t *jit, const uint8_t value)
+{
+    *jit->cursor++ = value;
+}
+
+static inline void M6502_Jit_Word(M6502_Jit_t *jit, const uint16_t value)
+{
+    memcpy(jit->cursor, &value, sizeof(value));
+    jit->cursor += sizeof(value);
+}
+
+static inline void M6502_Jit_Dword(M6502_Jit_t *jit, const uint32_t value)
+{
+    memcpy(jit->cursor, &value, sizeof(value));
+    jit->cursor += sizeof(value);
+}
+
+static inline void M6502_Jit_Qword(M6502_Jit_t *jit, const uint64_t value)
+{
+    memcpy(jit->cursor, &value, sizeof(value));
+    jit->cursor += sizeof(value);
+}
+
+static inline uint8_t M6502_Jit_IsByteRegister(const uint8_t reg)
+{
+    /* spl, bpl, sil and dil only exist with a REX prefix. */
+    return ((reg >= 4u) && (reg <= 7u)) ? 1u : 0u;
+}
+
+static inline void M6502_Jit_Rex(M6502_Jit_t *jit, const uint8_t wide, const uint8_t reg, const uint8_t index, const uint8_t base, const uint8_t force)
+{
+    const uint8_t rex = 0x40u | (uint8_t)(wide << 3u) | (uint8_t)((reg & 8u) >> 1u)
+                      | (uint8_t)((index & 8u) >> 2u) | (uint8_t)((base & 8u) >> 3u);
+
+    if ((rex != 0x40u) || force)
+    {
+        M6502_Jit_Byte(jit, rex);
+    }
+}
+
+static inline void M6502_Jit_ModRegister(M6502_Jit_t *jit, const uint8_t reg, const uint8_t rm)
+{
+    M6502_Jit_Byte(jit, 0xC0u | (uint8_t)((reg & 7u) << 3u) | (rm & 7u));
+}
+
+static inline void M6502_Jit_ModMemory(M6502_Jit_t *jit, const uint8_t reg, const uint8_t base, const int32_t displacement)
+{
+    M6502_Jit_Byte(jit, 0x80u | (uint8_t)((reg & 7u) << 3u) | (base & 7u));
+
+    if ((base & 7u) == M6502_JIT_RSP)
+    {
+        M6502_Jit_Byte(jit, 0x24u);
+    }
+
+    M6502_Jit_Dword(jit, (uint32_t)displacement);
+}
+
+static inline void M6502_Jit_ModIndex(M6502_Jit_t *jit, const uint8_t reg, const uint8_t base, const uint8_t index, const uint8_t scale)
+{
+    /* The base is never rbp or r13, which would need a displacement. */
+    M6502_Jit_Byte(jit, 0x04u | (uint8_t)((reg & 7u) << 3u));
+    M6502_Jit_Byte(jit, (uint8_t)(scale << 6u) | (uint8_t)((index & 7u) << 3u) | (base & 7u));
+}
+
+static void M6502_Jit_MovRegister(M6502_Jit_t *jit, const uint8_t destination, const uint8_t source)
+{
+    M6502_Jit_Rex(jit, 0u, source, 0u, destination, 0u);
+    M6502_Jit_Byte(jit, 0x89u);
+    M6502_Jit_ModRegister(jit, source, destination);
+}
+
+static void M6502_Jit_MovRegister64(M6502_Jit_t *jit, const uint8_t destination, const uint8_t source)
+{
+    M6502_Jit_Rex(jit, 1u, source, 0u, destination, 0u);
+    M6502_Jit_Byte(jit, 0x89u);
+    M6502_Jit_ModRegister(jit, source, destination);
+}
+
+static void M6502_Jit_MovImmediate(M6502_Jit_t *jit, const uint8_t destination, const uint32_t value)
+{
+    M6502_Jit_Rex(jit, 0u, 0u, 0u, destination, 0u);
+    M6502_Jit_Byte(jit, 0xB8u + (destination & 7u));
+    M6502_Jit_Dword(jit, value);
+}
+
+static void M6502_Jit_MovPointer(M6502_Jit_t *jit, const uint8_t destination, const uintptr_t value)
+{
+    M6502_Jit_Rex(jit, 1u, 0u, 0u, destination, 0u);
+    M6502_Jit_Byte(jit, 0xB8u + (destination & 7u));
+    M6502_Jit_Qword(jit, (uint64_t)value);
+}
+
+static void M6502_Jit_LoadByte(M6502_Jit_t *jit, const uint8_t destination, const uint8_t base, const int32_t displacement)
+{
+    M6502_Jit_Rex(jit, 0u, destination, 0u, base, 0u);
+    M6502_Jit_Byte(jit, 0x0Fu);
+    M6502_Jit_Byte(jit, 0xB6u);
+    M6502_Jit_ModMemory(jit, destination, base, displacement);
+}
+
+static void M6502_Jit_LoadByteIndex(M6502_Jit_t *jit, const uint8_t destination, const uint8_t base, const uint8_t index)
+{
+    M6502_Jit_Rex(jit, 0u, destination, index, base, 0u);
+    M6502_Jit_Byte(jit, 0x0Fu);
+    M6502_Jit_Byte(jit, 0xB6u);
+    M6502_Jit_ModIndex(jit, destination, base, index, 0u);
+}
+
+static void M6502_Jit_StoreByte(M6502_Jit_t *jit, const uint8_t base, const int32_t displacement, const uint8_t source)
+{
+    M6502_Jit_Rex(jit, 0u, source, 0u, base, M6502_Jit_IsByteRegister(source));
+    M6502_Jit_Byte(jit, 0x88u);
+    M6502_Jit_ModMemory(jit, source, base, displacement);
+}
+
+static void M6502_Jit_StoreByteIndex(M6502_Jit_t *jit, const uint8_t base, const uint8_t index, const uint8_t source)
+{
+    M6502_Jit_Rex(jit, 0u, source, index, base, M6502_Jit_IsByteRegister(source));
+    M6502_Jit_Byte(jit, 0x88u);
+    M6502_Jit_ModIndex(jit, source, base, index, 0u);
+}
+
+static void M6502_Jit_StoreByteImmediate(M6502_Jit_t *jit, const uint8_t base, const int32_t displacement, const uint8_t value)
+{
+    M6502_Jit_Rex(jit, 0u, 0u, 0u, base, 0u);
+    M6502_Jit_Byte(jit, 0xC6u);
+    M6502_Jit_ModMemory(jit, 0u, base, displacement);
+    M6502_Jit_Byte(jit, value);
+}
+
+static void M6502_Jit_StoreWordImmediate(M6502_Jit_t *jit, const uint8_t base, const int32_t displacement, const uint16_t value)
+{
+    M6502_Jit_Byte(jit, 0x66u);
+    M6502_Jit_Rex(jit, 0u, 0u, 0u, base, 0u);
+    M6502_Jit_Byte(jit, 0xC7u);
+    M6502_Jit_ModMemory(jit, 0u, base, displacement);
+    M6502_Jit_Word(jit, value);
+}
+
+static void M6502_Jit_LoadDword(M6502_Jit_t *jit, const uint8_t destination, const uint8_t base, const int32_t displacement)
+{
+    M6502_Jit_Rex(jit, 0u, destination, 0u, base, 0u);
+    M6502_Jit_Byte(jit, 0x8Bu);
+    M6502_Jit_ModMemory(jit, destination, base, displacement);
+}
+
+static void M6502_Jit_StoreDword(M6502_Jit_t *jit, const uint8_t base, const int32_t displacement, const uint8_t source)
+{
+    M6502_Jit_Rex(jit, 0u, source, 0u, base, 0u);
+    M6502_Jit_Byte(jit, 0x89u);
+    M6502_Jit_ModMemory(jit, source, base, displacement);
+}
+
+static void M6502_Jit_LoadPointerIndex(M6502_Jit_t *jit, const uint8_t destination, const uint8_t base, const uint8_t index)
+{
+    M6502_Jit_Rex(jit, 1u, destination, index, base, 0u);
+    M6502_Jit_Byte(jit, 0x8Bu);
+    M6502_Jit_ModIndex(jit, destination, base, index, 3u);
+}
+
+static void M6502_Jit_AluImmediate(M6502_Jit_t *jit, const uint8_t operation, const uint8_t destination, const uint32_t value)
+{
+    M6502_Jit_Rex(jit, 0u, 0u, 0u, destination, 0u);
+    M6502_Jit_Byte(jit, 0x81u);
+    M6502_Jit_ModRegister(jit, operation, destination);
+    M6502_Jit_Dword(jit, value);
+}
+
+static void M6502_Jit_AluRegister(M6502_Jit_t *jit, const uint8_t operation, const uint8_t destination, const uint8_t source)
+{
+    M6502_Jit_Rex(jit, 0u, source, 0u, destination, 0u);
+    M6502_Jit_Byte(jit, (uint8_t)(operation << 3u) | 0x01u);
+    M6502_Jit_ModRegister(jit, source, destination);
+}
+
+static void M6502_Jit_AluLoad(M6502_Jit_t *jit, const uint8_t operation, const uint8_t destination, const uint8_t base, const int32_t displacement)
+{
+    M6502_Jit_Rex(jit, 0u, destination, 0u, base, 0u);
+    M6502_Jit_Byte(jit, (uint8_t)(operation << 3u) | 0x03u);
+    M6502_Jit_ModMemory(jit, destination, base, displacement);
+}
+
+static void M6502_Jit_AluStore(M6502_Jit_t *jit, const uint8_t operation, const uint8_t base, const int32_t displacement, const uint8_t source)
+{
+    M6502_Jit_Rex(jit, 0u, source, 0u, base, 0u);
+    M6502_Jit_Byte(jit, (uint8_t)(operation << 3u) | 0x01u);
+    M6502_Jit_ModMemory(jit, source, base, displacement);
+}
+
+static void M6502_Jit_AluMemoryImmediate(M6502_Jit_t *jit, const uint8_t operation, const uint8_t base, const int32_t displacement, const uint32_t value)
+{
+    M6502_Jit_Rex(jit, 0u, 0u, 0u, base, 0u);
+    M6502_Jit_Byte(jit, 0x81u);
+    M6502_Jit_ModMemory(jit, operation, base, displacement);
+    M6502_Jit_Dword(jit, value);
+}
+
+static void M6502_Jit_CompareByte(M6502_Jit_t *jit, const uint8_t base, const int32_t displacement, const uint8_t value)
+{
+    M6502_Jit_Rex(jit, 0u, 0u, 0u, base, 0u);
+    M6502_Jit_Byte(jit, 0x80u);
+    M6502_Jit_ModMemory(jit, M6502_JIT_CMP, base, displacement);
+    M6502_Jit_Byte(jit, value);
+}
+
+static void M6502_Jit_CompareByteIndex(M6502_Jit_t *jit, const uint8_t base, const uint8_t index, const uint8_t value)
+{
+    M6502_Jit_Rex(jit, 0u, 0u, index, base, 0u);
+    M6502_Jit_Byte(jit, 0x80u);
+    M6502_Jit_ModIndex(jit, M6502_JIT_CMP, base, index, 0u);
+    M6502_Jit_Byte(jit, value);
+}
+
+static void M6502_Jit_TestImmediate(M6502_Jit_t *jit, const uint8_t destination, const uint32_t value)
+{
+    M6502_Jit_Rex(jit, 0u, 0u, 0u, destination, 0u);
+    M6502_Jit_Byte(jit, 0xF7u);
+    M6502_Jit_ModRegister(jit, 0u, destination);
+    M6502_Jit_Dword(jit, value);
+}
+
+static void M6502_Jit_TestRegister(M6502_Jit_t *jit, const uint8_t destination, const uint8_t source)
+{
+    M6502_Jit_Rex(jit, 0u, source, 0u, destination, 0u);
+    M6502_Jit_Byte(jit, 0x85u);
+    M6502_Jit_ModRegister(jit, source, destination);
+}
+
+static void M6502_Jit_TestPointer(M6502_Jit_t *jit, const uint8_t reg)
+{
+    M6502_Jit_Rex(jit, 1u, reg, 0u, reg, 0u);
+    M6502_Jit_Byte(jit, 0x85u);
+    M6502_Jit_ModRegister(jit, reg, reg);
+}
+
+static void M6502_Jit_Shift(M6502_Jit_t *jit, const uint8_t operation, const uint8_t destination, const uint8_t count)
+{
+    M6502_Jit_Rex(jit, 0u, 0u, 0u, destination, 0u);
+    M6502_Jit_Byte(jit, 0xC1u);
+    M6502_Jit_ModRegister(jit, operation, destination);
+    M6502_Jit_Byte(jit, count);
+}
+
+static void M6502_Jit_SetCondition(M6502_Jit_t *jit, const uint8_t condition, const uint8_t destination)
+{
+    const uint8_t force = M6502_Jit_IsByteRegister(destination);
+
+    M6502_Jit_Rex(jit, 0u, 0u, 0u, destination, force);
+    M6502_Jit_Byte(jit, 0x0Fu);
+    M6502_Jit_Byte(jit, 0x90u + condition);
+    M6502_Jit_ModRegister(jit, 0u, destination);
+
+    M6502_Jit_Rex(jit, 0u, destination, 0u, destination, force);
+    M6502_Jit_Byte(jit, 0x0Fu);
+    M6502_Jit_Byte(jit, 0xB6u);
+    M6502_Jit_ModRegister(jit, destination, destination);
+}
+
+static uint8_t *M6502_Jit_Branch(M6502_Jit_t *jit, const uint8_t condition)
+{
+    if (condition == M6502_JIT_ALWAYS)
+    {
+        M6502_Jit_Byte(jit, 0xE9u);
+    }
+    else
+    {
+        M6502_Jit_Byte(jit, 0x0Fu);
+        M6502_Jit_Byte(jit, 0x80u + condition);
+    }
+
+    uint8_t *patch = jit->cursor;
+    M6502_Jit_Dword(jit, 0u);
+
+    return patch;
+}
+
+static void M6502_Jit_Link(uint8_t *patch, const uint8_t *target)
+{
+    const int32_t relative = (int32_t)(target - (patch + 4));
+
+    memcpy(patch, &relative, sizeof(relative));
+}
+
+static void M6502_Jit_Call(M6502_Jit_t *jit, const uintptr_t function)
+{
+    M6502_Jit_MovPointer(jit, M6502_JIT_RAX, function);
+    M6502_Jit_Byte(jit, 0xFFu);
+    M6502_Jit_Byte(jit, 0xD0u);
+}
+
+static void M6502_Jit_Exit(M6502_Jit_t *jit, const uint8_t condition, const int32_t programCounter)
+{
+    M6502_JitExit_t *exit = &jit->exits[jit->exitCount++];
+
+    exit->patch             = M6502_Jit_Branch(jit, condition);
+    exit->programCounter    = programCounter;
+}
+
+static void M6502_Jit_StoreRegisters(M6502_Jit_t *jit)
+{
+    M6502_Jit_StoreByte(jit, M6502_JIT_CPU, (int32_t)offsetof(M6502_t, accumulator),    M6502_JIT_A);
+    M6502_Jit_StoreByte(jit, M6502_JIT_CPU, (int32_t)offsetof(M6502_t, xRegister),      M6502_JIT_X);
+    M6502_Jit_StoreByte(jit, M6502_JIT_CPU, (int32_t)offsetof(M6502_t, yRegister),      M6502_JIT_Y);
+    M6502_Jit_StoreByte(jit, M6502_JIT_CPU, (int32_t)offsetof(M6502_t, stackPointer),   M6502_JIT_S);
+
+    M6502_Jit_StoreByte(jit, M6502_JIT_CPU, (int32_t)offsetof(M6502_t, statusRegister), M6502_JIT_P);
+
+#ifdef M6502_LAZY_FLAGS
+    /* Native code keeps a packed P, so split it back into the lazy fields. */
+    M6502_Jit_MovRegister(jit, M6502_JIT_RAX, M6502_JIT_P);
+    M6502_Jit_AluImmediate(jit, M6502_JIT_AND, M6502_JIT_RAX, M6502_FLAG_NEGATIVE);
+    M6502_Jit_StoreByte(jit, M6502_JIT_CPU, (int32_t)offsetof(M6502_t, negativeResult), M6502_JIT_RAX);
+
+    M6502_Jit_MovRegister(jit, M6502_JIT_RAX, M6502_JIT_P);
+    M6502_Jit_AluImmediate(jit, M6502_JIT_AND, M6502_JIT_RAX, M6502_FLAG_ZERO);
+    M6502_Jit_AluImmediate(jit, M6502_JIT_XOR, M6502_JIT_RAX, M6502_FLAG_ZERO);
+    M6502_Jit_StoreByte(jit, M6502_JIT_CPU, (int32_t)offsetof(M6502_t, zeroResult), M6502_JIT_RAX);
+
+    M6502_Jit_MovRegister(jit, M6502_JIT_RAX, M6502_JIT_P);
+    M6502_Jit_AluImmediate(jit, M6502_JIT_AND, M6502_JIT_RAX, M6502_FLAG_CARRY);
+    M6502_Jit_StoreByte(jit, M6502_JIT_CPU, (int32_t)offsetof(M6502_t, carryFlag), M6502_JIT_RAX);
+
+    M6502_Jit_MovRegister(jit, M6502_JIT_RAX, M6502_JIT_P);
+    M6502_Jit_Shift(jit, M6502_JIT_SHR, M6502_JIT_RAX, 6u);
+    M6502_Jit_AluImmediate(jit, M6502_JIT_AND, M6502_JIT_RAX, 1u);
+    M6502_Jit_StoreByte(jit, M6502_JIT_CPU, (int32_t)offsetof(M6502_t, overflowFlag), M6502_JIT_RAX);
+#endif
+}
+
+static void M6502_Jit_LoadRegisters(M6502_Jit_t *jit)
+{
+    M6502_Jit_LoadByte(jit, M6502_JIT_A, M6502_JIT_CPU, (int32_t)offsetof(M6502_t, accumulator));
+    M6502_Jit_LoadByte(jit, M6502_JIT_X, M6502_JIT_CPU, (int32_t)offsetof(M6502_t, xRegister));
+    M6502_Jit_LoadByte(jit, M6502_JIT_Y, M6502_JIT_CPU, (int32_t)offsetof(M6502_t, yRegister));
+    M6502_Jit_LoadByte(jit, M6502_JIT_S, M6502_JIT_CPU, (int32_t)offsetof(M6502_t, stackPointer));
+
+    M6502_Jit_LoadByte(jit, M6502_JIT_P, M6502_JIT_CPU, (int32_t)offsetof(M6502_t, statusRegister));
+
+#ifdef M6502_LAZY_FLAGS
+    M6502_Jit_AluImmediate(jit, M6502_JIT_AND, M6502_JIT_P,
+        (uint8_t)~(M6502_FLAG_NEGATIVE | M6502_FLAG_OVERFLOW | M6502_FLAG_ZERO | M6502_FLAG_CARRY));
+
+    M6502_Jit_LoadByte(jit, M6502_JIT_RAX, M6502_JIT_CPU, (int32_t)offsetof(M6502_t, negativeResult));
+    M6502_Jit_AluImmediate(jit, M6502_JIT_AND, M6502_JIT_RAX, M6502_FLAG_NEGATIVE);
+    M6502_Jit_AluRegister(jit, M6502_JIT_OR, M6502_JIT_P, M6502_JIT_RAX);
+
+    M6502_Jit_CompareByte(jit, M6502_JIT_CPU, (int32_t)offsetof(M6502_t, zeroResult), 0u);
+    M6502_Jit_SetCondition(jit, M6502_JIT_CC_E, M6502_JIT_RAX);
+    M6502_Jit_Shift(jit, M6502_JIT_SHL, M6502_JIT_RAX, 1u);
+    M6502_Jit_AluRegister(jit, M6502_JIT_OR, M6502_JIT_P, M6502_JIT_RAX);
+
+    M6502_Jit_LoadByte(jit, M6502_JIT_RAX, M6502_JIT_CPU, (int32_t)offsetof(M6502_t, carryFlag));
+    M6502_Jit_AluRegister(jit, M6502_JIT_OR, M6502_JIT_P, M6502_JIT_RAX);
+
+    M6502_Jit_LoadByte(jit, M6502_JIT_RAX, M6502_JIT_CPU, (int32_t)offsetof(M6502_t, overflowFlag));
+    M6502_Jit_Shift(jit, M6502_JIT_SHL, M6502_JIT_RAX, 6u);
+    M6502_Jit_AluRegister(jit, M6502_JIT_OR, M6502_JIT_P, M6502_JIT_RAX);
+#endif
+}
+
+static void M6502_Jit_Epilogue(M6502_Jit_t *jit)
+{
+    M6502_Jit_StoreRegisters(jit);
+
+    M6502_Jit_LoadDword(jit, M6502_JIT_RAX, M6502_JIT_RSP, M6502_JIT_SLOT_BUDGET);
+    M6502_Jit_AluLoad(jit, M6502_JIT_SUB, M6502_JIT_RAX, M6502_JIT_RSP, M6502_JIT_SLOT_REMAINING);
+
+    /* add rsp, frame */
+    M6502_Jit_Rex(jit, 1u, 0u, 0u, M6502_JIT_RSP, 0u);
+    M6502_Jit_Byte(jit, 0x81u);
+    M6502_Jit_ModRegister(jit, M6502_JIT_ADD, M6502_JIT_RSP);
+    M6502_Jit_Dword(jit, (uint32_t)M6502_JIT_FRAME);
+
+    const uint8_t saved[] = { M6502_JIT_P, M6502_JIT_Y, M6502_JIT_X, M6502_JIT_A, M6502_JIT_S, M6502_JIT_CPU };
+
+    for (uint8_t index = 0u; index < sizeof(saved); ++index)
+    {
+        M6502_Jit_Rex(jit, 0u, 0u, 0u, saved[index], 0u);
+        M6502_Jit_Byte(jit, 0x58u + (saved[index] & 7u));
+    }
+
+    M6502_Jit_Byte(jit, 0xC3u);
+}
+
+static void M6502_Jit_Prologue(M6502_Jit_t *jit)
+{
+    const uint8_t saved[] = { M6502_JIT_CPU, M6502_JIT_S, M6502_JIT_A, M6502_JIT_X, M6502_JIT_Y, M6502_JIT_P };
+
+    for (uint8_t index = 0u; index < sizeof(saved); ++index)
+    {
+        M6502_Jit_Rex(jit, 0u, 0u, 0u, saved[index], 0u);
+        M6502_Jit_Byte(jit, 0x50u + (saved[index] & 7u));
+    }
+
+    /* sub rsp, frame */
+    M6502_Jit_Rex(jit, 1u, 0u, 0u, M6502_JIT_RSP, 0u);
+    M6502_Jit_Byte(jit, 0x81u);
+    M6502_Jit_ModRegister(jit, M6502_JIT_SUB, M6502_JIT_RSP);
+    M6502_Jit_Dword(jit, (uint32_t)M6502_JIT_FRAME);
+
+    M6502_Jit_MovRegister64(jit, M6502_JIT_CPU, M6502_JIT_RDI);
+    M6502_Jit_StoreDword(jit, M6502_JIT_RSP, M6502_JIT_SLOT_REMAINING, M6502_JIT_RSI);
+    M6502_Jit_StoreDword(jit, M6502_JIT_RSP, M6502_JIT_SLOT_BUDGET, M6502_JIT_RSI);
+
+    M6502_Jit_MovPointer(jit, M6502_JIT_RAX, (uintptr_t)&jit->cache->invalidations);
+    M6502_Jit_LoadDword(jit, M6502_JIT_RAX, M6502_JIT_RAX, 0);
+    M6502_Jit_StoreDword(jit, M6502_JIT_RSP, M6502_JIT_SLOT_INVALIDATIONS, M6502_JIT_RAX);
+
+    M6502_Jit_LoadRegisters(jit);
+    M6502_Jit_AluImmediate(jit, M6502_JIT_OR, M6502_JIT_P, M6502_FLAG_UNUSED);
+}
+
+static void M6502_Jit_SetNZ(M6502_Jit_t *jit, const uint8_t reg)
+{
+    M6502_Jit_MovPointer(jit, M6502_JIT_RDX, (uintptr_t)M6502_JIT_NZ);
+    M6502_Jit_LoadByteIndex(jit, M6502_JIT_RDX, M6502_JIT_RDX, reg);
+    M6502_Jit_AluImmediate(jit, M6502_JIT_AND, M6502_JIT_P, (uint8_t)~(M6502_FLAG_NEGATIVE | M6502_FLAG_ZERO));
+    M6502_Jit_AluRegister(jit, M6502_JIT_OR, M6502_JIT_P, M6502_JIT_RDX);
+}
+
+static void M6502_Jit_CallRead(M6502_Jit_t *jit, const int32_t slot)
+{
+    /* Address in eax, value to ecx, eax is restored from the slot. */
+    M6502_Jit_StoreDword(jit, M6502_JIT_RSP, slot, M6502_JIT_RAX);
+    M6502_Jit_MovRegister64(jit, M6502_JIT_RDI, M6502_JIT_CPU);
+    M6502_Jit_MovRegister(jit, M6502_JIT_RSI, M6502_JIT_RAX);
+    M6502_Jit_Call(jit, (uintptr_t)M6502_Jit_Read);
+    M6502_Jit_MovRegister(jit, M6502_JIT_RCX, M6502_JIT_RAX);
+    M6502_Jit_LoadDword(jit, M6502_JIT_RAX, M6502_JIT_RSP, slot);
+}
+
+static void M6502_Jit_CallWrite(M6502_Jit_t *jit)
+{
+    /* Address in eax, value in ecx, eax is restored afterwards. */
+    M6502_Jit_StoreDword(jit, M6502_JIT_RSP, M6502_JIT_SLOT_ADDRESS, M6502_JIT_RAX);
+    M6502_Jit_MovRegister64(jit, M6502_JIT_RDI, M6502_JIT_CPU);
+    M6502_Jit_MovRegister(jit, M6502_JIT_RSI, M6502_JIT_RAX);
+    M6502_Jit_MovRegister(jit, M6502_JIT_RDX, M6502_JIT_RCX);
+    M6502_Jit_Call(jit, (uintptr_t)M6502_Jit_Write);
+    M6502_Jit_LoadDword(jit, M6502_JIT_RAX, M6502_JIT_RSP, M6502_JIT_SLOT_ADDRESS);
+
+    jit->mayInvalidate = 1u;
+}
+
+static void M6502_Jit_ReadStatic(M6502_Jit_t *jit, const uint16_t address)
+{
+    const uintptr_t bias = jit->readPages[address >> 8u];
+
+    if (bias != 0u)
+    {
+        M6502_Jit_MovPointer(jit, M6502_JIT_RSI, bias + address);
+        M6502_Jit_LoadByte(jit, M6502_JIT_RCX, M6502_JIT_RSI, 0);
+        return;
+    }
+
+    M6502_Jit_MovImmediate(jit, M6502_JIT_RAX, address);
+    M6502_Jit_CallRead(jit, M6502_JIT_SLOT_ADDRESS);
+}
+
+static inline uint8_t M6502_Jit_Quiet(const M6502_Jit_t *jit, const uint8_t page)
+{
+    return (jit->sideEffectFree != NULL) && (jit->sideEffectFree[page] != 0u);
+}
+
+static void M6502_Jit_DummyStatic(M6502_Jit_t *jit, const uint16_t address)
+{
+    if ((jit->readPages[address >> 8u] == 0u) && !M6502_Jit_Quiet(jit, (uint8_t)(address >> 8u)))
+    {
+        M6502_Jit_MovImmediate(jit, M6502_JIT_RAX, address);
+        M6502_Jit_CallRead(jit, M6502_JIT_SLOT_ADDRESS);
+    }
+}
+
+static void M6502_Jit_ReadDynamic(M6502_Jit_t *jit, const int16_t page)
+{
+    /* Address in eax, value to ecx, eax survives. A page >= 0 is known at translation time. */
+    if (page >= 0)
+    {
+        const uintptr_t bias = jit->readPages[page];
+
+        if (bias != 0u)
+        {
+            M6502_Jit_MovPointer(jit, M6502_JIT_RSI, bias);
+            M6502_Jit_LoadByteIndex(jit, M6502_JIT_RCX, M6502_JIT_RSI, M6502_JIT_RAX);
+        }
+        else
+        {
+            M6502_Jit_CallRead(jit, M6502_JIT_SLOT_ADDRESS);
+        }
+        return;
+    }
+
+    M6502_Jit_MovRegister(jit, M6502_JIT_RDX, M6502_JIT_RAX);
+    M6502_Jit_Shift(jit, M6502_JIT_SHR, M6502_JIT_RDX, 8u);
+    M6502_Jit_MovPointer(jit, M6502_JIT_RSI, (uintptr_t)jit->readPages);
+    M6502_Jit_LoadPointerIndex(jit, M6502_JIT_RSI, M6502_JIT_RSI, M6502_JIT_RDX);
+    M6502_Jit_TestPointer(jit, M6502_JIT_RSI);
+    uint8_t *slow = M6502_Jit_Branch(jit, M6502_JIT_CC_E);
+    M6502_Jit_LoadByteIndex(jit, M6502_JIT_RCX, M6502_JIT_RSI, M6502_JIT_RAX);
+    uint8_t *done = M6502_Jit_Branch(jit, M6502_JIT_ALWAYS);
+    M6502_Jit_Link(slow, jit->cursor);
+    M6502_Jit_CallRead(jit, M6502_JIT_SLOT_ADDRESS);
+    M6502_Jit_Link(done, jit->cursor);
+}
+
+static void M6502_Jit_DummyDynamic(M6502_Jit_t *jit, const int16_t page)
+{
+    if (page >= 0)
+    {
+        if ((jit->readPages[page] == 0u) && !M6502_Jit_Quiet(jit, (uint8_t)page))
+        {
+            M6502_Jit_CallRead(jit, M6502_JIT_SLOT_SAVED);
+        }
+        return;
+    }
+
+    M6502_Jit_MovRegister(jit, M6502_JIT_RDX, M6502_JIT_RAX);
+    M6502_Jit_Shift(jit, M6502_JIT_SHR, M6502_JIT_RDX, 8u);
+    M6502_Jit_MovPointer(jit, M6502_JIT_RSI, (uintptr_t)jit->readPages);
+    M6502_Jit_LoadPointerIndex(jit, M6502_JIT_RSI, M6502_JIT_RSI, M6502_JIT_RDX);
+    M6502_Jit_TestPointer(jit, M6502_JIT_RSI);
+    uint8_t *done = M6502_Jit_Branch(jit, M6502_JIT_CC_NE);
+    M6502_Jit_CallRead(jit, M6502_JIT_SLOT_SAVED);
+    M6502_Jit_Link(done, jit->cursor);
+}
+
+static void M6502_Jit_WriteSlow(M6502_Jit_t *jit, const uint8_t modify)
+{
+    if (modify)
+    {
+        /* Read-modify-write replays the dummy write of the old value first. */
+        M6502_Jit_StoreDword(jit, M6502_JIT_RSP, M6502_JIT_SLOT_LOW, M6502_JIT_RCX);
+        M6502_Jit_LoadDword(jit, M6502_JIT_RCX, M6502_JIT_RSP, M6502_JIT_SLOT_OLD);
+        M6502_Jit_CallWrite(jit);
+        M6502_Jit_LoadDword(jit, M6502_JIT_RCX, M6502_JIT_RSP, M6502_JIT_SLOT_LOW);
+    }
+
+    M6502_Jit_CallWrite(jit);
+}
+
+static void M6502_Jit_WriteDynamic(M6502_Jit_t *jit, const int16_t page, const uint8_t modify)
+{
+    /* Address in eax, value in ecx, eax survives. */
+    uint8_t *slow[2] = { NULL, NULL };
+
+    if (page >= 0)
+    {
+        const uintptr_t bias = jit->writePages[page];
+
+        if (bias == 0u)
+        {
+            M6502_Jit_WriteSlow(jit, modify && !M6502_Jit_Quiet(jit, (uint8_t)page));
+            return;
+        }
+
+        M6502_Jit_MovPointer(jit, M6502_JIT_RSI, (uintptr_t)&jit->cache->codePages[page]);
+        M6502_Jit_CompareByte(jit, M6502_JIT_RSI, 0, 0u);
+        slow[0] = M6502_Jit_Branch(jit, M6502_JIT_CC_NE);
+        M6502_Jit_MovPointer(jit, M6502_JIT_RSI, bias);
+    }
+    else
+    {
+        M6502_Jit_MovRegister(jit, M6502_JIT_RDX, M6502_JIT_RAX);
+        M6502_Jit_Shift(jit, M6502_JIT_SHR, M6502_JIT_RDX, 8u);
+        M6502_Jit_MovPointer(jit, M6502_JIT_RSI, (uintptr_t)jit->cache->codePages);
+        M6502_Jit_CompareByteIndex(jit, M6502_JIT_RSI, M6502_JIT_RDX, 0u);
+        slow[0] = M6502_Jit_Branch(jit, M6502_JIT_CC_NE);
+        M6502_Jit_MovPointer(jit, M6502_JIT_RSI, (uintptr_t)jit->writePages);
+        M6502_Jit_LoadPointerIndex(jit, M6502_JIT_RSI, M6502_JIT_RSI, M6502_JIT_RDX);
+        M6502_Jit_TestPointer(jit, M6502_JIT_RSI);
+        slow[1] = M6502_Jit_Branch(jit, M6502_JIT_CC_E);
+    }
+
+    /* Plain RAM without cached code: the dummy write of RMW has no effect. */
+    M6502_Jit_StoreByteIndex(jit, M6502_JIT_RSI, M6502_JIT_RAX, M6502_JIT_RCX);
+    uint8_t *done = M6502_Jit_Branch(jit, M6502_JIT_ALWAYS);
+
+    for (uint8_t index = 0u; index < 2u; ++index)
+    {
+        if (slow[index] != NULL)
+        {
+            M6502_Jit_Link(slow[index], jit->cursor);
+        }
+    }
+
+    M6502_Jit_WriteSlow(jit, modify);
+    M6502_Jit_Link(done, jit->cursor);
+}
+
+/* Native code's M6502_ATTENTION: pending interrupts, and requests posted by other threads. */
+static void M6502_Jit_ExitOnAttention(M6502_Jit_t *jit, const int32_t programCounter)
+{
+    M6502_Jit_CompareByte(jit, M6502_JIT_CPU, (int32_t)offsetof(M6502_t, pendingInterrupts), 0u);
+    M6502_Jit_Exit(jit, M6502_JIT_CC_NE, programCounter);
+#ifdef M6502_ATOMIC
+    M6502_Jit_CompareByte(jit, M6502_JIT_CPU, (int32_t)offsetof(M6502_t, requests), 0u);
+    M6502_Jit_Exit(jit, M6502_JIT_CC_NE, programCounter);
+#endif
+}
+
+static void M6502_Jit_EndInstruction(M6502_Jit_t *jit, const uint8_t cycles, const int32_t programCounter)
+{
+    M6502_Jit_AluMemoryImmediate(jit, M6502_JIT_SUB, M6502_JIT_RSP, M6502_JIT_SLOT_REMAINING, cycles);
+    M6502_Jit_Exit(jit, M6502_JIT_CC_LE, programCounter);
+
+    M6502_Jit_ExitOnAttention(jit, programCounter);
+
+    if (jit->mayInvalidate)
+    {
+        M6502_Jit_MovPointer(jit, M6502_JIT_RSI, (uintptr_t)&jit->cache->invalidations);
+        M6502_Jit_LoadDword(jit, M6502_JIT_RDX, M6502_JIT_RSI, 0);
+        M6502_Jit_AluLoad(jit, M6502_JIT_CMP, M6502_JIT_RDX, M6502_JIT_RSP, M6502_JIT_SLOT_INVALIDATIONS);
+        M6502_Jit_Exit(jit, M6502_JIT_CC_NE, programCounter);
+    }
+}
+
+static void M6502_Jit_Fallback(M6502_Jit_t *jit, const M6502_MicroOp_t *op, const uint8_t leave)
+{
+    M6502_Jit_StoreRegisters(jit);
+    M6502_Jit_StoreWordImmediate(jit, M6502_JIT_CPU, (int32_t)offsetof(M6502_t, programCounter), op->next);
+    M6502_Jit_StoreByteImmediate(jit, M6502_JIT_CPU, (int32_t)offsetof(M6502_t, opcode), op->opcode);
+    M6502_Jit_StoreByteImmediate(jit, M6502_JIT_CPU, (int32_t)offsetof(M6502_t, cycles), op->cycles);
+
+    M6502_Jit_MovRegister64(jit, M6502_JIT_RDI, M6502_JIT_CPU);
+    M6502_Jit_MovImmediate(jit, M6502_JIT_RSI, op->operand);
+    M6502_Jit_Call(jit, (uintptr_t)op->handler);
+
+    M6502_Jit_LoadRegisters(jit);
+    M6502_Jit_LoadByte(jit, M6502_JIT_RAX, M6502_JIT_CPU, (int32_t)offsetof(M6502_t, cycles));
+    M6502_Jit_StoreByteImmediate(jit, M6502_JIT_CPU, (int32_t)offsetof(M6502_t, cycles), 0u);
+    M6502_Jit_AluStore(jit, M6502_JIT_SUB, M6502_JIT_RSP, M6502_JIT_SLOT_REMAINING, M6502_JIT_RAX);
+
+    /* The handler already left the program counter where execution goes on. */
+    if (leave)
+    {
+        M6502_Jit_Exit(jit, M6502_JIT_ALWAYS, M6502_JIT_KEEP_PC);
+        return;
+    }
+
+    M6502_Jit_Exit(jit, M6502_JIT_CC_LE, M6502_JIT_KEEP_PC);
+
+    M6502_Jit_ExitOnAttention(jit, M6502_JIT_KEEP_PC);
+
+    M6502_Jit_MovPointer(jit, M6502_JIT_RSI, (uintptr_t)&jit->cache->invalidations);
+    M6502_Jit_LoadDword(jit, M6502_JIT_RDX, M6502_JIT_RSI, 0);
+    M6502_Jit_AluLoad(jit, M6502_JIT_CMP, M6502_JIT_RDX, M6502_JIT_RSP, M6502_JIT_SLOT_INVALIDATIONS);
+    M6502_Jit_Exit(jit, M6502_JIT_CC_NE, M6502_JIT_KEEP_PC);
+}
+
+static void M6502_Jit_PageCross(M6502_Jit_t *jit, const uint8_t access, const uint16_t base, const uint8_t staticBase)
+{
+    /* Effective address in eax, a dynamic base lives in its slot. */
+    uint8_t *skip = NULL;
+
+    if (access == M6502_Access_Read)
+    {
+        M6502_Jit_MovRegister(jit, M6502_JIT_RDX, M6502_JIT_RAX);
+
+        if (staticBase)
+        {
+            M6502_Jit_AluImmediate(jit, M6502_JIT_XOR, M6502_JIT_RDX, base);
+        }
+        else
+        {
+            M6502_Jit_AluLoad(jit, M6502_JIT_XOR, M6502_JIT_RDX, M6502_JIT_RSP, M6502_JIT_SLOT_BASE);
+        }
+
+        M6502_Jit_TestImmediate(jit, M6502_JIT_RDX, 0xFF00u);
+        skip = M6502_Jit_Branch(jit, M6502_JIT_CC_E);
+        M6502_Jit_AluMemoryImmediate(jit, M6502_JIT_SUB, M6502_JIT_RSP, M6502_JIT_SLOT_REMAINING, 1u);
+    }
+
+    if (!staticBase || (jit->readPages[base >> 8u] == 0u))
+    {
+        M6502_Jit_StoreDword(jit, M6502_JIT_RSP, M6502_JIT_SLOT_ADDRESS, M6502_JIT_RAX);
+        M6502_Jit_AluImmediate(jit, M6502_JIT_AND, M6502_JIT_RAX, 0xFFu);
+
+        if (staticBase)
+        {
+            M6502_Jit_AluImmediate(jit, M6502_JIT_OR, M6502_JIT_RAX, base & 0xFF00u);
+        }
+        else
+        {
+            M6502_Jit_LoadDword(jit, M6502_JIT_RDX, M6502_JIT_RSP, M6502_JIT_SLOT_BASE);
+            M6502_Jit_AluImmediate(jit, M6502_JIT_AND, M6502_JIT_RDX, 0xFF00u);
+            M6502_Jit_AluRegister(jit, M6502_JIT_OR, M6502_JIT_RAX, M6502_JIT_RDX);
+        }
+
+        M6502_Jit_DummyDynamic(jit, staticBase ? (int16_t)(base >> 8u) : -1);
+        M6502_Jit_LoadDword(jit, M6502_JIT_RAX, M6502_JIT_RSP, M6502_JIT_SLOT_ADDRESS);
+    }
+
+    if (skip != NULL)
+    {
+        M6502_Jit_Link(skip, jit->cursor);
+    }
+}
+
+static int16_t M6502_Jit_Address(M6502_Jit_t *jit, const M6502_MicroOp_t *op, const M6502_OpcodeInfo_t *info)
+{
+    /* Leaves the effective address in eax, returns its page when known up front. */
+    const uint16_t operand = op->operand;
+
+    switch (info->addressMode)
+    {
+        case M6502_AddressMode_ZeroPage:
+        case M6502_AddressMode_Absolute:
+            M6502_Jit_MovImmediate(jit, M6502_JIT_RAX, operand);
+            return (int16_t)(operand >> 8u);
+
+        case M6502_AddressMode_ZeroPageX:
+        case M6502_AddressMode_ZeroPageY:
+            M6502_Jit_DummyStatic(jit, operand);
+            M6502_Jit_MovRegister(jit, M6502_JIT_RAX,
+                (info->addressMode == M6502_AddressMode_ZeroPageX) ? M6502_JIT_X : M6502_JIT_Y);
+            M6502_Jit_AluImmediate(jit, M6502_JIT_ADD, M6502_JIT_RAX, operand);
+            M6502_Jit_AluImmediate(jit, M6502_JIT_AND, M6502_JIT_RAX, 0xFFu);
+            return 0;
+
+        case M6502_AddressMode_AbsoluteX:
+        case M6502_AddressMode_AbsoluteY:
+            M6502_Jit_MovRegister(jit, M6502_JIT_RAX,
+                (info->addressMode == M6502_AddressMode_AbsoluteX) ? M6502_JIT_X : M6502_JIT_Y);
+            M6502_Jit_AluImmediate(jit, M6502_JIT_ADD, M6502_JIT_RAX, operand);
+            M6502_Jit_AluImmediate(jit, M6502_JIT_AND, M6502_JIT_RAX, 0xFFFFu);
+            M6502_Jit_PageCross(jit, info->access, operand, 1u);
+            return -1;
+
+        case M6502_AddressMode_IndirectX:
+            M6502_Jit_DummyStatic(jit, operand);
+            M6502_Jit_MovRegister(jit, M6502_JIT_RAX, M6502_JIT_X);
+            M6502_Jit_AluImmediate(jit, M6502_JIT_ADD, M6502_JIT_RAX, operand);
+            M6502_Jit_AluImmediate(jit, M6502_JIT_AND, M6502_JIT_RAX, 0xFFu);
+            M6502_Jit_ReadDynamic(jit, 0);
+            M6502_Jit_StoreDword(jit, M6502_JIT_RSP, M6502_JIT_SLOT_LOW, M6502_JIT_RCX);
+            M6502_Jit_AluImmediate(jit, M6502_JIT_ADD, M6502_JIT_RAX, 1u);
+            M6502_Jit_AluImmediate(jit, M6502_JIT_AND, M6502_JIT_RAX, 0xFFu);
+            M6502_Jit_ReadDynamic(jit, 0);
+            M6502_Jit_Shift(jit, M6502_JIT_SHL, M6502_JIT_RCX, 8u);
+            M6502_Jit_AluLoad(jit, M6502_JIT_OR, M6502_JIT_RCX, M6502_JIT_RSP, M6502_JIT_SLOT_LOW);
+            M6502_Jit_MovRegister(jit, M6502_JIT_RAX, M6502_JIT_RCX);
+            return -1;
+
+        case M6502_AddressMode_IndirectY:
+            M6502_Jit_ReadStatic(jit, operand);
+            M6502_Jit_StoreDword(jit, M6502_JIT_RSP, M6502_JIT_SLOT_LOW, M6502_JIT_RCX);
+            M6502_Jit_ReadStatic(jit, (operand & 0xFF00u) | ((operand + 1u) & 0x00FFu));
+            M6502_Jit_Shift(jit, M6502_JIT_SHL, M6502_JIT_RCX, 8u);
+            M6502_Jit_AluLoad(jit, M6502_JIT_OR, M6502_JIT_RCX, M6502_JIT_RSP, M6502_JIT_SLOT_LOW);
+            M6502_Jit_StoreDword(jit, M6502_JIT_RSP, M6502_JIT_SLOT_BASE, M6502_JIT_RCX);
+            M6502_Jit_MovRegister(jit, M6502_JIT_RAX, M6502_JIT_RCX);
+            M6502_Jit_AluRegister(jit, M6502_JIT_ADD, M6502_JIT_RAX, M6502_JIT_Y);
+            M6502_Jit_AluImmediate(jit, M6502_JIT_AND, M6502_JIT_RAX, 0xFFFFu);
+            M6502_Jit_PageCross(jit, info->access, 0x0000u, 0u);
+            return -1;
+
+        default:
+            return -1;
+    }
+}
+
+static void M6502_Jit_Operand(M6502_Jit_t *jit, const M6502_MicroOp_t *op, const M6502_OpcodeInfo_t *info)
+{
+    /* Leaves the operand value in ecx. */
+    switch (info->addressMode)
+    {
+        case M6502_AddressMode_Immediate:
+            M6502_Jit_MovImmediate(jit, M6502_JIT_RCX, op->operand);
+            break;
+
+        case M6502_AddressMode_ZeroPage:
+        case M6502_AddressMode_Absolute:
+            M6502_Jit_ReadStatic(jit, op->operand);
+            break;
+
+        default:
+            M6502_Jit_ReadDynamic(jit, M6502_Jit_Address(jit, op, info));
+            break;
+    }
+}
+
+static void M6502_Jit_Compare(M6502_Jit_t *jit, const uint8_t reg)
+{
+    M6502_Jit_AluRegister(jit, M6502_JIT_CMP, reg, M6502_JIT_RCX);
+    M6502_Jit_SetCondition(jit, M6502_JIT_CC_AE, M6502_JIT_RDX);
+    M6502_Jit_AluImmediate(jit, M6502_JIT_AND, M6502_JIT_P, (uint8_t)~M6502_FLAG_CARRY);
+    M6502_Jit_AluRegister(jit, M6502_JIT_OR, M6502_JIT_P, M6502_JIT_RDX);
+
+    M6502_Jit_MovRegister(jit, M6502_JIT_RAX, reg);
+    M6502_Jit_AluRegister(jit, M6502_JIT_SUB, M6502_JIT_RAX, M6502_JIT_RCX);
+    M6502_Jit_AluImmediate(jit, M6502_JIT_AND, M6502_JIT_RAX, 0xFFu);
+    M6502_Jit_SetNZ(jit, M6502_JIT_RAX);
+}
+
+static void M6502_Jit_AddWithCarry(M6502_Jit_t *jit)
+{
+    /* Binary mode only, ecx holds the operand (complemented for SBC). */
+    M6502_Jit_MovRegister(jit, M6502_JIT_RAX, M6502_JIT_P);
+    M6502_Jit_AluImmediate(jit, M6502_JIT_AND, M6502_JIT_RAX, M6502_FLAG_CARRY);
+    M6502_Jit_AluRegister(jit, M6502_JIT_ADD, M6502_JIT_RAX, M6502_JIT_A);
+    M6502_Jit_AluRegister(jit, M6502_JIT_ADD, M6502_JIT_RAX, M6502_JIT_RCX);
+
+    M6502_Jit_MovRegister(jit, M6502_JIT_RDX, M6502_JIT_RAX);
+    M6502_Jit_AluRegister(jit, M6502_JIT_XOR, M6502_JIT_RDX, M6502_JIT_A);
+    M6502_Jit_MovRegister(jit, M6502_JIT_RSI, M6502_JIT_RAX);
+    M6502_Jit_AluRegister(jit, M6502_JIT_XOR, M6502_JIT_RSI, M6502_JIT_RCX);
+    M6502_Jit_AluRegister(jit, M6502_JIT_AND, M6502_JIT_RDX, M6502_JIT_RSI);
+    M6502_Jit_AluImmediate(jit, M6502_JIT_AND, M6502_JIT_RDX, 0x80u);
+    M6502_Jit_Shift(jit, M6502_JIT_SHR, M6502_JIT_RDX, 1u);
+
+    M6502_Jit_AluImmediate(jit, M6502_JIT_AND, M6502_JIT_P,
+        (uint8_t)~(M6502_FLAG_NEGATIVE | M6502_FLAG_OVERFLOW | M6502_FLAG_ZERO | M6502_FLAG_CARRY));
+    M6502_Jit_AluRegister(jit, M6502_JIT_OR, M6502_JIT_P, M6502_JIT_RDX);
+
+    M6502_Jit_MovRegister(jit, M6502_JIT_RDX, M6502_JIT_RAX);
+    M6502_Jit_Shift(jit, M6502_JIT_SHR, M6502_JIT_RDX, 8u);
+    M6502_Jit_AluRegister(jit, M6502_JIT_OR, M6502_JIT_P, M6502_JIT_RDX);
+
+    M6502_Jit_AluImmediate(jit, M6502_JIT_AND, M6502_JIT_RAX, 0xFFu);
+    M6502_Jit_MovRegister(jit, M6502_JIT_A, M6502_JIT_RAX);
+    M6502_Jit_SetNZ(jit, M6502_JIT_A);
+}
+
+static void M6502_Jit_Shifter(M6502_Jit_t *jit, const uint8_t instruction)
+{
+    /* Value in ecx, result back in ecx, eax is left alone. */
+    const uint8_t rotate = (instruction == M6502_Instruction_ROL) || (instruction == M6502_Instruction_ROR);
+    const uint8_t left   = (instruction == M6502_Instruction_ASL) || (instruction == M6502_Instruction_ROL);
+
+    if (rotate)
+    {
+        M6502_Jit_MovRegister(jit, M6502_JIT_RSI, M6502_JIT_P);
+        M6502_Jit_AluImmediate(jit, M6502_JIT_AND, M6502_JIT_RSI, M6502_FLAG_CARRY);
+
+        if (!left)
+        {
+            M6502_Jit_Shift(jit, M6502_JIT_SHL, M6502_JIT_RSI, 7u);
+        }
+    }
+
+    M6502_Jit_MovRegister(jit, M6502_JIT_RDX, M6502_JIT_RCX);
+
+    if (left)
+    {
+        M6502_Jit_Shift(jit, M6502_JIT_SHR, M6502_JIT_RDX, 7u);
+    }
+    else
+    {
+        M6502_Jit_AluImmediate(jit, M6502_JIT_AND, M6502_JIT_RDX, 0x01u);
+    }
+
+    M6502_Jit_AluImmediate(jit, M6502_JIT_AND, M6502_JIT_P, (uint8_t)~M6502_FLAG_CARRY);
+    M6502_Jit_AluRegister(jit, M6502_JIT_OR, M6502_JIT_P, M6502_JIT_RDX);
+
+    M6502_Jit_Shift(jit, left ? M6502_JIT_SHL : M6502_JIT_SHR, M6502_JIT_RCX, 1u);
+
+    if (rotate)
+    {
+        M6502_Jit_AluRegister(jit, M6502_JIT_OR, M6502_JIT_RCX, M6502_JIT_RSI);
+    }
+
+    M6502_Jit_AluImmediate(jit, M6502_JIT_AND, M6502_JIT_RCX, 0xFFu);
+    M6502_Jit_SetNZ(jit, M6502_JIT_RCX);
+}
+
+static void M6502_Jit_Modify(M6502_Jit_t *jit, const uint8_t instruction)
+{
+    switch (instruction)
+    {
+        case M6502_Instruction_INC:
+            M6502_Jit_AluImmediate(jit, M6502_JIT_ADD, M6502_JIT_RCX, 1u);
+            M6502_Jit_AluImmediate(jit, M6502_JIT_AND, M6502_JIT_RCX, 0xFFu);
+            M6502_Jit_SetNZ(jit, M6502_JIT_RCX);
+            break;
+
+        case M6502_Instruction_DEC:
+            M6502_Jit_AluImmediate(jit, M6502_JIT_SUB, M6502_JIT_RCX, 1u);
+            M6502_Jit_AluImmediate(jit, M6502_JIT_AND, M6502_JIT_RCX, 0xFFu);
+            M6502_Jit_SetNZ(jit, M6502_JIT_RCX);
+            break;
+
+        default:
+            M6502_Jit_Shifter(jit, instruction);
+            break;
+    }
+}
+
+static void M6502_Jit_Step(M6502_Jit_t *jit, const uint8_t reg, const uint8_t operation)
+{
+    M6502_Jit_AluImmediate(jit, operation, reg, 1u);
+    M6502_Jit_AluImmediate(jit, M6502_JIT_AND, reg, 0xFFu);
+    M6502_Jit_SetNZ(jit, reg);
+}
+
+static void M6502_Jit_Transfer(M6502_Jit_t *jit, const uint8_t destination, const uint8_t source)
+{
+    M6502_Jit_MovRegister(jit, destination, source);
+    M6502_Jit_SetNZ(jit, destination);
+}
+
+static void M6502_Jit_Flag(M6502_Jit_t *jit, const uint8_t flag, const uint8_t value)
+{
+    if (value)  M6502_Jit_AluImmediate(jit, M6502_JIT_OR, M6502_JIT_P, flag);
+    else        M6502_Jit_AluImmediate(jit, M6502_JIT_AND, M6502_JIT_P, (uint8_t)~flag);
+}
+
+static void M6502_Jit_Push(M6502_Jit_t *jit)
+{
+    /* Value in ecx. */
+    M6502_Jit_MovRegister(jit, M6502_JIT_RAX, M6502_JIT_S);
+    M6502_Jit_AluImmediate(jit, M6502_JIT_OR, M6502_JIT_RAX, M6502_STACK_ADDRESS);
+    M6502_Jit_WriteDynamic(jit, (int16_t)(M6502_STACK_ADDRESS >> 8u), 0u);
+    M6502_Jit_AluImmediate(jit, M6502_JIT_SUB, M6502_JIT_S, 1u);
+    M6502_Jit_AluImmediate(jit, M6502_JIT_AND, M6502_JIT_S, 0xFFu);
+}
+
+static void M6502_Jit_Pull(M6502_Jit_t *jit)
+{
+    /* Value to ecx. */
+    M6502_Jit_MovRegister(jit, M6502_JIT_RAX, M6502_JIT_S);
+    M6502_Jit_AluImmediate(jit, M6502_JIT_OR, M6502_JIT_RAX, M6502_STACK_ADDRESS);
+    M6502_Jit_DummyDynamic(jit, (int16_t)(M6502_STACK_ADDRESS >> 8u));
+    M6502_Jit_AluImmediate(jit, M6502_JIT_ADD, M6502_JIT_S, 1u);
+    M6502_Jit_AluImmediate(jit, M6502_JIT_AND, M6502_JIT_S, 0xFFu);
+    M6502_Jit_MovRegister(jit, M6502_JIT_RAX, M6502_JIT_S);
+    M6502_Jit_AluImmediate(jit, M6502_JIT_OR, M6502_JIT_RAX, M6502_STACK_ADDRESS);
+    M6502_Jit_ReadDynamic(jit, (int16_t)(M6502_STACK_ADDRESS >> 8u));
+}
+
+static void M6502_Jit_Goto(M6502_Jit_t *jit, const uint8_t cycles, const uint16_t target)
+{
+    jit->terminated = 1u;
+
+    M6502_Jit_AluMemoryImmediate(jit, M6502_JIT_SUB, M6502_JIT_RSP, M6502_JIT_SLOT_REMAINING, cycles);
+
+    if (target != jit->block->start)
+    {
+        M6502_Jit_Exit(jit, M6502_JIT_ALWAYS, target);
+        return;
+    }
+
+    /* Tight loops stay in native code until the budget or an interrupt stops them. */
+    M6502_Jit_Exit(jit, M6502_JIT_CC_LE, target);
+    M6502_Jit_ExitOnAttention(jit, target);
+    M6502_Jit_Link(M6502_Jit_Branch(jit, M6502_JIT_ALWAYS), jit->body);
+}
+
+static void M6502_Jit_Conditional(M6502_Jit_t *jit, const M6502_MicroOp_t *op, const uint8_t flag, const uint8_t set)
+{
+    const uint16_t target = op->next + (uint16_t)(int8_t)op->operand;
+    uint8_t cycles = op->cycles + 1u;
+
+    M6502_Jit_TestImmediate(jit, M6502_JIT_P, flag);
+    uint8_t *notTaken = M6502_Jit_Branch(jit, set ? M6502_JIT_CC_E : M6502_JIT_CC_NE);
+
+    M6502_Jit_DummyStatic(jit, op->next);
+
+    if ((target & 0xFF00u) != (op->next & 0xFF00u))
+    {
+        M6502_Jit_DummyStatic(jit, target);
+        cycles++;
+    }
+
+    M6502_Jit_Goto(jit, cycles, target);
+
+    M6502_Jit_Link(notTaken, jit->cursor);
+    M6502_Jit_AluMemoryImmediate(jit, M6502_JIT_SUB, M6502_JIT_RSP, M6502_JIT_SLOT_REMAINING, op->cycles);
+    M6502_Jit_Exit(jit, M6502_JIT_ALWAYS, op->next);
+}
+
+static void M6502_Jit_Instruction(M6502_Jit_t *jit, const M6502_MicroOp_t *op)
+{
+    const M6502_OpcodeInfo_t *info = &M6502_OPCODE_INFO[op->opcode];
+    const uint8_t instruction = info->instruction;
+    const uint8_t accumulator = (info->addressMode == M6502_AddressMode_Accumulator);
+    const uint8_t implied     = (info->addressMode == M6502_AddressMode_Implied) || accumulator;
+
+    uint8_t *start = jit->cursor;
+    int16_t page;
+
+    jit->mayInvalidate = 0u;
+
+    if (implied)
+    {
+        M6502_Jit_DummyStatic(jit, op->next);
+    }
+
+    switch (instruction)
+    {
+        case M6502_Instruction_ADC:
+        case M6502_Instruction_SBC:
+#ifndef M6502_NES_CPU
+        {
+            /* Decimal mode stays with the interpreter. */
+            M6502_Jit_TestImmediate(jit, M6502_JIT_P, M6502_FLAG_DECIMAL);
+            uint8_t *binary = M6502_Jit_Branch(jit, M6502_JIT_CC_E);
+            M6502_Jit_Fallback(jit, op, 1u);
+            M6502_Jit_Link(binary, jit->cursor);
+        }
+#endif
+            M6502_Jit_Operand(jit, op, info);
+
+            if (instruction == M6502_Instruction_SBC)
+            {
+                M6502_Jit_AluImmediate(jit, M6502_JIT_XOR, M6502_JIT_RCX, 0xFFu);
+            }
+
+            M6502_Jit_AddWithCarry(jit);
+            break;
+
+        case M6502_Instruction_LDA:
+        case M6502_Instruction_LAX:
+            M6502_Jit_Operand(jit, op, info);
+            M6502_Jit_MovRegister(jit, M6502_JIT_A, M6502_JIT_RCX);
+
+            if (instruction == M6502_Instruction_LAX)
+            {
+                M6502_Jit_MovRegister(jit, M6502_JIT_X, M6502_JIT_RCX);
+            }
+
+            M6502_Jit_SetNZ(jit, M6502_JIT_A);
+            break;
+
+        case M6502_Instruction_LDX:
+            M6502_Jit_Operand(jit, op, info);
+            M6502_Jit_Transfer(jit, M6502_JIT_X, M6502_JIT_RCX);
+            break;
+
+        case M6502_Instruction_LDY:
+            M6502_Jit_Operand(jit, op, info);
+            M6502_Jit_Transfer(jit, M6502_JIT_Y, M6502_JIT_RCX);
+            break;
+
+        case M6502_Instruction_AND:
+        case M6502_Instruction_ORA:
+        case M6502_Instruction_EOR:
+            M6502_Jit_Operand(jit, op, info);
+            M6502_Jit_AluRegister(jit,
+                (instruction == M6502_Instruction_AND) ? M6502_JIT_AND :
+                (instruction == M6502_Instruction_ORA) ? M6502_JIT_OR : M6502_JIT_XOR,
+                M6502_JIT_A, M6502_JIT_RCX);
+            M6502_Jit_SetNZ(jit, M6502_JIT_A);
+            break;
+
+        case M6502_Instruction_CMP:
+            M6502_Jit_Operand(jit, op, info);
+            M6502_Jit_Compare(jit, M6502_JIT_A);
+            break;
+
+        case M6502_Instruction_CPX:
+            M6502_Jit_Operand(jit, op, info);
+            M6502_Jit_Compare(jit, M6502_JIT_X);
+            break;
+
+        case M6502_Instruction_CPY:
+            M6502_Jit_Operand(jit, op, info);
+            M6502_Jit_Compare(jit, M6502_JIT_Y);
+            break;
+
+        case M6502_Instruction_BIT:
+            M6502_Jit_Operand(jit, op, info);
+            M6502_Jit_AluImmediate(jit, M6502_JIT_AND, M6502_JIT_P,
+                (uint8_t)~(M6502_FLAG_NEGATIVE | M6502_FLAG_OVERFLOW | M6502_FLAG_ZERO));
+            M6502_Jit_MovRegister(jit, M6502_JIT_RDX, M6502_JIT_RCX);
+            M6502_Jit_AluImmediate(jit, M6502_JIT_AND, M6502_JIT_RDX, M6502_FLAG_NEGATIVE | M6502_FLAG_OVERFLOW);
+            M6502_Jit_AluRegister(jit, M6502_JIT_OR, M6502_JIT_P, M6502_JIT_RDX);
+            M6502_Jit_TestRegister(jit, M6502_JIT_RCX, M6502_JIT_A);
+            M6502_Jit_SetCondition(jit, M6502_JIT_CC_E, M6502_JIT_RDX);
+            M6502_Jit_Shift(jit, M6502_JIT_SHL, M6502_JIT_RDX, 1u);
+            M6502_Jit_AluRegister(jit, M6502_JIT_OR, M6502_JIT_P, M6502_JIT_RDX);
+            break;
+
+        case M6502_Instruction_NOP:
+            if (!implied)
+            {
+                M6502_Jit_Operand(jit, op, info);
+            }
+            break;
+
+        case M6502_Instruction_STA:
+        case M6502_Instruction_STX:
+        case M6502_Instruction_STY:
+        case M6502_Instruction_SAX:
+            page = M6502_Jit_Address(jit, op, info);
+
+            switch (instruction)
+            {
+                case M6502_Instruction_STA: M6502_Jit_MovRegister(jit, M6502_JIT_RCX, M6502_JIT_A); break;
+                case M6502_Instruction_STX: M6502_Jit_MovRegister(jit, M6502_JIT_RCX, M6502_JIT_X); break;
+                case M6502_Instruction_STY: M6502_Jit_MovRegister(jit, M6502_JIT_RCX, M6502_JIT_Y); break;
+                default:
+                    M6502_Jit_MovRegister(jit, M6502_JIT_RCX, M6502_JIT_A);
+                    M6502_Jit_AluRegister(jit, M6502_JIT_AND, M6502_JIT_RCX, M6502_JIT_X);
+                    break;
+            }
+
+            M6502_Jit_WriteDynamic(jit, page, 0u);
+            break;
+
+        case M6502_Instruction_INC:
+        case M6502_Instruction_DEC:
+        case M6502_Instruction_ASL:
+        case M6502_Instruction_LSR:
+        case M6502_Instruction_ROL:
+        case M6502_Instruction_ROR:
+            if (accumulator)
+            {
+                M6502_Jit_MovRegister(jit, M6502_JIT_RCX, M6502_JIT_A);
+                M6502_Jit_Modify(jit, instruction);
+                M6502_Jit_MovRegister(jit, M6502_JIT_A, M6502_JIT_RCX);
+                break;
+            }
+
+            page = M6502_Jit_Address(jit, op, info);
+            M6502_Jit_ReadDynamic(jit, page);
+            M6502_Jit_StoreDword(jit, M6502_JIT_RSP, M6502_JIT_SLOT_OLD, M6502_JIT_RCX);
+            M6502_Jit_Modify(jit, instruction);
+            M6502_Jit_WriteDynamic(jit, page, 1u);
+            break;
+
+        case M6502_Instruction_INX: M6502_Jit_Step(jit, M6502_JIT_X, M6502_JIT_ADD); break;
+        case M6502_Instruction_INY: M6502_Jit_Step(jit, M6502_JIT_Y, M6502_JIT_ADD); break;
+        case M6502_Instruction_DEX: M6502_Jit_Step(jit, M6502_JIT_X, M6502_JIT_SUB); break;
+        case M6502_Instruction_DEY: M6502_Jit_Step(jit, M6502_JIT_Y, M6502_JIT_SUB); break;
+
+        case M6502_Instruction_TAX: M6502_Jit_Transfer(jit, M6502_JIT_X, M6502_JIT_A); break;
+        case M6502_Instruction_TAY: M6502_Jit_Transfer(jit, M6502_JIT_Y, M6502_JIT_A); break;
+        case M6502_Instruction_TXA: M6502_Jit_Transfer(jit, M6502_JIT_A, M6502_JIT_X); break;
+        case M6502_Instruction_TYA: M6502_Jit_Transfer(jit, M6502_JIT_A, M6502_JIT_Y); break;
+        case M6502_Instruction_TSX: M6502_Jit_Transfer(jit, M6502_JIT_X, M6502_JIT_S); break;
+        case M6502_Instruction_TXS: M6502_Jit_MovRegister(jit, M6502_JIT_S, M6502_JIT_X); break;
+
+        case M6502_Instruction_CLC: M6502_Jit_Flag(jit, M6502_FLAG_CARRY, 0u);     break;
+        case M6502_Instruction_SEC: M6502_Jit_Flag(jit, M6502_FLAG_CARRY, 1u);     break;
+        case M6502_Instruction_CLD: M6502_Jit_Flag(jit, M6502_FLAG_DECIMAL, 0u);   break;
+        case M6502_Instruction_SED: M6502_Jit_Flag(jit, M6502_FLAG_DECIMAL, 1u);   break;
+        case M6502_Instruction_CLI: M6502_Jit_Flag(jit, M6502_FLAG_INTERRUPT, 0u); break;
+        case M6502_Instruction_SEI: M6502_Jit_Flag(jit, M6502_FLAG_INTERRUPT, 1u); break;
+        case M6502_Instruction_CLV: M6502_Jit_Flag(jit, M6502_FLAG_OVERFLOW, 0u);  break;
+
+        case M6502_Instruction_PHA:
+            M6502_Jit_MovRegister(jit, M6502_JIT_RCX, M6502_JIT_A);
+            M6502_Jit_Push(jit);
+            break;
+
+        case M6502_Instruction_PHP:
+            M6502_Jit_MovRegister(jit, M6502_JIT_RCX, M6502_JIT_P);
+            M6502_Jit_AluImmediate(jit, M6502_JIT_OR, M6502_JIT_RCX, M6502_FLAG_BREAK);
+            M6502_Jit_Push(jit);
+            break;
+
+        case M6502_Instruction_PLA:
+            M6502_Jit_Pull(jit);
+            M6502_Jit_Transfer(jit, M6502_JIT_A, M6502_JIT_RCX);
+            break;
+
+        case M6502_Instruction_PLP:
+            M6502_Jit_Pull(jit);
+            M6502_Jit_MovRegister(jit, M6502_JIT_P, M6502_JIT_RCX);
+            M6502_Jit_AluImmediate(jit, M6502_JIT_OR, M6502_JIT_P, M6502_FLAG_UNUSED);
+            break;
+
+        case M6502_Instruction_BPL: M6502_Jit_Conditional(jit, op, M6502_FLAG_NEGATIVE, 0u); return;
+        case M6502_Instruction_BMI: M6502_Jit_Conditional(jit, op, M6502_FLAG_NEGATIVE, 1u); return;
+        case M6502_Instruction_BVC: M6502_Jit_Conditional(jit, op, M6502_FLAG_OVERFLOW, 0u); return;
+        case M6502_Instruction_BVS: M6502_Jit_Conditional(jit, op, M6502_FLAG_OVERFLOW, 1u); return;
+        case M6502_Instruction_BCC: M6502_Jit_Conditional(jit, op, M6502_FLAG_CARRY, 0u);    return;
+        case M6502_Instruction_BCS: M6502_Jit_Conditional(jit, op, M6502_FLAG_CARRY, 1u);    return;
+        case M6502_Instruction_BNE: M6502_Jit_Conditional(jit, op, M6502_FLAG_ZERO, 0u);     return;
+        case M6502_Instruction_BEQ: M6502_Jit_Conditional(jit, op, M6502_FLAG_ZERO, 1u);     return;
+
+        case M6502_Instruction_JMP:
+            if (info->addressMode == M6502_AddressMode_Absolute)
+            {
+                M6502_Jit_Goto(jit, op->cycles, op->operand);
+                return;
+            }
+            /* fall through */
+
+        default:
+            /* The handler does its own dummy read. */
+            jit->cursor         = start;
+            jit->terminated     = M6502_BlockCache_EndsBlock(op->opcode);
+
+            M6502_Jit_Fallback(jit, op, jit->terminated);
+            return;
+    }
+
+    M6502_Jit_EndInstruction(jit, op->cycles, op->next);
+}
+
+static uint8_t M6502_Jit_Emit(M6502_Jit_t *jit)
+{
+    const M6502_Block_t *block = jit->block;
+
+    M6502_Jit_Prologue(jit);
+    jit->body = jit->cursor;
+
+    for (uint8_t index = 0u; index < block->length; ++index)
+    {
+        if ((uint32_t)(jit->end - jit->cursor) < M6502_JIT_OP_SPACE)
+        {
+            return 0u;
+        }
+
+        M6502_Jit_Instruction(jit, &block->ops[index]);
+    }
+
+    if (!jit->terminated)
+    {
+        M6502_Jit_Exit(jit, M6502_JIT_ALWAYS, block->ops[block->length - 1u].next);
+    }
+
+    /* Exit stubs: store the program counter, then share the epilogue. */
+    if ((uint32_t)(jit->end - jit->cursor) < (jit->exitCount * 16u))
+    {
+        return 0u;
+    }
+
+    uint8_t *stubs[sizeof(jit->exits) / sizeof(jit->exits[0])];
+
+    for (uint16_t index = 0u; index < jit->exitCount; ++index)
+    {
+        const M6502_JitExit_t *exit = &jit->exits[index];
+
+        stubs[index] = NULL;
+
+        for (uint16_t previous = 0u; previous < index; ++previous)
+        {
+            if (jit->exits[previous].programCounter == exit->programCounter)
+            {
+                stubs[index] = stubs[previous];
+                break;
+            }
+        }
+
+        if (stubs[index] == NULL)
+        {
+            stubs[index] = jit->cursor;
+
+            if (exit->programCounter != M6502_JIT_KEEP_PC)
+            {
+                M6502_Jit_StoreWordImmediate(jit, M6502_JIT_CPU, (int32_t)offsetof(M6502_t, programCounter),
+                    (uint16_t)exit->programCounter);
+            }
+
+            M6502_Jit_Link(M6502_Jit_Branch(jit, M6502_JIT_ALWAYS), jit->epilogue);
+        }
+
+        M6502_Jit_Link(exit->patch, stubs[index]);
+    }
+
+    return 1u;
+}
+
+static void M6502_Jit_Flush(M6502_BlockCache_t *cache)
+{
+    for (uint16_t index = 0u; index < M6502_BLOCK_CACHE_SIZE; ++index)
+    {
+        cache->blocks[index].native = NULL;
+        cache->blocks[index].hits   = 0u;
+    }
+
+    cache->codeUsed = cache->codeStart;
+}
+
+/* On failure the code space can not be trusted, so the cache gives up on native code for good. */
+static uint8_t M6502_Jit_Protect(M6502_BlockCache_t *cache, const int protection)
+{
+    if (mprotect(cache->code, M6502_JIT_CODE_SIZE, protection) == 0)
+    {
+        return 1u;
+    }
+
+    M6502_Jit_Flush(cache);
+    cache->codeFailed = 1u;
+    return 0u;
+}
+
+/* The code space is writable only while a block is emitted and executable only outside of it. */
+static void M6502_Jit_Compile(M6502_t *cpu, M6502_Block_t *block)
+{
+    M6502_BlockCache_t *cache = cpu->blockCache;
+    M6502_Jit_t jit;
+
+    jit.cache       = cache;
+    jit.readPages   = cpu->readPages;
+    jit.writePages  = cpu->writePages;
+#ifdef M6502_SIDE_EFFECT_FREE
+    jit.sideEffectFree  = cpu->sideEffectFree;
+#else
+    jit.sideEffectFree  = NULL;
+#endif
+    jit.block       = block;
+
+    if (cache->code == NULL)
+    {
+        void *code = mmap(NULL, M6502_JIT_CODE_SIZE, PROT_READ | PROT_WRITE,
+            MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+        if (code == MAP_FAILED)
+        {
+            /* No memory for native code: stay on the block interpreter from now on. */
+            cache->codeFailed = 1u;
+            return;
+        }
+
+        cache->code = (uint8_t *)code;
+
+        jit.cursor  = cache->code;
+        jit.end     = cache->code + M6502_JIT_CODE_SIZE;
+
+        M6502_Jit_Epilogue(&jit);
+
+        cache->codeStart    = (uint32_t)(jit.cursor - cache->code);
+        cache->codeUsed     = cache->codeStart;
+    }
+    else if (!M6502_Jit_Protect(cache, PROT_READ | PROT_WRITE))
+    {
+        return;
+    }
+
+    for (uint8_t attempt = 0u; attempt < 2u; ++attempt)
+    {
+        jit.cursor          = cache->code + cache->codeUsed;
+        jit.end             = cache->code + M6502_JIT_CODE_SIZE;
+        jit.epilogue        = cache->code;
+        jit.exitCount       = 0u;
+        jit.terminated      = 0u;
+        jit.mayInvalidate   = 0u;
+
+        uint8_t *entry = jit.cursor;
+
+        if (M6502_Jit_Emit(&jit))
+        {
+            cache->codeUsed = (uint32_t)(jit.cursor - cache->code);
+
+            if (M6502_Jit_Protect(cache, PROT_READ | PROT_EXEC))
+            {
+                memcpy(&block->native, &entry, sizeof(block->native));
+            }
+            return;
+        }
+
+        /* Out of code space: drop every compiled block and start over. */
+        M6502_Jit_Flush(cache);
+    }
+
+    (void)M6502_Jit_Protect(cache, PROT_READ | PROT_EXEC);
+}
+#endif
+
+#ifdef M6502_DECIMAL_TABLE
+/* Indexed by (carry << 16) | (A << 8) | operand: result in the low byte, N/V/Z/C in the high byte. */
+static uint16_t M6502_DECIMAL_ADC[0x20000];
+static uint16_t M6502_DECIMAL_SBC[0x20000];
+/* Set with release once the tables are filled; the first M6502_Init to claim them fills them. */
+static uint8_t  M6502_DecimalReady = 0u;
+static uint8_t  M6502_DecimalClaimed = 0u;
+
+static const uint8_t M6502_DECIMAL_FLAGS = 0xC3u;
+
+static void M6502_DecimalTable_Build(void)
+{
+    M6502_t scratch;
+
+    /* Replays the step-by-step arithmetic once, so both paths agree on every case. */
+    for (uint32_t index = 0u; index < 0x20000u; ++index)
+    {
+        const uint8_t status = M6502_FLAG_DECIMAL | (uint8_t)(index >> 16u);
+
+        M6502_UnpackStatus(&scratch, status);
+        scratch.accumulator = (uint8_t)(index >> 8u);
+        scratch.target      = (uint8_t)index;
+        M6502_Opcode_ADC(&scratch);
+
+        M6502_DECIMAL_ADC[index] = (uint16_t)(((M6502_PackStatus(&scratch) & M6502_DECIMAL_FLAGS) << 8u) | scratch.accumulator);
+
+        M6502_UnpackStatus(&scratch, status);
+        scratch.accumulator = (uint8_t)(index >> 8u);
+        scratch.target      = (uint8_t)index;
+        M6502_Opcode_SBC(&scratch);
+
+        M6502_DECIMAL_SBC[index] = (uint16_t)(((M6502_PackStatus(&scratch) & M6502_DECIMAL_FLAGS) << 8u) | scratch.accumulator);
+    }
+
+    __atomic_store_n(&M6502_DecimalReady, 1u, __ATOMIC_RELEASE);
+}
+
+/* Safe to call from several threads at once: one builds, the others wait for it. */
+static void M6502_DecimalTable_Prepare(void)
+{
+    if (__atomic_load_n(&M6502_DecimalReady, __ATOMIC_ACQUIRE) != 0u)
+    {
+        return;
+    }
+
+    if (__atomic_exchange_n(&M6502_DecimalClaimed, 1u, __ATOMIC_ACQ_REL) == 0u)
+    {
+        M6502_DecimalTable_Build();
+        return;
+    }
+
+    while (__atomic_load_n(&M6502_DecimalReady, __ATOMIC_ACQUIRE) == 0u)
+    {
+        /* Another thread is filling the tables, a few milliseconds at most. */
+    }
+}
+
+static inline void M6502_DecimalTable_Apply(M6502_t *cpu, const uint16_t *table)
+{
+    const uint16_t entry = table[((uint32_t)M6502_GetFlag(cpu, M6502_FLAG_CARRY) << 16u)
+        | ((uint32_t)cpu->accumulator << 8u) | (cpu->target & 0x00FFu)];
+    const uint8_t flags = (uint8_t)(entry >> 8u);
+
+    cpu->accumulator = (uint8_t)(entry & 0x00FFu);
+
+    M6502_SetFlag(cpu, M6502_FLAG_NEGATIVE, flags & M6502_FLAG_NEGATIVE);
+    M6502_SetFlag(cpu, M6502_FLAG_OVERFLOW, flags & M6502_FLAG_OVERFLOW);
+    M6502_SetFlag(cpu, M6502_FLAG_ZERO,     flags & M6502_FLAG_ZERO);
+    M6502_SetFlag(cpu, M6502_FLAG_CARRY,    flags & M6502_FLAG_CARRY);
+}
+#endif
+
+#ifdef M6502_SCHEDULER
+/* Equal deadlines keep the order the events were scheduled in. */
+static inline uint8_t M6502_Scheduler_Before(const M6502_t *cpu, const uint8_t first, const uint8_t second)
+{
+    const M6502_Event_t *a = &cpu->events[cpu->eventHeap[first]];
+    const M6502_Event_t *b = &cpu->events[cpu->eventHeap[second]];
+
+    if (a->when != b->when)
+    {
+        return (a->when < b->when) ? 1u : 0u;
+    }
+
+    return ((int32_t)(a->sequence - b->sequence) < 0) ? 1u : 0u;
+}
+
+static void M6502_Scheduler_Swap(M6502_t *cpu, const uint8_t first, const uint8_t second)
+{
+    const uint8_t slot = cpu->eventHeap[first];
+
+    cpu->eventHeap[first]   = cpu->eventHeap[second];
+    cpu->eventHeap[second]  = slot;
+
+    cpu->events[cpu->eventHeap[first]].position     = first;
+    cpu->events[cpu->eventHeap[second]].position    = second;
+}
+
+/* Moves the entry at position up or down until the heap is ordered again. */
+static void M6502_Scheduler_Sift(M6502_t *cpu, uint8_t position)
+{
+    while ((position > 0u) && M6502_Scheduler_Before(cpu, position, (uint8_t)((position - 1u) / 2u)))
+    {
+        M6502_Scheduler_Swap(cpu, position, (uint8_t)((position - 1u) / 2u));
+        position = (uint8_t)((position - 1u) / 2u);
+    }
+
+    for (;;)
+    {
+        const uint32_t left     = 2u * position + 1u;
+        const uint32_t right    = left + 1u;
+        uint8_t earliest        = position;
+
+        if ((left < cpu->eventCount) && M6502_Scheduler_Before(cpu, (uint8_t)left, earliest))
+        {
+            earliest = (uint8_t)left;
+        }
+
+        if ((right < cpu->eventCount) && M6502_Scheduler_Before(cpu, (uint8_t)right, earliest))
+        {
+            earliest = (uint8_t)right;
+        }
+
+        if (earliest == position)
+        {
+            return;
+        }
+
+        M6502_Scheduler_Swap(cpu, position, earliest);
+        position = earliest;
+    }
+}
+
+static void M6502_Scheduler_Remove(M6502_t *cpu, const uint8_t position)
+{
+    cpu->events[cpu->eventHeap[position]].callback = NULL;
+
+    if (position != --cpu->eventCount)
+    {
+        M6502_Scheduler_Swap(cpu, position, cpu->eventCount);
+        M6502_Scheduler_Sift(cpu, position);
+    }
+}
+
+/* Callbacks run after the instruction that reaches their deadline and may schedule again. */
+static inline void M6502_Scheduler_Fire(M6502_t *cpu)
+{
+    while ((cpu->eventCount != 0u) && (cpu->events[cpu->eventHeap[0]].when <= cpu->totalCycles))
+    {
+        const M6502_Event_t event = cpu->events[cpu->eventHeap[0]];
+
+        M6502_Scheduler_Remove(cpu, 0u);
+        event.callback(cpu, event.context);
+    }
+}
+#endif
+
+void M6502_Init(M6502_t *cpu)
+{
+    cpu->programCounter = 0x0000u;
+    cpu->xRegister      = 0x00u;
+    cpu->yRegister      = 0x00u;
+    cpu->accumulator    = 0x00u;
+    cpu->stackPointer   = 0x00u;
+    M6502_UnpackStatus(cpu, 0x00u);
+    cpu->cycles         = 0u;
+    cpu->opcode         = 0x00u;
+    cpu->address        = 0x0000u;
+    cpu->target         = 0x0000u;
+    cpu->totalCycles    = 0u;
+    cpu->irqLines       = 0u;
+    cpu->nmiLine        = 0u;
+#ifdef M6502_ATOMIC
+    cpu->requests       = 0u;
+#endif
+#ifdef M6502_STALL
+    cpu->stallCycles    = 0u;
+    cpu->stallAlign     = 0u;
+#endif
+#ifdef M6502_PINS
+    cpu->pins           = 0u;
+    cpu->pinBase        = 0x0000u;
+    cpu->pinQueueHead   = 0u;
+    cpu->pinQueueCount  = 0u;
+    cpu->pinCycle       = 0u;
+    cpu->pinStep        = 0u;
+    cpu->pinInterrupt   = 0u;
+    cpu->pinTicking     = 0u;
+    cpu->pinResult      = 0u;
+    cpu->pinNmi         = 0u;
+#endif
+#ifdef M6502_BLOCK_CACHE
+    cpu->blockCache     = NULL;
+#endif
+#ifdef M6502_HLE
+    memset(cpu->trapMap, 0, sizeof(cpu->trapMap));
+    memset(cpu->traps, 0, sizeof(cpu->traps));
+#endif
+#ifdef M6502_SCHEDULER
+    memset(cpu->events, 0, sizeof(cpu->events));
+    cpu->eventCount     = 0u;
+    cpu->eventSequence  = 0u;
+#endif
+#ifdef M6502_PAGE_TABLE
+    memset(cpu->readPages, 0, sizeof(cpu->readPages));
+    memset(cpu->writePages, 0, sizeof(cpu->writePages));
+#endif
+#ifdef M6502_SIDE_EFFECT_FREE
+    memset(cpu->sideEffectFree, 0, sizeof(cpu->sideEffectFree));
+#endif
+#ifdef M6502_IDLE_SKIP
+    cpu->idleTarget     = 0x0000u;
+    cpu->idleJump       = 0x0000u;
+    cpu->idleCycles     = 0u;
+    cpu->idleValid      = 0u;
+    memset(cpu->idleState, 0, sizeof(cpu->idleState));
+    memset(cpu->idleSafe, 0, sizeof(cpu->idleSafe));
+#endif
+#if defined(M6502_PAGE_TABLE) && defined(M6502_FLAT_MEMORY)
+    M6502_MapMemory(cpu, 0x0000u, 0x10000u, cpu->memory, 0u);
+#endif
+
+#ifdef M6502_DECIMAL_TABLE
+    M6502_DecimalTable_Prepare();
+#endif
+
+    M6502_Reset(cpu);
+}
+
+void M6502_Reset(M6502_t *cpu)
+{
+    cpu->programCounter     = M6502_ReadMemoryWord(cpu, M6502_RESETVECTOR_ADDRESS);
+    cpu->stackPointer       = M6502_STACK_START_ADDRESS;
+    cpu->interruptFlags     = 0x00u;
+    /* Reset does not release the lines: a source still holding IRQ is seen again. */
+    cpu->pendingInterrupts  = (M6502_Lines_IRQ(cpu) != 0u) ? M6502_INTERRUPT_IRQ : 0x00u;
+    cpu->jammed             = 0x00u;
+#ifdef M6502_STALL
+    cpu->stallCycles        = 0u;
+    cpu->stallAlign         = 0u;
+#endif
+#ifdef M6502_PINS
+    cpu->pinCycle           = 0u;
+#endif
+    
+    M6502_SetFlag(cpu, M6502_FLAG_INTERRUPT, 1u);
+    M6502_SetFlag(cpu, M6502_FLAG_UNUSED, 1u);
+
+    cpu->cycles = 8u;
+}
+
+void M6502_IRQ(M6502_t *cpu)
+{
+    M6502_Raise(cpu, M6502_INTERRUPT_IRQ);
+}
+
+void M6502_NMI(M6502_t *cpu)
+{
+    M6502_Raise(cpu, M6502_INTERRUPT_NMI);
+}
+
+void M6502_SetIRQLine(M6502_t *cpu, const uint32_t sources, const uint8_t asserted)
+{
+#ifdef M6502_ATOMIC
+    const uint32_t previous = asserted
+        ? __atomic_fetch_or(&cpu->irqLines, sources, __ATOMIC_RELAXED)
+        : __atomic_fetch_and(&cpu->irqLines, ~sources, __ATOMIC_RELAXED);
+#else
+    const uint32_t previous = cpu->irqLines;
+
+    cpu->irqLines = asserted ? (previous | sources) : (previous & ~sources);
+#endif
+
+    const uint32_t lines = asserted ? (previous | sources) : (previous & ~sources);
+
+    if (lines != 0u)
+    {
+        M6502_Raise(cpu, M6502_INTERRUPT_IRQ);
+    }
+    else if (previous != 0u)
+    {
+        /* The last source let go: the IRQ is withdrawn, even one raised by M6502_IRQ. */
+#ifdef M6502_ATOMIC
+        M6502_Raise(cpu, M6502_REQUEST_RELEASE);
+#else
+        cpu->pendingInterrupts &= ~M6502_INTERRUPT_IRQ;
+#endif
+    }
+}
+
+void M6502_SetNMILine(M6502_t *cpu, const uint8_t asserted)
+{
+#ifdef M6502_ATOMIC
+    const uint8_t previous = __atomic_exchange_n(&cpu->nmiLine, asserted ? 1u : 0u, __ATOMIC_RELAXED);
+#else
+    const uint8_t previous = cpu->nmiLine;
+
+    cpu->nmiLine = asserted ? 1u : 0u;
+#endif
+
+    if (asserted && !previous)
+    {
+        M6502_Raise(cpu, M6502_INTERRUPT_NMI);
+    }
+}
+
+void M6502_RequestStop(M6502_t *cpu)
+{
+    M6502_Raise(cpu, M6502_ATTENTION_STOP);
+}
+
+/* One clock cycle of M6502_Step; an instruction runs whole on its first cycle. */
+static inline void M6502_Step_Cycle(M6502_t *cpu)
+{
+    if(cpu->cycles > 0u)
+    {
+        cpu->cycles--;
+        return;
+    }
+
+#ifdef M6502_ATOMIC
+    M6502_Requests_Take(cpu);
+#endif
+
+#ifdef M6502_STALL
+    if ((cpu->pendingInterrupts & M6502_ATTENTION_STALL) != 0u)
+    {
+        M6502_Stall_Skip(cpu, 0u, 1u);
+        return;
+    }
+#endif
+
+    if (cpu->jammed == 0xFFu)
+    {
+        M6502_DummyRead(cpu, M6502_JAMMED_ADDRESS);
+        return;
+    }
+
+    M6502_Execute(cpu);
+
+    /* This call is the first of its cycles, so an N-cycle instruction takes N calls. */
+    if (cpu->cycles > 0u)
+    {
+        cpu->cycles--;
+    }
+}
+
+void M6502_Step(M6502_t *cpu)
+{
+#ifdef M6502_SCHEDULER
+    M6502_Scheduler_Fire(cpu);
+#endif
+
+    M6502_Step_Cycle(cpu);
+
+    /* Counted after the cycle, as M6502_Run does, so deadlines and stall parity agree. */
+    cpu->totalCycles++;
+}
+
+#ifdef M6502_PINS
+/* After the opcode body: what is left needs no bus data, so it waits in the queue for the next ticks. */
+static uint8_t M6502_Pins_Access(M6502_t *cpu, const uint16_t address, const uint8_t value, const uint32_t read)
+{
+    const uint8_t slot = cpu->pinQueueCount;
+
+    if (slot < sizeof(cpu->pinQueueData))
+    {
+        cpu->pinQueueAddress[slot]  = address;
+        cpu->pinQueueData[slot]     = value;
+        cpu->pinQueueRead[slot]     = (read != 0u) ? 1u : 0u;
+        cpu->pinQueueCount++;
+    }
+
+    return 0x00u;
+}
+
+/* Puts the next access of the instruction on the pins, always one per tick. */
+static inline uint8_t M6502_Pins_Issue(M6502_t *cpu, const uint16_t address, const uint8_t value, const uint32_t read)
+{
+    cpu->pins &= (M6502_PIN_IRQ | M6502_PIN_NMI | M6502_PIN_RDY);
+    cpu->pins |= (uint32_t)address | read;
+
+    if (read == 0u)
+    {
+        cpu->pins = M6502_PINS_SET_DATA(cpu->pins, value);
+    }
+
+    cpu->pinCycle++;
+
+    return 1u;
+}
+
+static inline uint8_t M6502_Pins_Read(M6502_t *cpu, const uint16_t address)
+{
+    return M6502_Pins_Issue(cpu, address, 0x00u, M6502_PIN_RW);
+}
+
+static inline uint8_t M6502_Pins_Push(M6502_t *cpu, const uint8_t value)
+{
+    const uint16_t address = M6502_STACK_ADDRESS + cpu->stackPointer;
+
+    cpu->stackPointer = (cpu->stackPointer - 1u) & 0xFFu;
+
+    return M6502_Pins_Issue(cpu, address, value, 0u);
+}
+
+static inline uint8_t M6502_Pins_Pull(M6502_t *cpu)
+{
+    cpu->stackPointer = (cpu->stackPointer + 1u) & 0xFFu;
+
+    return M6502_Pins_Read(cpu, M6502_STACK_ADDRESS + cpu->stackPointer);
+}
+
+/* The page-cross fix-up of M6502_Util_PageCross: 1 when it takes a cycle. */
+static inline uint8_t M6502_Pins_PageCross(M6502_t *cpu, const uint16_t base, const uint8_t access)
+{
+    const uint16_t dummyAddress = (base & 0xFF00u) | (cpu->address & 0x00FFu);
+
+    if (access != M6502_Access_Read)
+    {
+        return M6502_Pins_Read(cpu, dummyAddress);
+    }
+
+    if ((base & 0xFF00u) != (cpu->address & 0xFF00u))
+    {
+        cpu->cycles++;
+        return M6502_Pins_Read(cpu, dummyAddress);
+    }
+
+    return 0u;
+}
+
+/*
+ * M6502_Address_* and M6502_Operand_Fetch one access per call, data being what the previous read
+ * brought back. Returns 0 once cpu->address and cpu->target are set, like the functions would leave them.
+ */
+static uint8_t M6502_Pins_Address(M6502_t *cpu, const uint8_t data)
+{
+    const M6502_OpcodeInfo_t *info = &M6502_OPCODE_INFO[cpu->opcode];
+    const uint8_t access    = info->access;
+    const uint8_t operand   = ((access == M6502_Access_Read) || (access == M6502_Access_Modify)) ? 1u : 0u;
+    uint8_t index           = cpu->xRegister;
+
+    switch (info->addressMode)
+    {
+        case M6502_AddressMode_Accumulator:
+            cpu->address    = cpu->accumulator;
+            cpu->target     = cpu->accumulator;
+            /* fall through */
+        case M6502_AddressMode_Implied:
+            return (cpu->pinStep++ == 0u) ? M6502_Pins_Read(cpu, cpu->programCounter) : 0u;
+
+        case M6502_AddressMode_Immediate:
+            if (cpu->pinStep++ == 0u)
+            {
+                return M6502_Pins_Read(cpu, cpu->programCounter++);
+            }
+
+            cpu->address    = cpu->programCounter - 1u;
+            cpu->target     = data;
+            return 0u;
+
+        case M6502_AddressMode_Relative:
+            if (cpu->pinStep++ == 0u)
+            {
+                return M6502_Pins_Read(cpu, cpu->programCounter++);
+            }
+
+            cpu->address = (data & 0x80u) ? ((uint16_t)data | 0xFF00u) : (uint16_t)data;
+            return 0u;
+
+        case M6502_AddressMode_ZeroPage:
+            switch (cpu->pinStep++)
+            {
+                case 0u:
+                    return M6502_Pins_Read(cpu, cpu->programCounter++);
+                case 1u:
+                    cpu->address = data;
+                    return operand ? M6502_Pins_Read(cpu, cpu->address) : 0u;
+                default:
+                    cpu->target = data;
+                    return 0u;
+            }
+
+        case M6502_AddressMode_ZeroPageY:
+            index = cpu->yRegister;
+            /* fall through */
+        case M6502_AddressMode_ZeroPageX:
+            switch (cpu->pinStep++)
+            {
+                case 0u:
+                    return M6502_Pins_Read(cpu, cpu->programCounter++);
+                case 1u:
+                    cpu->pinBase = data;
+                    return M6502_Pins_Read(cpu, cpu->pinBase);
+                case 2u:
+                    cpu->address = (cpu->pinBase + index) & 0x00FFu;
+                    return operand ? M6502_Pins_Read(cpu, cpu->address) : 0u;
+                default:
+                    cpu->target = data;
+                    return 0u;
+            }
+
+        case M6502_AddressMode_Absolute:
+            switch (cpu->pinStep++)
+            {
+                case 0u:
+                    return M6502_Pins_Read(cpu, cpu->programCounter++);
+                case 1u:
+                    cpu->pinBase = data;
+                    return M6502_Pins_Read(cpu, cpu->programCounter++);
+                case 2u:
+                    cpu->address = cpu->pinBase | ((uint16_t)data << 8u);
+                    return operand ? M6502_Pins_Read(cpu, cpu->address) : 0u;
+                default:
+                    cpu->target = data;
+                    return 0u;
+            }
+
+        case M6502_AddressMode_AbsoluteY:
+            index = cpu->yRegister;
+            /* fall through */
+        case M6502_AddressMode_AbsoluteX:
+            switch (cpu->pinStep++)
+            {
+                case 0u:
+                    return M6502_Pins_Read(cpu, cpu->programCounter++);
+                case 1u:
+                    cpu->pinBase = data;
+                    return M6502_Pins_Read(cpu, cpu->programCounter++);
+                case 2u:
+                    cpu->pinBase |= (uint16_t)data << 8u;
+                    cpu->address = cpu->pinBase + index;
+
+                    if (M6502_Pins_PageCross(cpu, cpu->pinBase, access))
+                    {
+                        return 1u;
+                    }
+
+                    cpu->pinStep++;
+                    /* fall through */
+                case 3u:
+                    return operand ? M6502_Pins_Read(cpu, cpu->address) : 0u;
+                default:
+                    cpu->target = data;
+                    return 0u;
+            }
+
+        case M6502_AddressMode_Indirect:
+            switch (cpu->pinStep++)
+            {
+                case 0u:
+                    return M6502_Pins_Read(cpu, cpu->programCounter++);
+                case 1u:
+                    cpu->pinBase = data;
+                    return M6502_Pins_Read(cpu, cpu->programCounter++);
+                case 2u:
+                    cpu->pinBase |= (uint16_t)data << 8u;
+                    return M6502_Pins_Read(cpu, cpu->pinBase);
+                case 3u:
+                    cpu->address = data;
+                    return M6502_Pins_Read(cpu, (cpu->pinBase & 0xFF00u) | ((cpu->pinBase + 1u) & 0x00FFu));
+                default:
+                    cpu->address |= (uint16_t)data << 8u;
+                    return 0u;
+            }
+
+        case M6502_AddressMode_IndirectX:
+            switch (cpu->pinStep++)
+            {
+                case 0u:
+                    return M6502_Pins_Read(cpu, cpu->programCounter++);
+                case 1u:
+                    cpu->pinBase = data;
+                    return M6502_Pins_Read(cpu, cpu->pinBase);
+                case 2u:
+                    cpu->pinBase = (cpu->pinBase + cpu->xRegister) & 0x00FFu;
+                    return M6502_Pins_Read(cpu, cpu->pinBase);
+                case 3u:
+                    cpu->address = data;
+                    return M6502_Pins_Read(cpu, (cpu->pinBase + 1u) & 0x00FFu);
+                case 4u:
+                    cpu->address |= (uint16_t)data << 8u;
+                    return operand ? M6502_Pins_Read(cpu, cpu->address) : 0u;
+                default:
+                    cpu->target = data;
+                    return 0u;
+            }
+
+        case M6502_AddressMode_IndirectY:
+            switch (cpu->pinStep++)
+            {
+                case 0u:
+                    return M6502_Pins_Read(cpu, cpu->programCounter++);
+                case 1u:
+                    cpu->pinBase = data;
+                    return M6502_Pins_Read(cpu, cpu->pinBase);
+                case 2u:
+                    cpu->address = data;
+                    return M6502_Pins_Read(cpu, (cpu->pinBase + 1u) & 0x00FFu);
+                case 3u:
+                    cpu->pinBase = cpu->address | ((uint16_t)data << 8u);
+                    cpu->address = cpu->pinBase + cpu->yRegister;
+
+                    if (M6502_Pins_PageCross(cpu, cpu->pinBase, access))
+                    {
+                        return 1u;
+                    }
+
+                    cpu->pinStep++;
+                    /* fall through */
+                case 4u:
+                    return operand ? M6502_Pins_Read(cpu, cpu->address) : 0u;
+                default:
+                    cpu->target = data;
+                    return 0u;
+            }
+
+        default:
+            return 0u;
+    }
+}
+
+/*
+ * The opcode body, its bus accesses queued for the ticks to come. Only M6502_DummyWrite and
+ * M6502_Util_WriteResult look at pinTicking, so the bodies that touch the bus any other way
+ * are sequenced here and M6502_Run pays nothing for the pins.
+ */
+static void M6502_Pins_Operate(M6502_t *cpu)
+{
+    /* Branches by bits 7-6 of the opcode: N, V, C or Z, taken when it equals bit 5. */
+    static const uint8_t branchFlags[4] = {
+        M6502_FLAG_NEGATIVE, M6502_FLAG_OVERFLOW, M6502_FLAG_CARRY, M6502_FLAG_ZERO
+    };
+
+    const M6502_OpcodeInfo_t *info = &M6502_OPCODE_INFO[cpu->opcode];
+
+    if (info->addressMode == M6502_AddressMode_Relative)
+    {
+        if (M6502_GetFlag(cpu, branchFlags[cpu->opcode >> 6u]) == ((cpu->opcode >> 5u) & 1u))
+        {
+            /* M6502_Util_Branch */
+            const uint16_t address = cpu->programCounter + (int8_t)cpu->address;
+
+            M6502_Pins_Access(cpu, cpu->programCounter, 0x00u, M6502_PIN_RW);
+            cpu->cycles++;
+
+            if ((address & 0xFF00u) != (cpu->programCounter & 0xFF00u))
+            {
+                M6502_Pins_Access(cpu, address, 0x00u, M6502_PIN_RW);
+                cpu->cycles++;
+            }
+
+            cpu->programCounter = address;
+        }
+        return;
+    }
+
+    switch (info->instruction)
+    {
+        case M6502_Instruction_PHA:
+        case M6502_Instruction_PHP:
+            M6502_Pins_Access(cpu, M6502_STACK_ADDRESS + cpu->stackPointer,
+                (info->instruction == M6502_Instruction_PHA)
+                    ? cpu->accumulator : (M6502_PackStatus(cpu) | M6502_FLAG_BREAK), 0u);
+            cpu->stackPointer = (cpu->stackPointer - 1u) & 0xFFu;
+            return;
+
+        case M6502_Instruction_JAM:
+            M6502_Pins_Access(cpu, M6502_JAMMED_ADDRESS - 1u, 0x00u, M6502_PIN_RW);
+            cpu->jammed = 0xFFu;
+            cpu->pendingInterrupts |= M6502_ATTENTION_JAM;
+            return;
+
+        default:
+            break;
+    }
+
+    cpu->pinTicking = 1u;
+    M6502_OPCODE_OPERATIONS[cpu->opcode](cpu);
+
+    /* The final write, held back by M6502_Util_WriteResult, always comes last. */
+    if (cpu->pinTicking == 2u)
+    {
+        M6502_Pins_Access(cpu, cpu->address, cpu->pinResult, 0u);
+    }
+    cpu->pinTicking = 0u;
+}
+
+/*
+ * Everything of the instruction that needs bus data, one access per call. The opcodes that sequence
+ * their own reads (and the interrupt) are spelled out, the others run their addressing mode here
+ * and their body once at the end. Returns 0 once only queued accesses and idle cycles remain.
+ */
+static uint8_t M6502_Pins_Sequence(M6502_t *cpu, const uint8_t data)
+{
+    if ((cpu->pinCycle == 1u) && (cpu->pinInterrupt == 0u))
+    {
+        if ((cpu->pendingInterrupts != 0u) && M6502_InterruptDue(cpu))
+        {
+            /* Raised during the fetch: the interrupt takes the fetch over as its dummy read. */
+            cpu->pinInterrupt   = 1u;
+            cpu->pinStep        = 1u;
+        }
+        else
+        {
+            M6502_SetFlag(cpu, M6502_FLAG_UNUSED, 1u);
+
+            cpu->opcode = data;
+            cpu->cycles = M6502_OPCODE_CYCLES[cpu->opcode];
+            cpu->programCounter++;
+        }
+    }
+
+    if ((cpu->pinInterrupt != 0u) || (cpu->opcode == 0x00u))
+    {
+        /* M6502_Util_Interrupt, or BRK after its padding byte. */
+        switch (cpu->pinStep++)
+        {
+            case 0u:
+                return M6502_Pins_Read(cpu, cpu->programCounter++);
+            case 1u:
+                return M6502_Pins_Push(cpu, (uint8_t)((cpu->programCounter >> 8u) & 0xFFu));
+            case 2u:
+                return M6502_Pins_Push(cpu, (uint8_t)(cpu->programCounter & 0xFFu));
+            case 3u:
+                M6502_Pins_Push(cpu, (cpu->pinInterrupt != 0u)
+                    ? (M6502_PackStatus(cpu) & ~M6502_FLAG_BREAK)
+                    : (M6502_PackStatus(cpu) | M6502_FLAG_BREAK));
+                M6502_SetFlag(cpu, M6502_FLAG_INTERRUPT, 1u);
+                return 1u;
+            case 4u:
+                cpu->pinBase = M6502_IRQVECTOR_ADDRESS;
+
+                if (cpu->pinInterrupt != 0u)
+                {
+                    /* The vector is picked on its fetch, so an NMI can still take over an IRQ. */
+                    const uint8_t nmi = ((cpu->pendingInterrupts & M6502_INTERRUPT_NMI) != 0u) ? 1u : 0u;
+
+                    cpu->pinBase    = nmi ? M6502_NMIVECTOR_ADDRESS : M6502_IRQVECTOR_ADDRESS;
+                    cpu->cycles     = nmi ? 8u : 7u;
+                }
+                return M6502_Pins_Read(cpu, cpu->pinBase);
+            case 5u:
+                cpu->address = data;
+                return M6502_Pins_Read(cpu, cpu->pinBase + 1u);
+            default:
+                cpu->programCounter = cpu->address | ((uint16_t)data << 8u);
+
+                if (cpu->pinInterrupt == 0u)
+                {
+                    return 0u;
+                }
+
+                if (cpu->pinBase == M6502_NMIVECTOR_ADDRESS)
+                {
+                    cpu->pendingInterrupts &= ~M6502_INTERRUPT_NMI;
+                    cpu->interruptFlags |= M6502_INTERRUPT_NMI;
+                }
+                else
+                {
+                    cpu->interruptFlags |= M6502_INTERRUPT_IRQ;
+
+                    /* A level IRQ stays pending until every source lets go of the line. */
+                    if (M6502_Lines_IRQ(cpu) == 0u)
+                    {
+                        cpu->pendingInterrupts &= ~M6502_INTERRUPT_IRQ;
+                    }
+                }
+                return 0u;
+        }
+    }
+
+    switch (cpu->opcode)
+    {
+        case 0x20u: /* JSR */
+            switch (cpu->pinStep++)
+            {
+                case 0u:
+                    return M6502_Pins_Read(cpu, cpu->programCounter++);
+                case 1u:
+                    cpu->address = data;
+                    return M6502_Pins_Read(cpu, M6502_STACK_ADDRESS | cpu->stackPointer);
+                case 2u:
+                    return M6502_Pins_Push(cpu, (uint8_t)((cpu->programCounter >> 8u) & 0xFFu));
+                case 3u:
+                    return M6502_Pins_Push(cpu, (uint8_t)(cpu->programCounter & 0xFFu));
+                case 4u:
+                    return M6502_Pins_Read(cpu, cpu->programCounter);
+                default:
+                    cpu->programCounter = cpu->address | ((uint16_t)data << 8u);
+                    return 0u;
+            }
+
+        case 0x40u: /* RTI */
+            switch (cpu->pinStep++)
+            {
+                case 0u:
+                    if ((cpu->interruptFlags & M6502_INTERRUPT_NMI) != 0u)
+                    {
+                        cpu->interruptFlags &= ~M6502_INTERRUPT_NMI;
+                    }
+                    else if ((cpu->interruptFlags & M6502_INTERRUPT_IRQ) != 0u)
+                    {
+                        cpu->interruptFlags &= ~M6502_INTERRUPT_IRQ;
+                    }
+                    return M6502_Pins_Read(cpu, M6502_STACK_ADDRESS | cpu->stackPointer);
+                case 1u:
+                    return M6502_Pins_Pull(cpu);
+                case 2u:
+                    M6502_UnpackStatus(cpu, data);
+                    return M6502_Pins_Pull(cpu);
+                case 3u:
+                    cpu->address = data;
+                    return M6502_Pins_Pull(cpu);
+                default:
+                    cpu->programCounter = cpu->address | ((uint16_t)data << 8u);
+                    return 0u;
+            }
+
+        case 0x60u: /* RTS */
+            switch (cpu->pinStep++)
+            {
+                case 0u:
+                    return M6502_Pins_Read(cpu, M6502_STACK_ADDRESS | cpu->stackPointer);
+                case 1u:
+                    return M6502_Pins_Pull(cpu);
+                case 2u:
+                    cpu->address = data;
+                    return M6502_Pins_Pull(cpu);
+                case 3u:
+                    cpu->programCounter = cpu->address | ((uint16_t)data << 8u);
+                    return M6502_Pins_Read(cpu, cpu->programCounter++);
+                default:
+                    return 0u;
+            }
+
+        case 0x28u: /* PLP */
+        case 0x68u: /* PLA */
+            switch (cpu->pinStep++)
+            {
+                case 0u:
+                    return M6502_Pins_Read(cpu, cpu->programCounter);
+                case 1u:
+                    return M6502_Pins_Read(cpu, M6502_STACK_ADDRESS | cpu->stackPointer);
+                case 2u:
+                    return M6502_Pins_Pull(cpu);
+                default:
+                    if (cpu->opcode == 0x28u)
+                    {
+                        M6502_UnpackStatus(cpu, (data | M6502_FLAG_UNUSED));
+                        return 0u;
+                    }
+
+                    cpu->accumulator = data;
+
+                    M6502_ZeroTest(cpu, (uint16_t)(cpu->accumulator));
+                    M6502_NegativeTest(cpu, (uint16_t)(cpu->accumulator));
+                    return 0u;
+            }
+
+        default:
+            if (M6502_Pins_Address(cpu, data))
+            {
+                return 1u;
+            }
+
+            M6502_Pins_Operate(cpu);
+            return 0u;
+    }
+}
+
+/* First cycle of the next instruction: the opcode fetch, or the dummy read of an interrupt. */
+static void M6502_Pins_Start(M6502_t *cpu)
+{
+    const uint32_t lines = cpu->pins & (M6502_PIN_IRQ | M6502_PIN_NMI | M6502_PIN_RDY);
+
+    if (cpu->jammed == 0xFFu)
+    {
+        cpu->pins = lines | M6502_JAMMED_ADDRESS | M6502_PIN_RW;
+        return;
+    }
+
+#ifdef M6502_STALL
+    /* A DMA holds the CPU like RDY, between instructions. */
+    if ((cpu->stallCycles != 0u) || (cpu->stallAlign != 0u))
+    {
+        M6502_Stall_Skip(cpu, 0u, 1u);
+        cpu->pins = lines | cpu->programCounter | M6502_PIN_RW;
+        return;
+    }
+#endif
+
+    cpu->pinStep        = 0u;
+    cpu->pinQueueHead   = 0u;
+    cpu->pinQueueCount  = 0u;
+    cpu->pinInterrupt   = ((cpu->pendingInterrupts != 0u) && M6502_InterruptDue(cpu)) ? 1u : 0u;
+
+    M6502_Pins_Read(cpu, cpu->programCounter);
+
+    if (cpu->pinInterrupt != 0u)
+    {
+        cpu->pinStep = 1u;
+        return;
+    }
+
+    cpu->pins |= M6502_PIN_SYNC;
+}
+
+/* One clock: the next access of the instruction, then its queued accesses, then its idle cycles. */
+static void M6502_Pins_Cycle(M6502_t *cpu, const uint8_t data)
+{
+    if (cpu->pinCycle == 0u)
+    {
+        M6502_Pins_Start(cpu);
+        return;
+    }
+
+    if (cpu->pinStep != M6502_PINS_STEP_DONE)
+    {
+        if (M6502_Pins_Sequence(cpu, data))
         {
-            M6502_Address_Implied(cpu);
-            M6502_Opcode_NOP(cpu);
             return;
         }
-        case 0x7Au:
+
+        cpu->pinStep = M6502_PINS_STEP_DONE;
+    }
+
+    if (cpu->pinQueueHead < cpu->pinQueueCount)
+    {
+        const uint8_t slot = cpu->pinQueueHead++;
+
+        M6502_Pins_Issue(cpu, cpu->pinQueueAddress[slot], cpu->pinQueueData[slot],
+            (cpu->pinQueueRead[slot] != 0u) ? M6502_PIN_RW : 0u);
+        return;
+    }
+
+    if (cpu->pinCycle < cpu->cycles)
+    {
+        /* Cycles the core does not model as accesses read the last address again. */
+        cpu->pins = (cpu->pins & ~(M6502_PIN_SYNC | 0x00FF0000u)) | M6502_PIN_RW;
+        cpu->pinCycle++;
+        return;
+    }
+
+    /* Every cycle is done: the next instruction starts on this one. */
+    cpu->cycles     = 0u;
+    cpu->pinCycle   = 0u;
+
+    M6502_Pins_Start(cpu);
+}
+
+uint32_t M6502_Tick(M6502_t *cpu, const uint32_t pins)
+{
+    const uint32_t lines = pins & (M6502_PIN_IRQ | M6502_PIN_NMI | M6502_PIN_RDY);
+
+    cpu->totalCycles++;
+
+    M6502_SetIRQLine(cpu, M6502_IRQ_SOURCE_PIN, (pins & M6502_PIN_IRQ) ? 1u : 0u);
+
+    /* The NMI pin keeps its own edge, apart from the line M6502_SetNMILine drives. */
+    if ((pins & M6502_PIN_NMI) && !cpu->pinNmi)
+    {
+        cpu->pendingInterrupts |= M6502_INTERRUPT_NMI;
+    }
+
+    cpu->pinNmi = (pins & M6502_PIN_NMI) ? 1u : 0u;
+
+#ifdef M6502_ATOMIC
+    M6502_Requests_Take(cpu);
+#endif
+
+    /* RDY low stretches read cycles: the same address stays on the bus. */
+    if ((pins & M6502_PIN_RDY) && (cpu->pins & M6502_PIN_RW))
+    {
+        cpu->pins = (cpu->pins & ~(M6502_PIN_IRQ | M6502_PIN_NMI | M6502_PIN_RDY)) | lines;
+        return cpu->pins;
+    }
+
+    cpu->pins = (cpu->pins & ~(M6502_PIN_IRQ | M6502_PIN_NMI | M6502_PIN_RDY)) | lines;
+
+    /* The data pins carry what the last read brought back. */
+    M6502_Pins_Cycle(cpu, M6502_PINS_DATA(pins));
+
+#ifdef M6502_SCHEDULER
+    M6502_Scheduler_Fire(cpu);
+#endif
+
+    return cpu->pins;
+}
+#endif
+
+uint8_t M6502_GetStatus(const M6502_t *cpu)
+{
+    return M6502_PackStatus(cpu);
+}
+
+void M6502_SetStatus(M6502_t *cpu, const uint8_t status)
+{
+    M6502_UnpackStatus(cpu, status);
+}
+
+const M6502_OpcodeInfo_t *M6502_GetOpcodeInfo(const uint8_t opcode)
+{
+    return &M6502_OPCODE_INFO[opcode];
+}
+
+#ifdef M6502_BLOCK_CACHE
+void M6502_AttachBlockCache(M6502_t *cpu, M6502_BlockCache_t *cache)
+{
+#ifdef M6502_JIT
+    if ((cpu->blockCache != NULL) && (cpu->blockCache->code != NULL))
+    {
+        munmap(cpu->blockCache->code, M6502_JIT_CODE_SIZE);
+        cpu->blockCache->code = NULL;
+    }
+#endif
+
+    if (cache != NULL)
+    {
+        memset(cache, 0, sizeof(*cache));
+    }
+
+    cpu->blockCache = cache;
+}
+
+void M6502_InvalidateBlockCache(M6502_t *cpu, const uint16_t address, const uint16_t length)
+{
+    M6502_BlockCache_t *cache = cpu->blockCache;
+
+    if ((cache == NULL) || (length == 0u))
+    {
+        return;
+    }
+
+    const uint8_t firstPage = (uint8_t)(address >> 8u);
+    const uint8_t lastPage  = (uint8_t)((uint16_t)(address + length - 1u) >> 8u);
+
+    for (uint8_t page = firstPage; ; ++page)
+    {
+        if (cache->codePages[page] != 0u)
+        {
+            M6502_BlockCache_InvalidatePage(cache, page);
+        }
+
+        if (page == lastPage)
+        {
+            break;
+        }
+    }
+}
+#endif
+
+#ifdef M6502_PAGE_TABLE
+void M6502_MapMemory(M6502_t *cpu, const uint16_t address, const uint32_t length, uint8_t *memory, const uint8_t readOnly)
+{
+    /* Only whole pages are mapped, the rest keeps going through the bus. */
+    const uint32_t firstPage    = ((uint32_t)address + 0xFFu) >> 8u;
+    const uint32_t endPage      = ((uint32_t)address + length) >> 8u;
+    const uintptr_t bias        = (memory != NULL) ? ((uintptr_t)memory - address) : 0u;
+
+    for (uint32_t page = firstPage; (page < endPage) && (page < 0x100u); ++page)
+    {
+        cpu->readPages[page]  = bias;
+        cpu->writePages[page] = readOnly ? 0u : bias;
+    }
+
+#ifdef M6502_JIT
+    /* Compiled code has the old mapping baked in. */
+    if (cpu->blockCache != NULL)
+    {
+        M6502_Jit_Flush(cpu->blockCache);
+    }
+#endif
+}
+#endif
+
+#ifdef M6502_DMA
+void M6502_StartDMA(M6502_t *cpu, const uint16_t source, uint8_t *destination, const uint16_t length)
+{
+    uint32_t copied = 0u;
+
+    while (copied < length)
+    {
+        const uint16_t address  = (uint16_t)(source + copied);
+        uint32_t chunk          = 0x100u - (address & 0xFFu);
+
+        if (chunk > (length - copied))
         {
-            M6502_Address_Implied(cpu);
-            M6502_Opcode_NOP(cpu);
-            return;
+            chunk = length - copied;
         }
-        case 0xDAu:
+
+#if defined(M6502_FLAT_MEMORY)
+        const uint8_t *memory = cpu->memory + address;
+#elif defined(M6502_PAGE_TABLE)
+        const uintptr_t bias = cpu->readPages[address >> 8u];
+        const uint8_t *memory = (bias != 0u) ? (const uint8_t *)(bias + address) : NULL;
+#else
+        const uint8_t *memory = NULL;
+#endif
+
+        if (memory != NULL)
         {
-            M6502_Address_Implied(cpu);
-            M6502_Opcode_NOP(cpu);
-            return;
+            memcpy(destination + copied, memory, chunk);
         }
-        case 0xFAu:
+        else
         {
-            M6502_Address_Implied(cpu);
-            M6502_Opcode_NOP(cpu);
-            return;
+            for (uint32_t index = 0u; index < chunk; ++index)
+            {
+                destination[copied + index] = M6502_ReadMemoryByte(cpu, (uint16_t)(address + index));
+            }
         }
 
-        case 0x80u:
+        copied += chunk;
+    }
+
+    /* One idle cycle, then a read and a write per byte; the alignment cycle is added when the stall starts. */
+    M6502_Stall(cpu, 1u + 2u * (uint32_t)length);
+    cpu->stallAlign = 1u;
+}
+
+void M6502_Stall(M6502_t *cpu, const uint32_t cycles)
+{
+    cpu->stallCycles += cycles;
+    cpu->pendingInterrupts |= M6502_ATTENTION_STALL;
+}
+#endif
+
+#ifdef M6502_SCHEDULER
+int M6502_ScheduleEvent(M6502_t *cpu, const uint64_t when, const M6502_EventCallback_t callback, void *context)
+{
+    if (callback == NULL)
+    {
+        return -1;
+    }
+
+    for (uint8_t slot = 0u; slot < M6502_EVENT_COUNT; ++slot)
+    {
+        M6502_Event_t *event = &cpu->events[slot];
+
+        if (event->callback == NULL)
         {
-            M6502_Address_Immediate(cpu);
-            M6502_Opcode_NOP(cpu);
-            return;
+            event->when     = when;
+            event->callback = callback;
+            event->context  = context;
+            event->sequence = cpu->eventSequence++;
+            event->position = cpu->eventCount;
+
+            cpu->eventHeap[cpu->eventCount++] = slot;
+            M6502_Scheduler_Sift(cpu, event->position);
+
+            return (int)slot;
         }
-        case 0x82u:
+    }
+
+    return -1;
+}
+
+void M6502_CancelEvent(M6502_t *cpu, const int event)
+{
+    if ((event < 0) || (event >= M6502_EVENT_COUNT) || (cpu->events[event].callback == NULL))
+    {
+        return;
+    }
+
+    M6502_Scheduler_Remove(cpu, cpu->events[event].position);
+}
+
+void M6502_RetimeEvent(M6502_t *cpu, const int event, const uint64_t when)
+{
+    if ((event < 0) || (event >= M6502_EVENT_COUNT) || (cpu->events[event].callback == NULL))
+    {
+        return;
+    }
+
+    /* A retimed event queues behind the others already due on its new cycle. */
+    cpu->events[event].when     = when;
+    cpu->events[event].sequence = cpu->eventSequence++;
+    M6502_Scheduler_Sift(cpu, cpu->events[event].position);
+}
+#endif
+
+#ifdef M6502_HLE
+int M6502_SetTrap(M6502_t *cpu, const uint16_t address, const M6502_TrapHandler_t handler, void *context)
+{
+    if (handler == NULL)
+    {
+        return -1;
+    }
+
+    M6502_ClearTrap(cpu, address);
+
+    for (uint8_t slot = 0u; slot < M6502_TRAP_COUNT; ++slot)
+    {
+        M6502_Trap_t *trap = &cpu->traps[slot];
+
+        if (trap->handler == NULL)
         {
-            M6502_Address_Immediate(cpu);
-            M6502_Opcode_NOP(cpu);
-            return;
+            trap->handler = handler;
+            trap->context = context;
+            trap->address = address;
+
+            cpu->trapMap[address >> 3u] |= (uint8_t)(1u << (address & 7u));
+
+#ifdef M6502_BLOCK_CACHE
+            /* Cached blocks running through the address have to split there. */
+            M6502_InvalidateBlockCache(cpu, address, 1u);
+#endif
+
+            return (int)slot;
         }
-        case 0x89u:
+    }
+
+    return -1;
+}
+
+void M6502_ClearTrap(M6502_t *cpu, const uint16_t address)
+{
+    for (uint8_t slot = 0u; slot < M6502_TRAP_COUNT; ++slot)
+    {
+        if (cpu->traps[slot].address == address)
         {
-            M6502_Address_Immediate(cpu);
-            M6502_Opcode_NOP(cpu);
-            return;
+            cpu->traps[slot].handler = NULL;
         }
-        case 0xC2u:
+    }
+
+    cpu->trapMap[address >> 3u] &= (uint8_t)~(1u << (address & 7u));
+}
+#endif
+
+#ifdef M6502_BATCH
+void M6502_InitBatch(M6502_Batch_t *batch)
+{
+    batch->count        = 0u;
+    batch->clock        = 0u;
+    batch->instructions = 0u;
+}
+
+int M6502_AddBatchCpu(M6502_Batch_t *batch, uint8_t *memory)
+{
+    if (batch->count >= M6502_BATCH_SIZE)
+    {
+        return -1;
+    }
+
+    const uint32_t index = batch->count++;
+    M6502_t *cpu = &batch->cpu;
+
+    cpu->memory = memory;
+    M6502_Init(cpu);
+
+    /* Instances count on the batch clock, from the moment they join. */
+    cpu->totalCycles = batch->clock;
+
+    batch->memory[index] = memory;
+    M6502_SetBatchCpu(batch, index, cpu);
+
+    return (int)index;
+}
+
+void M6502_GetBatchCpu(const M6502_Batch_t *batch, const uint32_t index, M6502_t *cpu)
+{
+    cpu->memory             = batch->memory[index];
+    cpu->totalCycles        = batch->totalCycles[index];
+    cpu->programCounter     = batch->programCounter[index];
+    cpu->accumulator        = batch->accumulator[index];
+    cpu->xRegister          = batch->xRegister[index];
+    cpu->yRegister          = batch->yRegister[index];
+    cpu->stackPointer       = batch->stackPointer[index];
+    M6502_UnpackStatus(cpu, batch->status[index]);
+    cpu->jammed             = batch->jammed[index];
+    cpu->interruptFlags     = batch->interruptFlags[index];
+    cpu->pendingInterrupts  = batch->pendingInterrupts[index];
+    cpu->cycles             = 0u;
+}
+
+void M6502_SetBatchCpu(M6502_Batch_t *batch, const uint32_t index, const M6502_t *cpu)
+{
+    /* Cycles still owed by the last instruction (or the reset) are charged up front, like M6502_Run does. */
+    batch->memory[index]            = cpu->memory;
+    batch->totalCycles[index]       = cpu->totalCycles + cpu->cycles;
+    batch->programCounter[index]    = cpu->programCounter;
+    batch->accumulator[index]       = cpu->accumulator;
+    batch->xRegister[index]         = cpu->xRegister;
+    batch->yRegister[index]         = cpu->yRegister;
+    batch->stackPointer[index]      = cpu->stackPointer;
+    batch->status[index]            = M6502_PackStatus(cpu);
+    batch->jammed[index]            = cpu->jammed;
+    batch->interruptFlags[index]    = cpu->interruptFlags;
+    batch->pendingInterrupts[index] = cpu->pendingInterrupts;
+}
+
+/* Runs one instruction on the scratch CPU; returns 0 when it is jammed and sits out the rest of the budget. */
+static uint32_t M6502_Batch_Execute(M6502_Batch_t *batch, M6502_t *cpu)
+{
+    if (cpu->jammed == 0xFFu)
+    {
+        cpu->totalCycles = batch->clock;
+        return 0u;
+    }
+
+    M6502_Execute(cpu);
+
+    cpu->totalCycles += cpu->cycles;
+    cpu->cycles = 0u;
+
+#ifdef M6502_STALL
+    /* Nothing else can run meanwhile, so a stall is charged whole. */
+    if ((cpu->pendingInterrupts & M6502_ATTENTION_STALL) != 0u)
+    {
+        cpu->totalCycles += M6502_Stall_Skip(cpu, 0u, UINT32_MAX);
+    }
+#endif
+
+    return 1u;
+}
+
+#ifdef M6502_BATCH_SIMD
+typedef uint8_t     M6502_Lanes_t           __attribute__((vector_size(M6502_BATCH_LANES)));
+typedef int8_t      M6502_LaneMask_t        __attribute__((vector_size(M6502_BATCH_LANES)));
+typedef uint16_t    M6502_LaneWords_t       __attribute__((vector_size(M6502_BATCH_LANES * 2)));
+typedef int16_t     M6502_LaneWordMask_t    __attribute__((vector_size(M6502_BATCH_LANES * 2)));
+typedef int16_t     M6502_LaneCycles_t      __attribute__((vector_size(M6502_BATCH_LANES * 2)));
+
+/* Cycles are counted in signed 16-bit lanes, which SSE2 can compare; a pass hands out at most this many. */
+static const int16_t M6502_LANES_BUDGET = 0x7F00;
+
+/* One group of the batch while it runs in lockstep; cycles count up from the start of the pass. */
+typedef struct
+{
+    M6502_Lanes_t       accumulator;
+    M6502_Lanes_t       xRegister;
+    M6502_Lanes_t       yRegister;
+    M6502_Lanes_t       stackPointer;
+    M6502_Lanes_t       status;
+    M6502_LaneWords_t   programCounter;
+    M6502_LaneCycles_t  spent;
+    M6502_LaneCycles_t  budget;
+} M6502_Lanes_State_t;
+
+static inline M6502_Lanes_t M6502_Lanes_Select(const M6502_LaneMask_t mask, const M6502_Lanes_t taken, const M6502_Lanes_t kept)
+{
+    return (taken & (M6502_Lanes_t)mask) | (kept & ~(M6502_Lanes_t)mask);
+}
+
+/* Lane masks are whole 0x00/0xFF bytes, so eight lanes are summed per word. */
+static inline uint32_t M6502_Lanes_Count(const M6502_LaneMask_t mask)
+{
+    const M6502_Lanes_t ones = (M6502_Lanes_t)mask & 1u;
+    uint64_t words[M6502_BATCH_LANES / 8];
+    uint32_t count = 0u;
+
+    memcpy(words, &ones, sizeof(words));
+
+    for (uint32_t word = 0u; word < (M6502_BATCH_LANES / 8); ++word)
+    {
+        count += (uint32_t)((words[word] * 0x0101010101010101ull) >> 56u);
+    }
+
+    return count;
+}
+
+static inline uint8_t M6502_Lanes_Equal(const M6502_LaneMask_t left, const M6502_LaneMask_t right)
+{
+    return (memcmp(&left, &right, sizeof(left)) == 0);
+}
+
+/* A sign test rather than a compare: wider-than-native vector compares are lowered one lane at a time. */
+static inline M6502_LaneMask_t M6502_Lanes_Running(const M6502_Lanes_State_t *lanes)
+{
+    return __builtin_convertvector((lanes->spent - lanes->budget) >> 15, M6502_LaneMask_t);
+}
+
+static inline M6502_Lanes_t M6502_Lanes_NZ(const M6502_Lanes_t status, const M6502_Lanes_t result)
+{
+    const M6502_Lanes_t zero = (M6502_Lanes_t)(result == 0u);
+
+    return (status & (uint8_t)~(M6502_FLAG_NEGATIVE | M6502_FLAG_ZERO))
+        | (result & M6502_FLAG_NEGATIVE) | (zero & M6502_FLAG_ZERO);
+}
+
+/* Binary ADC; SBC passes the inverted operand. */
+static inline M6502_Lanes_t M6502_Lanes_Add(M6502_Lanes_t *status, const M6502_Lanes_t accumulator, const M6502_Lanes_t operand)
+{
+    const M6502_Lanes_t partial = accumulator + operand;
+    const M6502_Lanes_t sum     = partial + (*status & M6502_FLAG_CARRY);
+    const M6502_Lanes_t carry   = (M6502_Lanes_t)(partial < accumulator) | (M6502_Lanes_t)(sum < partial);
+    const M6502_Lanes_t over    = (M6502_Lanes_t)(((accumulator ^ sum) & (operand ^ sum) & 0x80u) != 0u);
+
+    *status = (*status & (uint8_t)~(M6502_FLAG_CARRY | M6502_FLAG_OVERFLOW))
+        | (carry & M6502_FLAG_CARRY) | (over & M6502_FLAG_OVERFLOW);
+    *status = M6502_Lanes_NZ(*status, sum);
+
+    return sum;
+}
+
+static inline M6502_Lanes_t M6502_Lanes_Compare(const M6502_Lanes_t status, const M6502_Lanes_t value, const M6502_Lanes_t operand)
+{
+    const M6502_Lanes_t carry = (M6502_Lanes_t)(value >= operand);
+
+    return M6502_Lanes_NZ((status & (uint8_t)~M6502_FLAG_CARRY) | (carry & M6502_FLAG_CARRY), value - operand);
+}
+
+static inline uint8_t M6502_Lanes_Bytes(const uint8_t opcode)
+{
+    /* JSR fetches its own operand, so the table lists it with none. */
+    return (M6502_OPCODE_INFO[opcode].instruction == M6502_Instruction_JSR)
+        ? 2u : M6502_OPERAND_BYTES[M6502_OPCODE_INFO[opcode].addressMode];
+}
+
+/* Instructions with a kernel; the ones left out touch the interrupt flag, decimal arithmetic or indirect jumps. */
+static uint8_t M6502_Lanes_Vectorizable(const uint8_t opcode, const uint8_t status)
+{
+    const M6502_OpcodeInfo_t *info = &M6502_OPCODE_INFO[opcode];
+
+    switch (info->instruction)
+    {
+        case M6502_Instruction_ADC:
+        case M6502_Instruction_SBC:
+#ifndef M6502_NES_CPU
+            return ((status & M6502_FLAG_DECIMAL) == 0u);
+#else
+            (void)status;
+            return 1u;
+#endif
+
+        case M6502_Instruction_JMP:
+            return (info->addressMode == M6502_AddressMode_Absolute);
+
+        case M6502_Instruction_LDA: case M6502_Instruction_LDX: case M6502_Instruction_LDY:
+        case M6502_Instruction_STA: case M6502_Instruction_STX: case M6502_Instruction_STY:
+        case M6502_Instruction_AND: case M6502_Instruction_ORA: case M6502_Instruction_EOR:
+        case M6502_Instruction_CMP: case M6502_Instruction_CPX: case M6502_Instruction_CPY:
+        case M6502_Instruction_BIT: case M6502_Instruction_NOP:
+        case M6502_Instruction_INC: case M6502_Instruction_DEC:
+        case M6502_Instruction_ASL: case M6502_Instruction_LSR:
+        case M6502_Instruction_ROL: case M6502_Instruction_ROR:
+        case M6502_Instruction_INX: case M6502_Instruction_INY:
+        case M6502_Instruction_DEX: case M6502_Instruction_DEY:
+        case M6502_Instruction_TAX: case M6502_Instruction_TAY:
+        case M6502_Instruction_TXA: case M6502_Instruction_TYA:
+        case M6502_Instruction_TSX: case M6502_Instruction_TXS:
+        case M6502_Instruction_PHA: case M6502_Instruction_PHP:
+        case M6502_Instruction_PLA: case M6502_Instruction_PLP:
+        case M6502_Instruction_JSR: case M6502_Instruction_RTS:
+        case M6502_Instruction_CLC: case M6502_Instruction_SEC:
+        case M6502_Instruction_CLD: case M6502_Instruction_SED:
+        case M6502_Instruction_CLV:
+        case M6502_Instruction_BPL: case M6502_Instruction_BMI:
+        case M6502_Instruction_BVC: case M6502_Instruction_BVS:
+        case M6502_Instruction_BCC: case M6502_Instruction_BCS:
+        case M6502_Instruction_BNE: case M6502_Instruction_BEQ:
+            return 1u;
+
+        default:
+            return 0u;
+    }
+}
+
+/* Effective address of one lane; flat memory has no side effects, so dummy accesses are skipped. */
+static inline uint16_t M6502_Lanes_Address(const uint8_t *memory, const M6502_AddressMode_t mode,
+    const uint16_t operand, const uint8_t x, const uint8_t y, uint16_t *base)
+{
+    uint16_t pointer;
+
+    switch (mode)
+    {
+        case M6502_AddressMode_ZeroPageX:   return (uint8_t)(operand + x);
+        case M6502_AddressMode_ZeroPageY:   return (uint8_t)(operand + y);
+        case M6502_AddressMode_AbsoluteX:   *base = operand; return operand + x;
+        case M6502_AddressMode_AbsoluteY:   *base = operand; return operand + y;
+
+        case M6502_AddressMode_IndirectX:
+            pointer = (uint8_t)(operand + x);
+            return (uint16_t)memory[pointer] | (uint16_t)(memory[(uint8_t)(pointer + 1u)] << 8u);
+
+        case M6502_AddressMode_IndirectY:
+            *base = (uint16_t)memory[operand] | (uint16_t)(memory[(uint8_t)(operand + 1u)] << 8u);
+            return *base + y;
+
+        default:                            return operand;
+    }
+}
+
+/* Runs one instruction on the lanes in group, which all sit on the same bytes; returns 1 if they land together too. */
+static uint8_t M6502_Lanes_Execute(M6502_Batch_t *batch, const uint32_t base, M6502_Lanes_State_t *lanes,
+    const M6502_LaneMask_t group, const uint16_t programCounter, const uint8_t opcode, const uint16_t operand)
+{
+    const M6502_OpcodeInfo_t *info = &M6502_OPCODE_INFO[opcode];
+    const M6502_Instruction_t instruction = info->instruction;
+    const M6502_AddressMode_t mode = info->addressMode;
+    const uint16_t next = programCounter + 1u + M6502_Lanes_Bytes(opcode);
+    const uint8_t memoryOperand = (mode != M6502_AddressMode_Immediate) && (mode != M6502_AddressMode_Relative)
+        && (M6502_OPERAND_BYTES[mode] != 0u) && (instruction != M6502_Instruction_JMP);
+    const uint8_t pull = (instruction == M6502_Instruction_PLA) || (instruction == M6502_Instruction_PLP);
+
+    M6502_Lanes_t a         = lanes->accumulator;
+    M6502_Lanes_t x         = lanes->xRegister;
+    M6502_Lanes_t y         = lanes->yRegister;
+    M6502_Lanes_t s         = lanes->stackPointer;
+    M6502_Lanes_t p         = lanes->status;
+    M6502_Lanes_t operands  = (M6502_Lanes_t){ 0u } + (uint8_t)operand;
+    M6502_Lanes_t penalty   = { 0u };
+    M6502_LaneWords_t target = (M6502_LaneWords_t){ 0u } + next;
+    uint16_t address[M6502_BATCH_LANES];
+    uint8_t landed = 1u;
+
+    /* Operands are gathered per lane: indexed and indirect modes land on different bytes. */
+    if (memoryOperand || pull)
+    {
+        const uint8_t indexed = (info->access == M6502_Access_Read) && ((mode == M6502_AddressMode_AbsoluteX)
+            || (mode == M6502_AddressMode_AbsoluteY) || (mode == M6502_AddressMode_IndirectY));
+
+        for (uint32_t lane = 0u; lane < M6502_BATCH_LANES; ++lane)
         {
-            M6502_Address_Immediate(cpu);
-            M6502_Opcode_NOP(cpu);
-            return;
+            if (group[lane] == 0)
+            {
+                continue;
+            }
+
+            const uint8_t *memory = batch->memory[base + lane];
+
+            if (memoryOperand)
+            {
+                uint16_t page = 0u;
+
+                address[lane] = M6502_Lanes_Address(memory, mode, operand, x[lane], y[lane], &page);
+                operands[lane] = memory[address[lane]];
+
+                /* Only reads skip the fix-up cycle when the index stays on the page, as M6502_Util_PageCross does. */
+                penalty[lane] = indexed && (((page ^ address[lane]) & 0xFF00u) != 0u);
+            }
+            else
+            {
+                s[lane] += 1u;
+                operands[lane] = memory[M6502_STACK_ADDRESS + s[lane]];
+            }
         }
-        case 0xE2u:
+    }
+
+    uint8_t branchFlag = 0u;
+    uint8_t branchSet  = 0u;
+
+    switch (instruction)
+    {
+        case M6502_Instruction_LDA: a = operands; p = M6502_Lanes_NZ(p, a); break;
+        case M6502_Instruction_LDX: x = operands; p = M6502_Lanes_NZ(p, x); break;
+        case M6502_Instruction_LDY: y = operands; p = M6502_Lanes_NZ(p, y); break;
+        case M6502_Instruction_AND: a &= operands; p = M6502_Lanes_NZ(p, a); break;
+        case M6502_Instruction_ORA: a |= operands; p = M6502_Lanes_NZ(p, a); break;
+        case M6502_Instruction_EOR: a ^= operands; p = M6502_Lanes_NZ(p, a); break;
+        case M6502_Instruction_ADC: a = M6502_Lanes_Add(&p, a, operands); break;
+        case M6502_Instruction_SBC: a = M6502_Lanes_Add(&p, a, ~operands); break;
+        case M6502_Instruction_CMP: p = M6502_Lanes_Compare(p, a, operands); break;
+        case M6502_Instruction_CPX: p = M6502_Lanes_Compare(p, x, operands); break;
+        case M6502_Instruction_CPY: p = M6502_Lanes_Compare(p, y, operands); break;
+        case M6502_Instruction_INC: operands += 1u; p = M6502_Lanes_NZ(p, operands); break;
+        case M6502_Instruction_DEC: operands -= 1u; p = M6502_Lanes_NZ(p, operands); break;
+        case M6502_Instruction_INX: x += 1u; p = M6502_Lanes_NZ(p, x); break;
+        case M6502_Instruction_INY: y += 1u; p = M6502_Lanes_NZ(p, y); break;
+        case M6502_Instruction_DEX: x -= 1u; p = M6502_Lanes_NZ(p, x); break;
+        case M6502_Instruction_DEY: y -= 1u; p = M6502_Lanes_NZ(p, y); break;
+        case M6502_Instruction_TAX: x = a; p = M6502_Lanes_NZ(p, x); break;
+        case M6502_Instruction_TAY: y = a; p = M6502_Lanes_NZ(p, y); break;
+        case M6502_Instruction_TXA: a = x; p = M6502_Lanes_NZ(p, a); break;
+        case M6502_Instruction_TYA: a = y; p = M6502_Lanes_NZ(p, a); break;
+        case M6502_Instruction_TSX: x = s; p = M6502_Lanes_NZ(p, x); break;
+        case M6502_Instruction_TXS: s = x; break;
+        case M6502_Instruction_PLA: a = operands; p = M6502_Lanes_NZ(p, a); break;
+        case M6502_Instruction_PLP: p = operands | M6502_FLAG_UNUSED; break;
+        case M6502_Instruction_CLC: p &= (uint8_t)~M6502_FLAG_CARRY; break;
+        case M6502_Instruction_SEC: p |= M6502_FLAG_CARRY; break;
+        case M6502_Instruction_CLD: p &= (uint8_t)~M6502_FLAG_DECIMAL; break;
+        case M6502_Instruction_SED: p |= M6502_FLAG_DECIMAL; break;
+        case M6502_Instruction_CLV: p &= (uint8_t)~M6502_FLAG_OVERFLOW; break;
+        case M6502_Instruction_JMP: target = (M6502_LaneWords_t){ 0u } + operand; break;
+
+        case M6502_Instruction_BIT:
+            p = (p & (uint8_t)~(M6502_FLAG_NEGATIVE | M6502_FLAG_OVERFLOW | M6502_FLAG_ZERO))
+                | (operands & (uint8_t)(M6502_FLAG_NEGATIVE | M6502_FLAG_OVERFLOW))
+                | ((M6502_Lanes_t)((a & operands) == 0u) & M6502_FLAG_ZERO);
+            break;
+
+        case M6502_Instruction_ASL:
+        case M6502_Instruction_ROL:
+        case M6502_Instruction_LSR:
+        case M6502_Instruction_ROR:
         {
-            M6502_Address_Immediate(cpu);
-            M6502_Opcode_NOP(cpu);
-            return;
+            M6502_Lanes_t shifted = (mode == M6502_AddressMode_Accumulator) ? a : operands;
+            const M6502_Lanes_t carry = p & M6502_FLAG_CARRY;
+            const uint8_t left = (instruction == M6502_Instruction_ASL) || (instruction == M6502_Instruction_ROL);
+            const uint8_t rotate = (instruction == M6502_Instruction_ROL) || (instruction == M6502_Instruction_ROR);
+
+            p = (p & (uint8_t)~M6502_FLAG_CARRY) | (left ? (shifted >> 7u) : (shifted & 0x01u));
+            shifted = left ? (shifted << 1u) : (shifted >> 1u);
+
+            if (rotate)
+            {
+                shifted |= left ? carry : (carry << 7u);
+            }
+
+            p = M6502_Lanes_NZ(p, shifted);
+
+            if (mode == M6502_AddressMode_Accumulator)
+            {
+                a = shifted;
+            }
+            else
+            {
+                operands = shifted;
+            }
+            break;
         }
-        case 0x04u:
+
+        case M6502_Instruction_BPL: branchFlag = M6502_FLAG_NEGATIVE;  branchSet = 0u; break;
+        case M6502_Instruction_BMI: branchFlag = M6502_FLAG_NEGATIVE;  branchSet = 1u; break;
+        case M6502_Instruction_BVC: branchFlag = M6502_FLAG_OVERFLOW;  branchSet = 0u; break;
+        case M6502_Instruction_BVS: branchFlag = M6502_FLAG_OVERFLOW;  branchSet = 1u; break;
+        case M6502_Instruction_BCC: branchFlag = M6502_FLAG_CARRY;     branchSet = 0u; break;
+        case M6502_Instruction_BCS: branchFlag = M6502_FLAG_CARRY;     branchSet = 1u; break;
+        case M6502_Instruction_BNE: branchFlag = M6502_FLAG_ZERO;      branchSet = 0u; break;
+        case M6502_Instruction_BEQ: branchFlag = M6502_FLAG_ZERO;      branchSet = 1u; break;
+
+        default: break;
+    }
+
+    /* Stores and the stack stay per lane. */
+    switch (instruction)
+    {
+        case M6502_Instruction_STA:
+        case M6502_Instruction_STX:
+        case M6502_Instruction_STY:
+        case M6502_Instruction_INC:
+        case M6502_Instruction_DEC:
+        case M6502_Instruction_ASL:
+        case M6502_Instruction_LSR:
+        case M6502_Instruction_ROL:
+        case M6502_Instruction_ROR:
+            if (memoryOperand)
+            {
+                const M6502_Lanes_t stored = (instruction == M6502_Instruction_STA) ? a
+                    : (instruction == M6502_Instruction_STX) ? x
+                    : (instruction == M6502_Instruction_STY) ? y : operands;
+
+                for (uint32_t lane = 0u; lane < M6502_BATCH_LANES; ++lane)
+                {
+                    if (group[lane] != 0)
+                    {
+                        batch->memory[base + lane][address[lane]] = stored[lane];
+                    }
+                }
+            }
+            break;
+
+        case M6502_Instruction_PHA:
+        case M6502_Instruction_PHP:
         {
-            M6502_Address_ZeroPage(cpu);
-            M6502_Opcode_NOP(cpu);
-            return;
+            const M6502_Lanes_t pushed = (instruction == M6502_Instruction_PHA) ? a : (p | M6502_FLAG_BREAK);
+
+            for (uint32_t lane = 0u; lane < M6502_BATCH_LANES; ++lane)
+            {
+                if (group[lane] != 0)
+                {
+                    batch->memory[base + lane][M6502_STACK_ADDRESS + s[lane]] = pushed[lane];
+                }
+            }
+
+            s -= 1u;
+            break;
         }
-        case 0x44u:
+
+        case M6502_Instruction_JSR:
+            for (uint32_t lane = 0u; lane < M6502_BATCH_LANES; ++lane)
+            {
+                if (group[lane] != 0)
+                {
+                    uint8_t *stack = &batch->memory[base + lane][M6502_STACK_ADDRESS];
+
+                    stack[s[lane]] = (uint8_t)((next - 1u) >> 8u);
+                    stack[(uint8_t)(s[lane] - 1u)] = (uint8_t)(next - 1u);
+                }
+            }
+
+            s -= 2u;
+            target = (M6502_LaneWords_t){ 0u } + operand;
+            break;
+
+        case M6502_Instruction_RTS:
         {
-            M6502_Address_ZeroPage(cpu);
-            M6502_Opcode_NOP(cpu);
-            return;
+            uint32_t returned = M6502_BATCH_LANES;
+
+            for (uint32_t lane = 0u; lane < M6502_BATCH_LANES; ++lane)
+            {
+                if (group[lane] != 0)
+                {
+                    const uint8_t *stack = &batch->memory[base + lane][M6502_STACK_ADDRESS];
+
+                    target[lane] = (uint16_t)(stack[(uint8_t)(s[lane] + 1u)] | (stack[(uint8_t)(s[lane] + 2u)] << 8u)) + 1u;
+                    returned = (returned == M6502_BATCH_LANES) ? lane : returned;
+                    landed &= (target[lane] == target[returned]);
+                }
+            }
+
+            s += 2u;
+            break;
         }
-        case 0x64u:
+
+        default:
+            break;
+    }
+
+    /* A taken branch costs the same on every lane, since they all branch from the same place. */
+    if (branchFlag != 0u)
+    {
+        const M6502_LaneMask_t taken = branchSet ? ((p & branchFlag) != 0u) : ((p & branchFlag) == 0u);
+        const uint16_t branch = next + (uint16_t)(int8_t)operand;
+        const uint8_t extra = ((next ^ branch) & 0xFF00u) ? 2u : 1u;
+
+        target = (M6502_LaneWords_t)((__builtin_convertvector(taken, M6502_LaneWordMask_t) & (int16_t)branch)
+            | (__builtin_convertvector(~taken, M6502_LaneWordMask_t) & (int16_t)next));
+        penalty += (M6502_Lanes_t)taken & extra;
+        landed = M6502_Lanes_Equal(taken & group, group) || M6502_Lanes_Equal(taken & group, (M6502_LaneMask_t){ 0 });
+    }
+
+    const M6502_LaneWordMask_t words = __builtin_convertvector(group, M6502_LaneWordMask_t);
+
+    lanes->accumulator      = M6502_Lanes_Select(group, a, lanes->accumulator);
+    lanes->xRegister        = M6502_Lanes_Select(group, x, lanes->xRegister);
+    lanes->yRegister        = M6502_Lanes_Select(group, y, lanes->yRegister);
+    lanes->stackPointer     = M6502_Lanes_Select(group, s, lanes->stackPointer);
+    lanes->status           = M6502_Lanes_Select(group, p, lanes->status);
+    lanes->programCounter   = (target & (M6502_LaneWords_t)words) | (lanes->programCounter & ~(M6502_LaneWords_t)words);
+    lanes->spent           += (__builtin_convertvector(penalty, M6502_LaneCycles_t) + M6502_OPCODE_CYCLES[opcode]) & words;
+
+    return landed;
+}
+
+/* Runs one lane on the scratch CPU until it reaches an instruction with a kernel again. */
+static uint64_t M6502_Lanes_Scalar(M6502_Batch_t *batch, const uint32_t base, M6502_Lanes_State_t *lanes, const uint32_t lane)
+{
+    const uint32_t index = base + lane;
+    M6502_t *cpu = &batch->cpu;
+    uint64_t instructions = 0u;
+
+    M6502_GetBatchCpu(batch, index, cpu);
+
+    cpu->totalCycles   += (uint16_t)lanes->spent[lane];
+
+    const uint64_t start = cpu->totalCycles;
+    const uint64_t clock = start + (uint64_t)(lanes->budget[lane] - lanes->spent[lane]);
+
+    cpu->programCounter = lanes->programCounter[lane];
+    cpu->accumulator    = lanes->accumulator[lane];
+    cpu->xRegister      = lanes->xRegister[lane];
+    cpu->yRegister      = lanes->yRegister[lane];
+    cpu->stackPointer   = lanes->stackPointer[lane];
+    M6502_UnpackStatus(cpu, lanes->status[lane]);
+
+    do
+    {
+        instructions += M6502_Batch_Execute(batch, cpu);
+    } while ((cpu->totalCycles < clock)
+        && ((cpu->pendingInterrupts != 0u) || M6502_TRAPPED(cpu, cpu->programCounter)
+        || !M6502_Lanes_Vectorizable(cpu->memory[cpu->programCounter], M6502_PackStatus(cpu))));
+
+    /* The lane restarts its count here, since a stall may have taken more cycles than a lane can hold. */
+    lanes->budget[lane]         = (cpu->totalCycles < clock) ? (int16_t)(clock - cpu->totalCycles) : 0;
+    lanes->spent[lane]          = 0u;
+    batch->totalCycles[index]   = cpu->totalCycles;
+    lanes->programCounter[lane] = cpu->programCounter;
+    lanes->accumulator[lane]    = cpu->accumulator;
+    lanes->xRegister[lane]      = cpu->xRegister;
+    lanes->yRegister[lane]      = cpu->yRegister;
+    lanes->stackPointer[lane]   = cpu->stackPointer;
+    lanes->status[lane]         = M6502_PackStatus(cpu);
+
+    batch->jammed[index]            = cpu->jammed;
+    batch->interruptFlags[index]    = cpu->interruptFlags;
+    batch->pendingInterrupts[index] = cpu->pendingInterrupts;
+
+    return instructions;
+}
+
+/*
+    Runs one group of lanes up to the batch clock, or one budget further. The lane furthest behind
+    leads: every lane parked on the same bytes runs its instruction with it, and as long as they all
+    stay together the next instruction is taken without looking for a leader again.
+*/
+static uint64_t M6502_Lanes_Pass(M6502_Batch_t *batch, const uint32_t base, uint8_t *clamped)
+{
+    const uint32_t count = ((batch->count - base) < M6502_BATCH_LANES) ? (batch->count - base) : M6502_BATCH_LANES;
+    uint64_t instructions = 0u;
+    M6502_Lanes_State_t lanes;
+
+    *clamped = 0u;
+
+    memset(&lanes, 0, sizeof(lanes));
+
+    for (uint32_t lane = 0u; lane < count; ++lane)
+    {
+        const uint32_t index = base + lane;
+        const uint64_t behind = (batch->totalCycles[index] < batch->clock) ? (batch->clock - batch->totalCycles[index]) : 0u;
+
+        lanes.accumulator[lane]     = batch->accumulator[index];
+        lanes.xRegister[lane]       = batch->xRegister[index];
+        lanes.yRegister[lane]       = batch->yRegister[index];
+        lanes.stackPointer[lane]    = batch->stackPointer[index];
+        lanes.status[lane]          = batch->status[index];
+        lanes.programCounter[lane]  = batch->programCounter[index];
+        lanes.budget[lane]          = (behind > (uint64_t)M6502_LANES_BUDGET) ? M6502_LANES_BUDGET : (int16_t)behind;
+        *clamped                   |= (behind > (uint64_t)M6502_LANES_BUDGET);
+    }
+
+    M6502_LaneMask_t group = { 0 };
+    uint8_t together = 0u;
+    uint32_t leader = 0u;
+
+    for (;;)
+    {
+        const M6502_LaneMask_t running = M6502_Lanes_Running(&lanes);
+
+        if (!together)
         {
-            M6502_Address_ZeroPage(cpu);
-            M6502_Opcode_NOP(cpu);
-            return;
+            leader = M6502_BATCH_LANES;
+
+            for (uint32_t lane = 0u; lane < count; ++lane)
+            {
+                if ((running[lane] != 0) && ((leader == M6502_BATCH_LANES)
+                || ((batch->totalCycles[base + lane] + (uint16_t)lanes.spent[lane]) < (batch->totalCycles[base + leader] + (uint16_t)lanes.spent[leader]))))
+                {
+                    leader = lane;
+                }
+            }
+
+            if (leader == M6502_BATCH_LANES)
+            {
+                break;
+            }
         }
-        case 0x14u:
+
+        const uint32_t first = base + leader;
+        const uint16_t programCounter = lanes.programCounter[leader];
+        const uint8_t *code = batch->memory[first];
+        const uint8_t opcode = code[programCounter];
+
+        /* Every lane waiting at an instruction without a kernel catches up on its own. */
+        if ((batch->jammed[first] != 0u) || (batch->pendingInterrupts[first] != 0u)
+        || M6502_TRAPPED(&batch->cpu, programCounter)
+        || !M6502_Lanes_Vectorizable(opcode, lanes.status[leader]))
         {
-            M6502_Address_ZeroPageX(cpu);
-            M6502_Opcode_NOP(cpu);
-            return;
+            for (uint32_t lane = 0u; lane < count; ++lane)
+            {
+                if ((running[lane] != 0) && (lanes.programCounter[lane] == programCounter))
+                {
+                    instructions += M6502_Lanes_Scalar(batch, base, &lanes, lane);
+                }
+            }
+
+            together = 0u;
+            continue;
         }
-        case 0x34u:
+
+        const uint8_t bytes = M6502_Lanes_Bytes(opcode);
+        const uint16_t operand = (bytes == 0u) ? 0u : (bytes == 1u) ? code[(uint16_t)(programCounter + 1u)]
+            : (uint16_t)(code[(uint16_t)(programCounter + 1u)] | (code[(uint16_t)(programCounter + 2u)] << 8u));
+
+        /* Lanes that joined late, took an interrupt or patched their code wait for a later pass. */
+        if (!together)
         {
-            M6502_Address_ZeroPageX(cpu);
-            M6502_Opcode_NOP(cpu);
-            return;
+            group = running & (__builtin_convertvector(lanes.programCounter == programCounter, M6502_LaneMask_t));
+
+            for (uint32_t lane = 0u; lane < count; ++lane)
+            {
+                if ((batch->jammed[base + lane] != 0u) || (batch->pendingInterrupts[base + lane] != 0u))
+                {
+                    group[lane] = 0;
+                }
+            }
         }
-        case 0x54u:
+
+        if (programCounter <= 0xFFFCu)
         {
-            M6502_Address_ZeroPageX(cpu);
-            M6502_Opcode_NOP(cpu);
-            return;
+            /* One word per lane covers the opcode and operand; the last bytes of the image are compared one by one. */
+            const uint32_t used = 0xFFFFFFFFu >> (8u * (3u - bytes));
+            uint32_t expected;
+
+            memcpy(&expected, &code[programCounter], sizeof(expected));
+
+            for (uint32_t lane = 0u; lane < count; ++lane)
+            {
+                uint32_t found;
+
+                memcpy(&found, &batch->memory[base + lane][programCounter], sizeof(found));
+
+                if (((found ^ expected) & used) != 0u)
+                {
+                    group[lane] = 0;
+                }
+            }
         }
-        case 0x74u:
+        else
         {
-            M6502_Address_ZeroPageX(cpu);
-            M6502_Opcode_NOP(cpu);
-            return;
+            for (uint32_t lane = 0u; lane < count; ++lane)
+            {
+                const uint8_t *memory = batch->memory[base + lane];
+
+                if ((memory[programCounter] != opcode)
+                || ((bytes >= 1u) && (memory[(uint16_t)(programCounter + 1u)] != (uint8_t)operand))
+                || ((bytes >= 2u) && (memory[(uint16_t)(programCounter + 2u)] != (uint8_t)(operand >> 8u))))
+                {
+                    group[lane] = 0;
+                }
+            }
         }
-        case 0xD4u:
+
+        if ((M6502_OPCODE_INFO[opcode].instruction == M6502_Instruction_ADC) || (M6502_OPCODE_INFO[opcode].instruction == M6502_Instruction_SBC))
         {
-            M6502_Address_ZeroPageX(cpu);
-            M6502_Opcode_NOP(cpu);
-            return;
+            group &= (lanes.status & M6502_FLAG_DECIMAL) == (lanes.status[leader] & M6502_FLAG_DECIMAL);
         }
-        case 0xF4u:
+
+        const uint8_t landed = M6502_Lanes_Execute(batch, base, &lanes, group, programCounter, opcode, operand);
+        const M6502_LaneMask_t still = M6502_Lanes_Running(&lanes);
+
+        instructions += M6502_Lanes_Count(group);
+
+        /* Still together when every lane of the group landed on one address and none ran out of budget. */
+        together = landed && (group[leader] != 0) && M6502_Lanes_Equal(group, still & group);
+    }
+
+    for (uint32_t lane = 0u; lane < count; ++lane)
+    {
+        const uint32_t index = base + lane;
+
+        batch->totalCycles[index]      += (uint16_t)lanes.spent[lane];
+        batch->programCounter[index]    = lanes.programCounter[lane];
+        batch->accumulator[index]       = lanes.accumulator[lane];
+        batch->xRegister[index]         = lanes.xRegister[lane];
+        batch->yRegister[index]         = lanes.yRegister[lane];
+        batch->stackPointer[index]      = lanes.stackPointer[lane];
+        batch->status[index]            = lanes.status[lane];
+    }
+
+    return instructions;
+}
+
+static uint64_t M6502_Lanes_Run(M6502_Batch_t *batch, const uint32_t base)
+{
+    uint64_t instructions = 0u;
+    uint8_t clamped;
+
+    /* Lanes further behind than one budget go round again. */
+    do
+    {
+        instructions += M6502_Lanes_Pass(batch, base, &clamped);
+    } while (clamped);
+
+    return instructions;
+}
+#endif
+
+uint64_t M6502_RunBatch(M6502_Batch_t *batch, const uint32_t cycles)
+{
+    uint64_t instructions = 0u;
+
+    batch->clock += cycles;
+
+#ifdef M6502_BATCH_SIMD
+    for (uint32_t base = 0u; base < batch->count; base += M6502_BATCH_LANES)
+    {
+        instructions += M6502_Lanes_Run(batch, base);
+    }
+#else
+    M6502_t *cpu = &batch->cpu;
+
+    /* One instance at a time for the whole budget, so its registers stay in the scratch CPU. */
+    for (uint32_t index = 0u; index < batch->count; ++index)
+    {
+        M6502_GetBatchCpu(batch, index, cpu);
+
+        while (cpu->totalCycles < batch->clock)
         {
-            M6502_Address_ZeroPageX(cpu);
-            M6502_Opcode_NOP(cpu);
-            return;
+            instructions += M6502_Batch_Execute(batch, cpu);
         }
-        case 0x0Cu:
+
+        M6502_SetBatchCpu(batch, index, cpu);
+    }
+#endif
+
+    batch->instructions += instructions;
+
+    return instructions;
+}
+#endif
+
+#ifdef M6502_JOBS
+void M6502_InitJobPool(M6502_JobPool_t *pool)
+{
+    pool->jobs          = NULL;
+    pool->results       = NULL;
+    pool->count         = 0u;
+    pool->workerCount   = 0u;
+}
+
+int M6502_AddJobWorker(M6502_JobPool_t *pool, uint8_t *arena, const int core)
+{
+    if (pool->workerCount >= M6502_JOB_WORKERS)
+    {
+        return -1;
+    }
+
+    const uint32_t index = pool->workerCount++;
+    M6502_JobWorker_t *worker = &pool->workers[index];
+
+    worker->range           = 0u;
+    worker->arena           = arena;
+    worker->core            = core;
+    worker->jobs            = 0u;
+    worker->steals          = 0u;
+    worker->instructions    = 0u;
+    worker->pool            = pool;
+
+    return (int)index;
+}
+
+/* Runs one job in the worker's arena until it stops, traps, jams or runs out of cycles. */
+static uint64_t M6502_Job_Run(M6502_t *cpu, const M6502_Job_t *job, M6502_JobResult_t *result)
+{
+    uint64_t instructions = 0u;
+    M6502_JobStatus_t status;
+
+    memcpy(cpu->memory, job->image, 0x10000u);
+    M6502_Init(cpu);
+
+    /* The job starts at its entry point, not the reset vector, and is not charged for the reset. */
+    cpu->programCounter = job->entry;
+    cpu->cycles         = 0u;
+
+    for (;;)
+    {
+        if (cpu->programCounter == job->stopAddress)
         {
-            M6502_Address_Absolute(cpu);
-            M6502_Opcode_NOP(cpu);
-            return;
+            status = M6502_JobStatus_Stopped;
+            break;
         }
-        case 0x1Cu: 
+
+        if ((job->maxCycles != 0u) && (cpu->totalCycles >= job->maxCycles))
         {
-            M6502_Address_AbsoluteX(cpu);
-            M6502_Opcode_NOP(cpu);
-            return;
+            status = M6502_JobStatus_Timeout;
+            break;
         }
-        case 0x3Cu:
+
+        const uint16_t previousProgramCounter = cpu->programCounter;
+
+        M6502_Execute(cpu);
+
+        cpu->totalCycles += cpu->cycles;
+        cpu->cycles = 0u;
+        ++instructions;
+
+        if (cpu->jammed == 0xFFu)
         {
-            M6502_Address_AbsoluteX(cpu);
-            M6502_Opcode_NOP(cpu);
-            return;
+            status = M6502_JobStatus_Jammed;
+            break;
         }
-        case 0x5Cu:
+
+        if (cpu->programCounter == previousProgramCounter)
         {
-            M6502_Address_AbsoluteX(cpu);
-            M6502_Opcode_NOP(cpu);
-            return;
+            status = M6502_JobStatus_Trapped;
+            break;
         }
-        case 0x7Cu:
+    }
+
+    result->status          = status;
+    result->programCounter  = cpu->programCounter;
+    result->accumulator     = cpu->accumulator;
+    result->xRegister       = cpu->xRegister;
+    result->yRegister       = cpu->yRegister;
+    result->stackPointer    = cpu->stackPointer;
+    result->statusRegister  = M6502_PackStatus(cpu);
+    result->cycles          = cpu->totalCycles;
+    result->instructions    = instructions;
+
+    return instructions;
+}
+
+/* Pops the next job off the bottom of the worker's own range. */
+static uint8_t M6502_Job_Take(M6502_JobWorker_t *worker, uint32_t *job)
+{
+    uint64_t range = __atomic_load_n(&worker->range, __ATOMIC_ACQUIRE);
+
+    for (;;)
+    {
+        const uint32_t begin    = (uint32_t)range;
+        const uint32_t end      = (uint32_t)(range >> 32u);
+
+        if (begin >= end)
         {
-            M6502_Address_AbsoluteX(cpu);
-            M6502_Opcode_NOP(cpu);
-            return;
+            return 0u;
         }
-        case 0xDCu:
+
+        if (__atomic_compare_exchange_n(&worker->range, &range, range + 1u, 0, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE))
         {
-            M6502_Address_AbsoluteX(cpu);
-            M6502_Opcode_NOP(cpu);
-            return;
+            *job = begin;
+            return 1u;
         }
-        case 0xFCu:
+    }
+}
+
+/* Moves the top half of the victim's range to the thief, whose own range is empty. */
+static uint8_t M6502_Job_Steal(M6502_JobWorker_t *thief, M6502_JobWorker_t *victim)
+{
+    uint64_t range = __atomic_load_n(&victim->range, __ATOMIC_ACQUIRE);
+
+    for (;;)
+    {
+        const uint32_t begin    = (uint32_t)range;
+        const uint32_t end      = (uint32_t)(range >> 32u);
+
+        if (begin >= end)
         {
-            M6502_Address_AbsoluteX(cpu);
-            M6502_Opcode_NOP(cpu);
-            return;
+            return 0u;
         }
 
-        case 0x02u:
+        /* Job indices are handed out once, so a stale range can never match again. */
+        const uint32_t split = end - ((end - begin + 1u) / 2u);
+
+        if (__atomic_compare_exchange_n(&victim->range, &range, ((uint64_t)split << 32u) | begin, 0, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE))
         {
-            M6502_Address_Implied(cpu);
-            M6502_Opcode_JAM(cpu);
-            return;
+            __atomic_store_n(&thief->range, ((uint64_t)end << 32u) | split, __ATOMIC_RELEASE);
+            thief->steals++;
+            return 1u;
         }
-        case 0x12u:
+    }
+}
+
+static void M6502_Job_Work(M6502_JobWorker_t *worker)
+{
+    M6502_JobPool_t *pool = worker->pool;
+    const uint32_t self = (uint32_t)(worker - pool->workers);
+    uint32_t seed = (self + 1u) * 2654435761u;
+    uint32_t job;
+    M6502_t cpu;
+
+    cpu.memory = worker->arena;
+
+    for (;;)
+    {
+        if (M6502_Job_Take(worker, &job))
         {
-            M6502_Address_Implied(cpu);
-            M6502_Opcode_JAM(cpu);
-            return;
+            worker->instructions += M6502_Job_Run(&cpu, &pool->jobs[job], &pool->results[job]);
+            worker->jobs++;
+            continue;
         }
-        case 0x22u:
+
+        /* Out of jobs: try every other worker once, from a random start. Ranges only shrink, so finding none means done. */
+        uint8_t stolen = 0u;
+
+        seed ^= seed << 13u;
+        seed ^= seed >> 17u;
+        seed ^= seed << 5u;
+
+        for (uint32_t step = 0u; (step < pool->workerCount) && !stolen; ++step)
         {
-            M6502_Address_Implied(cpu);
-            M6502_Opcode_JAM(cpu);
-            return;
+            const uint32_t victim = (seed + step) % pool->workerCount;
+
+            if (victim != self)
+            {
+                stolen = M6502_Job_Steal(worker, &pool->workers[victim]);
+            }
         }
-        case 0x32u:
+
+        if (!stolen)
         {
-            M6502_Address_Implied(cpu);
-            M6502_Opcode_JAM(cpu);
-            return;
+            break;
         }
-        case 0x42u:
+    }
+}
+
+static void *M6502_Job_Thread(void *argument)
+{
+    M6502_JobWorker_t *worker = (M6502_JobWorker_t *)argument;
+
+#ifdef CPU_SET
+    /* Pinning needs _GNU_SOURCE before the first system header; without it the thread floats. */
+    if (worker->core >= 0)
+    {
+        cpu_set_t set;
+
+        CPU_ZERO(&set);
+        CPU_SET(worker->core, &set);
+        pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+    }
+#endif
+
+    M6502_Job_Work(worker);
+
+    return NULL;
+}
+
+uint64_t M6502_RunJobs(M6502_JobPool_t *pool, const M6502_Job_t *jobs, M6502_JobResult_t *results, const uint32_t count)
+{
+    pthread_t threads[M6502_JOB_WORKERS];
+    uint8_t spawned[M6502_JOB_WORKERS];
+    const uint32_t workerCount = pool->workerCount;
+    uint64_t instructions = 0u;
+
+    pool->jobs      = jobs;
+    pool->results   = results;
+    pool->count     = count;
+
+    /* An even split up front; stealing evens out jobs that run long. */
+    for (uint32_t index = 0u; index < workerCount; ++index)
+    {
+        M6502_JobWorker_t *worker = &pool->workers[index];
+        const uint32_t begin    = (uint32_t)(((uint64_t)count * index) / workerCount);
+        const uint32_t end      = (uint32_t)(((uint64_t)count * (index + 1u)) / workerCount);
+
+        worker->range           = ((uint64_t)end << 32u) | begin;
+        worker->jobs            = 0u;
+        worker->steals          = 0u;
+        worker->instructions    = 0u;
+    }
+
+    for (uint32_t index = 0u; index < workerCount; ++index)
+    {
+        spawned[index] = (pthread_create(&threads[index], NULL, M6502_Job_Thread, &pool->workers[index]) == 0);
+    }
+
+    /* Workers without a thread run on the caller, unpinned. */
+    for (uint32_t index = 0u; index < workerCount; ++index)
+    {
+        if (!spawned[index])
         {
-            M6502_Address_Implied(cpu);
-            M6502_Opcode_JAM(cpu);
-            return;
+            M6502_Job_Work(&pool->workers[index]);
         }
-        case 0x52u:
+    }
+
+    for (uint32_t index = 0u; index < workerCount; ++index)
+    {
+        if (spawned[index])
         {
-            M6502_Address_Implied(cpu);
-            M6502_Opcode_JAM(cpu);
-            return;
+            pthread_join(threads[index], NULL);
         }
-        case 0x62u:
+
+        instructions += pool->workers[index].instructions;
+    }
+
+    return instructions;
+}
+#endif
+
+#if defined(M6502_SYSTEM) || defined(M6502_PARALLEL)
+/* Runs one whole instruction, with totalCycles current at every access so a sync or message knows when it happens; returns 0 when none ran. */
+static uint32_t M6502_Timed_Execute(M6502_t *cpu, const uint64_t until)
+{
+#ifdef M6502_SCHEDULER
+    M6502_Scheduler_Fire(cpu);
+#endif
+
+#ifdef M6502_ATOMIC
+    M6502_Requests_Take(cpu);
+#endif
+
+#ifdef M6502_STALL
+    if ((cpu->pendingInterrupts & M6502_ATTENTION_STALL) != 0u)
+    {
+        const uint64_t left = until - cpu->totalCycles;
+
+        cpu->totalCycles += M6502_Stall_Skip(cpu, 0u, (left > UINT32_MAX) ? UINT32_MAX : (uint32_t)left);
+        return 0u;
+    }
+#endif
+
+    if (cpu->jammed == 0xFFu)
+    {
+        cpu->totalCycles = until;
+        return 0u;
+    }
+
+    M6502_Execute(cpu);
+
+    cpu->totalCycles += cpu->cycles;
+    cpu->cycles = 0u;
+
+    return 1u;
+}
+#endif
+
+#ifdef M6502_SYSTEM
+static inline uint8_t M6502_System_Shared(const M6502_System_t *system, const uint16_t address)
+{
+    return (uint8_t)((system->sharedMap[address >> 3u] >> (address & 7u)) & 1u);
+}
+
+static uint8_t M6502_System_Read(void *context, const uint16_t address)
+{
+    M6502_System_t *system = (M6502_System_t *)context;
+
+    if (M6502_System_Shared(system, address))
+    {
+        M6502_SyncSystem(system);
+    }
+
+    return system->bus.read(system->bus.context, address);
+}
+
+static void M6502_System_Write(void *context, const uint16_t address, const uint8_t value)
+{
+    M6502_System_t *system = (M6502_System_t *)context;
+
+    if (M6502_System_Shared(system, address))
+    {
+        M6502_SyncSystem(system);
+    }
+
+    system->bus.write(system->bus.context, address, value);
+}
+
+/* Followers advance furthest behind first, so their own shared accesses stay in order among themselves. */
+static void M6502_System_CatchUp(M6502_System_t *system, const uint64_t until)
+{
+    for (;;)
+    {
+        M6502_t *behind = NULL;
+
+        for (uint32_t index = 1u; index < system->count; ++index)
         {
-            M6502_Address_Implied(cpu);
-            M6502_Opcode_JAM(cpu);
-            return;
+            M6502_t *cpu = system->cpus[index];
+
+            if ((cpu->totalCycles < until) && ((behind == NULL) || (cpu->totalCycles < behind->totalCycles)))
+            {
+                behind = cpu;
+            }
         }
-        case 0x72u:
+
+        if (behind == NULL)
         {
-            M6502_Address_Implied(cpu);
-            M6502_Opcode_JAM(cpu);
             return;
         }
-        case 0x92u:
+
+        M6502_Timed_Execute(behind, until);
+    }
+}
+
+void M6502_InitSystem(M6502_System_t *system, const uint32_t quantum)
+{
+    system->count   = 0u;
+    system->quantum = quantum;
+    system->clock   = 0u;
+    system->syncs   = 0u;
+
+    memset(system->sharedMap, 0, sizeof(system->sharedMap));
+}
+
+int M6502_AddSystemCpu(M6502_System_t *system, M6502_t *cpu)
+{
+    if (system->count >= M6502_SYSTEM_CPUS)
+    {
+        return -1;
+    }
+
+    const uint32_t index = system->count++;
+
+    /* Cycles still owed by the last instruction (or the reset) are charged up front, like M6502_Run does. */
+    cpu->totalCycles += cpu->cycles;
+    cpu->cycles = 0u;
+
+    if (index == 0u)
+    {
+        /* Only the leader's accesses are watched; its own bus is called through the system. */
+        system->bus         = cpu->bus;
+        system->clock       = cpu->totalCycles;
+        cpu->bus.read       = M6502_System_Read;
+        cpu->bus.write      = M6502_System_Write;
+        cpu->bus.context    = system;
+    }
+
+    system->cpus[index] = cpu;
+
+    return (int)index;
+}
+
+void M6502_SetShared(M6502_System_t *system, const uint16_t address, const uint32_t length, const uint8_t shared)
+{
+    for (uint32_t offset = 0u; (offset < length) && (((uint32_t)address + offset) < 0x10000u); ++offset)
+    {
+        const uint16_t current = (uint16_t)(address + offset);
+
+        if (shared != 0u)
         {
-            M6502_Address_Implied(cpu);
-            M6502_Opcode_JAM(cpu);
-            return;
+            system->sharedMap[current >> 3u] |= (uint8_t)(1u << (current & 7u));
         }
-        case 0xB2u:
+        else
         {
-            M6502_Address_Implied(cpu);
-            M6502_Opcode_JAM(cpu);
-            return;
+            system->sharedMap[current >> 3u] &= (uint8_t)~(1u << (current & 7u));
         }
-        case 0xD2u:
+    }
+}
+
+void M6502_SyncSystem(M6502_System_t *system)
+{
+    if (system->count == 0u)
+    {
+        return;
+    }
+
+    system->syncs++;
+
+    /* Mid-instruction, the leader's totalCycles is still the start of that instruction. */
+    M6502_System_CatchUp(system, system->cpus[0]->totalCycles);
+}
+
+uint32_t M6502_RunSystem(M6502_System_t *system, const uint32_t cycles)
+{
+    if (system->count == 0u)
+    {
+        return 0u;
+    }
+
+    M6502_t *leader = system->cpus[0];
+    const uint64_t start = leader->totalCycles;
+
+    system->clock += cycles;
+
+    while (leader->totalCycles < system->clock)
+    {
+        const uint64_t left = system->clock - leader->totalCycles;
+        const uint64_t until = leader->totalCycles + (((system->quantum != 0u) && (system->quantum < left)) ? system->quantum : left);
+
+        while (leader->totalCycles < until)
         {
-            M6502_Address_Implied(cpu);
-            M6502_Opcode_JAM(cpu);
-            return;
+            M6502_Timed_Execute(leader, until);
+
+            if ((leader->pendingInterrupts & M6502_ATTENTION_STOP) != 0u)
+            {
+                break;
+            }
         }
-        case 0xF2u:
+
+        M6502_System_CatchUp(system, leader->totalCycles);
+
+        if ((leader->pendingInterrupts & M6502_ATTENTION_STOP) != 0u)
         {
-            M6502_Address_Implied(cpu);
-            M6502_Opcode_JAM(cpu);
-            return;
+            /* A stop ends this call only; the next one starts from where the leader stopped. */
+            leader->pendingInterrupts &= ~M6502_ATTENTION_STOP;
+            system->clock = leader->totalCycles;
+            break;
         }
+    }
+
+    return (uint32_t)(leader->totalCycles - start);
+}
+#endif
+
+#ifdef M6502_PARALLEL
+/* Largest latency whose in-flight messages always fit a queue: up to two latencies' worth plus one instruction. */
+static const uint32_t M6502_PARALLEL_MAX_LATENCY = (M6502_PARALLEL_QUEUE - 16u) / 2u;
+
+/* Earliest message queued for the node; every queue is already in send order. */
+static uint64_t M6502_Parallel_Due(const M6502_ParallelNode_t *node)
+{
+    M6502_Parallel_t *system = node->system;
+    const uint32_t self = (uint32_t)(node - system->nodes);
+    uint64_t due = UINT64_MAX;
 
-        case 0x4Bu:
+    for (uint32_t from = 0u; from < system->count; ++from)
+    {
+        const M6502_Queue_t *queue = &system->queues[from][self];
+        const uint32_t head = queue->head;
+
+        if ((head != __atomic_load_n(&queue->tail, __ATOMIC_ACQUIRE))
+        && (queue->messages[head & (M6502_PARALLEL_QUEUE - 1u)].when < due))
         {
-            M6502_Address_Immediate(cpu);
-            M6502_Opcode_ALR(cpu);
-            return;
+            due = queue->messages[head & (M6502_PARALLEL_QUEUE - 1u)].when;
         }
+    }
 
-        case 0x0Bu:
-        case 0x2Bu:
+    return due;
+}
+
+/* Reads the other CPUs' clocks first, so every message that could fall due before the new horizon is already queued. */
+static void M6502_Parallel_Refresh(M6502_ParallelNode_t *node)
+{
+    M6502_Parallel_t *system = node->system;
+    uint64_t horizon = UINT64_MAX;
+
+    for (uint32_t index = 0u; index < system->count; ++index)
+    {
+        if (&system->nodes[index] != node)
         {
-            M6502_Address_Immediate(cpu);
-            M6502_Opcode_ANC(cpu);
-            return;
+            const uint64_t time = __atomic_load_n(&system->nodes[index].time, __ATOMIC_ACQUIRE) + system->latency;
+
+            if (time < horizon)
+            {
+                horizon = time;
+            }
         }
+    }
+
+    node->horizon   = horizon;
+    node->due       = M6502_Parallel_Due(node);
+}
 
+/* Hands over every message due by now, oldest first and lower sender first on a tie, so the order never depends on the threads. */
+static void M6502_Parallel_Deliver(M6502_ParallelNode_t *node)
+{
+    M6502_Parallel_t *system = node->system;
+    const uint32_t self = (uint32_t)(node - system->nodes);
+
+    for (;;)
+    {
+        M6502_Queue_t *earliest = NULL;
 
-        case 0x8Bu:
+        for (uint32_t from = 0u; from < system->count; ++from)
         {
-            M6502_Address_Immediate(cpu);
-            M6502_Opcode_ANE(cpu);
-            return;
+            M6502_Queue_t *queue = &system->queues[from][self];
+            const uint32_t head = queue->head;
+
+            if ((head != __atomic_load_n(&queue->tail, __ATOMIC_ACQUIRE))
+            && (queue->messages[head & (M6502_PARALLEL_QUEUE - 1u)].when <= node->cpu->totalCycles)
+            && ((earliest == NULL)
+            || (queue->messages[head & (M6502_PARALLEL_QUEUE - 1u)].when < earliest->messages[earliest->head & (M6502_PARALLEL_QUEUE - 1u)].when)))
+            {
+                earliest = queue;
+            }
         }
 
-        case 0x6Bu:
+        if (earliest == NULL)
         {
-            M6502_Address_Immediate(cpu);
-            M6502_Opcode_ARR(cpu);
-            return;
+            break;
         }
 
-        case 0xBBu:
+        const M6502_Message_t message = earliest->messages[earliest->head & (M6502_PARALLEL_QUEUE - 1u)];
+
+        __atomic_store_n(&earliest->head, earliest->head + 1u, __ATOMIC_RELEASE);
+
+        if (node->deliver != NULL)
         {
-            M6502_Address_AbsoluteY(cpu);
-            M6502_Opcode_LAS(cpu);
-            return;
+            node->deliver(node->cpu, node->context, &message);
         }
+    }
+
+    node->due = M6502_Parallel_Due(node);
+}
+
+/* Runs the node as far as the other CPUs' clocks allow; returns 0 once it has reached the target, 1 when it has to wait. */
+static uint8_t M6502_Parallel_Advance(M6502_ParallelNode_t *node, const uint64_t target)
+{
+    M6502_t *cpu = node->cpu;
 
-        case 0xABu:
+    while (cpu->totalCycles < target)
+    {
+        if (cpu->totalCycles >= node->horizon)
         {
-            M6502_Address_Immediate(cpu);
-            M6502_Opcode_LXA(cpu);
-            return;
+            M6502_Parallel_Refresh(node);
+
+            if (cpu->totalCycles >= node->horizon)
+            {
+                return 1u;
+            }
         }
 
-        case 0xCBu:
+        if (cpu->totalCycles >= node->due)
         {
-            M6502_Address_Immediate(cpu);
-            M6502_Opcode_SBX(cpu);
-            return;
+            M6502_Parallel_Deliver(node);
         }
 
-        case 0x9Fu:
+        /* A jammed or stalled CPU skips ahead, but never past a delivery. */
+        uint64_t limit = (node->horizon < target) ? node->horizon : target;
+
+        if (node->due < limit)
         {
-            M6502_Address_AbsoluteY(cpu);
-            M6502_Opcode_SHA(cpu);
-            return;
+            limit = node->due;
         }
 
-        case 0x93u:
+        node->instructions += M6502_Timed_Execute(cpu, limit);
+
+        __atomic_store_n(&node->time, cpu->totalCycles, __ATOMIC_RELEASE);
+    }
+
+    return 0u;
+}
+
+static void *M6502_Parallel_Thread(void *argument)
+{
+    M6502_ParallelNode_t *node = (M6502_ParallelNode_t *)argument;
+
+    while (M6502_Parallel_Advance(node, node->system->clock))
+    {
+        sched_yield();
+    }
+
+    return NULL;
+}
+
+void M6502_InitParallel(M6502_Parallel_t *system, const uint32_t latency)
+{
+    system->count   = 0u;
+    system->clock   = 0u;
+    /* Without any latency no CPU could run ahead of another. */
+    system->latency = (latency == 0u) ? 1u : (latency > M6502_PARALLEL_MAX_LATENCY) ? M6502_PARALLEL_MAX_LATENCY : latency;
+
+    memset(system->queues, 0, sizeof(system->queues));
+}
+
+int M6502_AddParallelCpu(M6502_Parallel_t *system, M6502_t *cpu, M6502_DeliverHandler_t deliver, void *context)
+{
+    if (system->count >= M6502_PARALLEL_CPUS)
+    {
+        return -1;
+    }
+
+    const uint32_t index = system->count++;
+    M6502_ParallelNode_t *node = &system->nodes[index];
+
+    /* Cycles still owed by the last instruction (or the reset) are charged up front, like M6502_Run does. */
+    cpu->totalCycles += cpu->cycles;
+    cpu->cycles = 0u;
+
+    if ((index == 0u) || (cpu->totalCycles > system->clock))
+    {
+        system->clock = cpu->totalCycles;
+    }
+
+    node->time          = cpu->totalCycles;
+    node->cpu           = cpu;
+    node->deliver       = deliver;
+    node->context       = context;
+    node->horizon       = 0u;
+    node->due           = 0u;
+    node->instructions  = 0u;
+    node->system        = system;
+
+    return (int)index;
+}
+
+int M6502_PostMessage(M6502_Parallel_t *system, const uint32_t from, const uint32_t to, const uint16_t address, const uint8_t value)
+{
+    if ((from >= system->count) || (to >= system->count) || (from == to))
+    {
+        return -1;
+    }
+
+    M6502_Queue_t *queue = &system->queues[from][to];
+    const uint32_t tail = queue->tail;
+
+    /* Cannot happen while the latency stays within M6502_PARALLEL_MAX_LATENCY. */
+    if ((tail - __atomic_load_n(&queue->head, __ATOMIC_ACQUIRE)) >= M6502_PARALLEL_QUEUE)
+    {
+        return -1;
+    }
+
+    M6502_Message_t *message = &queue->messages[tail & (M6502_PARALLEL_QUEUE - 1u)];
+
+    /* Mid-instruction, the sender's totalCycles is still the start of that instruction. */
+    message->when       = system->nodes[from].cpu->totalCycles + system->latency;
+    message->address    = address;
+    message->value      = value;
+    message->from       = (uint8_t)from;
+
+    __atomic_store_n(&queue->tail, tail + 1u, __ATOMIC_RELEASE);
+
+    return 0;
+}
+
+uint64_t M6502_RunParallel(M6502_Parallel_t *system, const uint32_t cycles, const uint8_t threaded)
+{
+    pthread_t threads[M6502_PARALLEL_CPUS];
+    uint8_t spawned[M6502_PARALLEL_CPUS] = { 0u };
+    uint8_t anySpawned = 0u;
+    uint64_t instructions = 0u;
+
+    system->clock += cycles;
+
+    for (uint32_t index = 0u; index < system->count; ++index)
+    {
+        system->nodes[index].horizon        = 0u;
+        system->nodes[index].due            = 0u;
+        system->nodes[index].instructions   = 0u;
+    }
+
+    if (threaded)
+    {
+        for (uint32_t index = 0u; index < system->count; ++index)
         {
-            M6502_Address_IndirectY(cpu);
-            M6502_Opcode_SHA(cpu);
-            return;
+            spawned[index] = (pthread_create(&threads[index], NULL, M6502_Parallel_Thread, &system->nodes[index]) == 0);
+            anySpawned |= spawned[index];
         }
+    }
+
+    /* CPUs without a thread take turns on the caller; the one furthest behind can always move. */
+    for (;;)
+    {
+        uint8_t waiting = 0u;
 
-        case 0x9Cu: 
+        for (uint32_t index = 0u; index < system->count; ++index)
         {
-            M6502_Address_AbsoluteX(cpu);
-            M6502_Opcode_SHY(cpu);
-            return;
+            if (!spawned[index])
+            {
+                waiting |= M6502_Parallel_Advance(&system->nodes[index], system->clock);
+            }
         }
-        case 0x9Eu:
+
+        if (!waiting)
         {
-            M6502_Address_AbsoluteY(cpu);
-            M6502_Opcode_SHX(cpu);
-            return;
+            break;
         }
 
-        case 0x9Bu:
+        if (anySpawned)
         {
-            M6502_Address_AbsoluteY(cpu);
-            M6502_Opcode_TAS(cpu);
-            return;
+            sched_yield();
         }
+    }
 
-        case 0xEBu:
+    for (uint32_t index = 0u; index < system->count; ++index)
+    {
+        if (spawned[index])
         {
-            M6502_Address_Immediate(cpu);
-            M6502_Opcode_USBC(cpu);
-            return;
+            pthread_join(threads[index], NULL);
         }
-    
-        default:                            break;
+
+        instructions += system->nodes[index].instructions;
     }
 
-    switch(cpu->opcode & 0x3u)
+    return instructions;
+}
+#endif
+
+#ifdef M6502_IDLE_SKIP
+void M6502_SetIdleSafe(M6502_t *cpu, const uint16_t address, const uint32_t length, const uint8_t idleSafe)
+{
+    const uint32_t firstPage    = ((uint32_t)address + 0xFFu) >> 8u;
+    const uint32_t endPage      = ((uint32_t)address + length) >> 8u;
+
+    for (uint32_t page = firstPage; (page < endPage) && (page < 0x100u); ++page)
     {
-        case 0x01u:  M6502_Opcode_Group01(cpu);  break;
-        case 0x02u:  M6502_Opcode_Group10(cpu);  break;
-        case 0x03u:  M6502_Opcode_Group11(cpu);  break;
-        case 0x00u:  M6502_Opcode_Group00(cpu);  break;
-        default:                                break;
+        cpu->idleSafe[page] = (idleSafe != 0u) ? 1u : 0u;
     }
+
+    cpu->idleValid = 0u;
 }
+#endif
 
-static inline void M6502_Opcode_Group01(M6502_t *cpu)
+#ifdef M6502_SIDE_EFFECT_FREE
+void M6502_SetSideEffectFree(M6502_t *cpu, const uint16_t address, const uint32_t length, const uint8_t sideEffectFree)
 {
-    const uint8_t instruction = (cpu->opcode & 0xE0u) >> 5u;
-    const uint8_t addressMode = (cpu->opcode & 0x1Cu) >> 2u;
+    /* Only whole pages are marked, like M6502_MapMemory. */
+    const uint32_t firstPage    = ((uint32_t)address + 0xFFu) >> 8u;
+    const uint32_t endPage      = ((uint32_t)address + length) >> 8u;
 
-    switch(addressMode)
+    for (uint32_t page = firstPage; (page < endPage) && (page < 0x100u); ++page)
     {
-        case 0x00u:  M6502_Address_IndirectX(cpu);    break;
-        case 0x01u:  M6502_Address_ZeroPage(cpu);     break;
-        case 0x02u:  M6502_Address_Immediate(cpu);    break;
-        case 0x03u:  M6502_Address_Absolute(cpu);     break;
-        case 0x04u:  M6502_Address_IndirectY(cpu);    break;
-        case 0x05u:  M6502_Address_ZeroPageX(cpu);    break;
-        case 0x06u:  M6502_Address_AbsoluteY(cpu);    break;
-        case 0x07u:  M6502_Address_AbsoluteX(cpu);    break;
+        cpu->sideEffectFree[page] = (sideEffectFree != 0u) ? 1u : 0u;
     }
 
-    switch (instruction)
+#ifdef M6502_JIT
+    if (cpu->blockCache != NULL)
     {
-        case 0x00u:  M6502_Opcode_ORA(cpu);  break;
-        case 0x01u:  M6502_Opcode_AND(cpu);  break;
-        case 0x02u:  M6502_Opcode_EOR(cpu);  break;
-        case 0x03u:  M6502_Opcode_ADC(cpu);  break;
-        case 0x04u:  M6502_Opcode_STA(cpu);  break;
-        case 0x05u:  M6502_Opcode_LDA(cpu);  break;
-        case 0x06u:  M6502_Opcode_CMP(cpu);  break;
-        case 0x07u:  M6502_Opcode_SBC(cpu);  break;
+        M6502_Jit_Flush(cpu->blockCache);
     }
+#endif
 }
+#endif
 
-static inline void M6502_Opcode_Group10(M6502_t *cpu)
+uint32_t M6502_Run(M6502_t *cpu, const uint32_t cycles)
 {
-    const uint8_t instruction = (cpu->opcode & 0xE0u) >> 5u;
-    const uint8_t addressMode = (cpu->opcode & 0x1Cu) >> 2u;
+#ifdef M6502_SCHEDULER
+    uint32_t elapsed = 0u;
 
-    switch(addressMode)
+    /* Each slice ends at the budget or at the next deadline, whichever comes first. */
+    do
     {
-        case 0x00u:  M6502_Address_Immediate(cpu);   break;
-        case 0x01u:  M6502_Address_ZeroPage(cpu);    break;
-        case 0x02u:  M6502_Address_Accumulator(cpu); break;
-        case 0x03u:  M6502_Address_Absolute(cpu);    break;
-        case 0x05u:  
-        {
-            if(instruction == 4u || instruction == 5u)
-            {
-                M6502_Address_ZeroPageY(cpu);
-                break;
-            }
-            M6502_Address_ZeroPageX(cpu);
-            break;
-        }
-        case 0x07u:
+        M6502_Scheduler_Fire(cpu);
+
+        uint32_t slice = (elapsed < cycles) ? (cycles - elapsed) : 0u;
+
+        if (cpu->eventCount != 0u)
         {
-            if(instruction == 5u)
+            const uint64_t distance = cpu->events[cpu->eventHeap[0]].when - cpu->totalCycles;
+
+            if (distance < slice)
             {
-                M6502_Address_AbsoluteY(cpu);
-                break;
+                slice = (uint32_t)distance;
             }
-            M6502_Address_AbsoluteX(cpu);
-            break;
         }
+
+        const uint32_t ran = M6502_Run_Slice(cpu, slice);
+
+        cpu->totalCycles += ran;
+        elapsed += ran;
+    } while ((elapsed < cycles) && ((cpu->pendingInterrupts & M6502_ATTENTION_STOP) == 0u));
+
+    M6502_Scheduler_Fire(cpu);
+#else
+    const uint32_t elapsed = M6502_Run_Slice(cpu, cycles);
+
+    cpu->totalCycles += elapsed;
+#endif
+
+    /* A stop ends this call only. */
+    cpu->pendingInterrupts &= ~M6502_ATTENTION_STOP;
+
+    return elapsed;
+}
+
+static uint32_t M6502_Run_Slice(M6502_t *cpu, const uint32_t cycles)
+{
+    uint32_t elapsed = (uint32_t)cpu->cycles;
+
+    cpu->cycles = 0u;
+
+#ifdef M6502_IDLE_SKIP
+    /* The host may have changed idle-safe memory between slices. */
+    cpu->idleValid  = 0u;
+    cpu->idleCycles = 0u;
+    cpu->pendingInterrupts &= ~M6502_ATTENTION_IDLE;
+#endif
+
+#ifdef M6502_BLOCK_CACHE
+    if (cpu->blockCache != NULL)
+    {
+        return M6502_BlockCache_Run(cpu, elapsed, cycles);
     }
+#endif
 
-    switch (instruction)
+#ifdef M6502_COMPUTED_GOTO
+    static void *const labels[0x100] = {
+        M6502_OPCODE_TABLE(M6502_OPCODE_LABEL_ENTRY)
+    };
+
+    M6502_DISPATCH();
+
+    M6502_OPCODE_TABLE(M6502_OPCODE_LABEL)
+
+M6502_Label_Slow:
+#ifdef M6502_ATOMIC
+    M6502_Requests_Take(cpu);
+#endif
+
+    if ((cpu->pendingInterrupts & M6502_ATTENTION_STOP) != 0u)
     {
-        case 0x00u:  M6502_Opcode_ASL(cpu);  break;
-        case 0x01u:  M6502_Opcode_ROL(cpu);  break;
-        case 0x02u:  M6502_Opcode_LSR(cpu);  break;
-        case 0x03u:  M6502_Opcode_ROR(cpu);  break;
-        case 0x04u:  M6502_Opcode_STX(cpu);  break;
-        case 0x05u:  M6502_Opcode_LDX(cpu);  break;
-        case 0x06u:  M6502_Opcode_DEC(cpu);  break;
-        case 0x07u:  M6502_Opcode_INC(cpu);  break;
+        return elapsed;
     }
-}
 
-static inline void M6502_Opcode_Group11(M6502_t *cpu)
-{
-    const uint8_t instruction = (cpu->opcode & 0xE0u) >> 5u;
-    const uint8_t addressMode = (cpu->opcode & 0x1Cu) >> 2u;
+#ifdef M6502_IDLE_SKIP
+    if ((cpu->pendingInterrupts & M6502_ATTENTION_IDLE) != 0u)
+    {
+        elapsed = M6502_Idle_Skip(cpu, elapsed, cycles);
+    }
+#endif
+
+#ifdef M6502_STALL
+    if ((cpu->pendingInterrupts & M6502_ATTENTION_STALL) != 0u)
+    {
+        elapsed = M6502_Stall_Skip(cpu, elapsed, cycles);
+    }
+#endif
+
+    if (elapsed >= cycles)
+    {
+        return elapsed;
+    }
+
+    if (cpu->jammed == 0xFFu)
+    {
+        M6502_DummyRead(cpu, M6502_JAMMED_ADDRESS);
+        return cycles;
+    }
 
-    switch(addressMode)
+    M6502_Execute(cpu);
+    M6502_DISPATCH();
+#else
+    while (elapsed < cycles)
     {
-        case 0x00u:  M6502_Address_IndirectX(cpu);   break;
-        case 0x01u:  M6502_Address_ZeroPage(cpu);    break;
-        case 0x02u:  M6502_Address_Immediate(cpu);   break;
-        case 0x03u:  M6502_Address_Absolute(cpu);    break;
-        case 0x04u:  M6502_Address_IndirectY(cpu);   break;
-        case 0x05u:
+        if (M6502_ATTENTION(cpu))
         {
-            if(instruction == 4u || instruction == 5u)
+#ifdef M6502_ATOMIC
+            M6502_Requests_Take(cpu);
+#endif
+
+            if ((cpu->pendingInterrupts & M6502_ATTENTION_STOP) != 0u)
             {
-                M6502_Address_ZeroPageY(cpu);
-                break;
+                return elapsed;
             }
-            M6502_Address_ZeroPageX(cpu);
-            break;
-        }
-        case 0x06u:  M6502_Address_AbsoluteY(cpu);   break;
-        case 0x07u:
-        {
-            if(instruction == 5u)
+
+            if (cpu->jammed == 0xFFu)
             {
-                M6502_Address_AbsoluteY(cpu);
-                break;
+                M6502_DummyRead(cpu, M6502_JAMMED_ADDRESS);
+                return cycles;
             }
-            M6502_Address_AbsoluteX(cpu); 
-            break;
+
+#ifdef M6502_IDLE_SKIP
+            if ((cpu->pendingInterrupts & M6502_ATTENTION_IDLE) != 0u)
+            {
+                elapsed = M6502_Idle_Skip(cpu, elapsed, cycles);
+                continue;
+            }
+#endif
+
+#ifdef M6502_STALL
+            if ((cpu->pendingInterrupts & M6502_ATTENTION_STALL) != 0u)
+            {
+                elapsed = M6502_Stall_Skip(cpu, elapsed, cycles);
+                continue;
+            }
+#endif
         }
-    }
 
-    switch (instruction)
-    {
-        case 0x00u:  M6502_Opcode_SLO(cpu);  break;
-        case 0x01u:  M6502_Opcode_RLA(cpu);  break;
-        case 0x02u:  M6502_Opcode_SRE(cpu);  break;
-        case 0x03u:  M6502_Opcode_RRA(cpu);  break;
-        case 0x04u:  M6502_Opcode_SAX(cpu);  break;
-        case 0x05u:  M6502_Opcode_LAX(cpu);  break;
-        case 0x06u:  M6502_Opcode_DCP(cpu);  break;
-        case 0x07u:  M6502_Opcode_ISC(cpu);  break;
+        M6502_Execute(cpu);
+
+        elapsed += (uint32_t)cpu->cycles;
+        cpu->cycles = 0u;
     }
+
+    return elapsed;
+#endif
 }
 
-static inline void M6502_Opcode_Group00(M6502_t *cpu)
+static inline uint8_t M6502_InterruptDue(M6502_t *cpu)
 {
-    const uint8_t instruction = (cpu->opcode & 0xE0u) >> 5u;
-    const uint8_t addressMode = (cpu->opcode & 0x1Cu) >> 2u;
-
-    switch(addressMode)
+    if ((cpu->pendingInterrupts & M6502_INTERRUPT_NMI) != 0u)
     {
-        case 0x00u:  M6502_Address_Immediate(cpu);       break;
-        case 0x01u:  M6502_Address_ZeroPage(cpu);        break;
-        case 0x03u: 
-        {
-            if(instruction == 0x03u)
-            {
-                M6502_Address_Indirect(cpu);
-                break;
-            }
-            M6502_Address_Absolute(cpu);
-            break;
-        }
-        case 0x04u:  M6502_Opcode_Group00_Branch(cpu);   return;
-        case 0x05u:  M6502_Address_ZeroPageX(cpu);       break;
-        case 0x07u:  M6502_Address_AbsoluteX(cpu);       break;
+        return ((cpu->interruptFlags & M6502_INTERRUPT_NMI) == 0u) ? 1u : 0u;
     }
 
-    switch (instruction)
+    if ((cpu->pendingInterrupts & M6502_INTERRUPT_IRQ) != 0u)
     {
-        case 0x01u:  M6502_Opcode_BIT(cpu);  break;
-        case 0x02u:  M6502_Opcode_JMP(cpu);  break;
-        case 0x03u:  M6502_Opcode_JMP(cpu);  break;
-        case 0x04u:  M6502_Opcode_STY(cpu);  break;
-        case 0x05u:  M6502_Opcode_LDY(cpu);  break;
-        case 0x06u:  M6502_Opcode_CPY(cpu);  break;
-        case 0x07u:  M6502_Opcode_CPX(cpu);  break;
+        return ((cpu->interruptFlags == 0u)
+            && (M6502_GetFlag(cpu, M6502_FLAG_INTERRUPT) == 0u)) ? 1u : 0u;
     }
+
+    return 0u;
 }
 
-static inline void M6502_Opcode_Group00_Branch(M6502_t *cpu)
+static inline void M6502_Execute(M6502_t *cpu)
 {
-    M6502_Address_Relative(cpu);
-
-    const uint8_t branch = (cpu->opcode >> 5u);
+    if ((cpu->pendingInterrupts != 0u) && M6502_InterruptDue(cpu))
+    {
+        M6502_Util_Interrupt(cpu);
+        return;
+    }
 
-    switch (branch)
+#ifdef M6502_HLE
+    if (M6502_Trap_At(cpu, cpu->programCounter))
     {
-        case 0x00u: M6502_Opcode_BPL(cpu); break;
-        case 0x01u: M6502_Opcode_BMI(cpu); break;
-        case 0x02u: M6502_Opcode_BVC(cpu); break;
-        case 0x03u: M6502_Opcode_BVS(cpu); break;
-        case 0x04u: M6502_Opcode_BCC(cpu); break;
-        case 0x05u: M6502_Opcode_BCS(cpu); break;
-        case 0x06u: M6502_Opcode_BNE(cpu); break;
-        case 0x07u: M6502_Opcode_BEQ(cpu); break;
-    
-        default: break;
+        M6502_Trap_Call(cpu);
+        return;
     }
+#endif
+
+    M6502_SetFlag(cpu, M6502_FLAG_UNUSED, 1u);
+
+    cpu->opcode = M6502_ReadMemoryByte(cpu, cpu->programCounter++);
+    cpu->cycles = M6502_OPCODE_CYCLES[cpu->opcode];
+
+    M6502_OPCODE_HANDLERS[cpu->opcode](cpu);
 }
 
 static inline void M6502_Opcode_ADC(M6502_t *cpu)
 {
+#ifdef M6502_DECIMAL_TABLE
+    if (M6502_GetFlag(cpu, M6502_FLAG_DECIMAL) && __atomic_load_n(&M6502_DecimalReady, __ATOMIC_ACQUIRE))
+    {
+        M6502_DecimalTable_Apply(cpu, M6502_DECIMAL_ADC);
+        return;
+    }
+#endif
+
     uint16_t temporary = (uint16_t)cpu->accumulator + cpu->target;
     temporary += M6502_GetFlag(cpu, M6502_FLAG_CARRY);
 
@@ -1287,7 +6351,7 @@ static inline void M6502_Opcode_ASL(M6502_t *cpu)
 {
     if(((cpu->opcode & 0x1Cu) >> 2u) != 0x02u)
     {
-        M6502_DummyWrite(cpu->address, cpu->target);
+        M6502_DummyWrite(cpu, cpu->address, cpu->target);
     }
 
     const uint16_t temporary = (cpu->target << 1u);
@@ -1328,8 +6392,8 @@ static inline void M6502_Opcode_BIT(M6502_t *cpu)
     const uint16_t temporary = ((uint16_t)cpu->accumulator & cpu->target);
 
     M6502_ZeroTest(cpu, temporary);
-    cpu->statusRegister = (cpu->statusRegister & 0x3Fu);
-    cpu->statusRegister |= (uint8_t)(cpu->target & 0xC0u);
+    M6502_SetFlag(cpu, M6502_FLAG_NEGATIVE, (uint8_t)(cpu->target & M6502_FLAG_NEGATIVE));
+    M6502_SetFlag(cpu, M6502_FLAG_OVERFLOW, (uint8_t)(cpu->target & M6502_FLAG_OVERFLOW));
 }
 
 static inline void M6502_Opcode_BMI(M6502_t *cpu)
@@ -1358,13 +6422,13 @@ static inline void M6502_Opcode_BPL(M6502_t *cpu)
 
 static inline void M6502_Opcode_BRK(M6502_t *cpu)
 {
-    M6502_DummyRead(cpu->programCounter++);
+    M6502_DummyRead(cpu, cpu->programCounter++);
 
     M6502_PushWord(cpu, cpu->programCounter);
-    M6502_PushByte(cpu, (cpu->statusRegister | M6502_FLAG_BREAK));
+    M6502_PushByte(cpu, (M6502_PackStatus(cpu) | M6502_FLAG_BREAK));
     M6502_SetFlag(cpu, M6502_FLAG_INTERRUPT, 1u);
 
-    cpu->programCounter = M6502_ReadMemoryWord(M6502_IRQVECTOR_ADDRESS);
+    cpu->programCounter = M6502_ReadMemoryWord(cpu, M6502_IRQVECTOR_ADDRESS);
 }
 
 static inline void M6502_Opcode_BVC(M6502_t *cpu)
@@ -1434,7 +6498,7 @@ static inline void M6502_Opcode_DEC(M6502_t *cpu)
 {
     const uint16_t temporary = cpu->target - 1u;
 
-    M6502_DummyWrite(cpu->address, cpu->target);
+    M6502_DummyWrite(cpu, cpu->address, cpu->target);
 
     M6502_Util_WriteResult(cpu, temporary);
 
@@ -1472,7 +6536,7 @@ static inline void M6502_Opcode_INC(M6502_t *cpu)
 {
     const uint16_t temporary = cpu->target + 1u;
 
-    M6502_DummyWrite(cpu->address, cpu->target);
+    M6502_DummyWrite(cpu, cpu->address, cpu->target);
 
 	M6502_Util_WriteResult(cpu, temporary);
 	
@@ -1498,18 +6562,25 @@ static inline void M6502_Opcode_INY(M6502_t *cpu)
 
 static inline void M6502_Opcode_JMP(M6502_t *cpu)
 {
+#ifdef M6502_IDLE_SKIP
+    if ((cpu->opcode == 0x4Cu) && (cpu->address <= (uint16_t)(cpu->programCounter - 3u)))
+    {
+        M6502_Idle_Arrive(cpu, cpu->programCounter - 3u, cpu->address);
+    }
+#endif
+
     cpu->programCounter = cpu->address;
 }
 
 static inline void M6502_Opcode_JSR(M6502_t *cpu)
 {
-    cpu->address = M6502_ReadMemoryByte(cpu->programCounter++);
+    cpu->address = M6502_ReadMemoryByte(cpu, cpu->programCounter++);
 
-    M6502_DummyRead(M6502_STACK_ADDRESS | cpu->stackPointer);
+    M6502_DummyRead(cpu, M6502_STACK_ADDRESS | cpu->stackPointer);
 
     M6502_PushWord(cpu, cpu->programCounter);
 
-    cpu->address |= M6502_ReadMemoryByte(cpu->programCounter) << 8u;
+    cpu->address |= M6502_ReadMemoryByte(cpu, cpu->programCounter) << 8u;
 
     cpu->programCounter = cpu->address;
 }
@@ -1542,7 +6613,7 @@ static inline void M6502_Opcode_LSR(M6502_t *cpu)
 {
     if(((cpu->opcode & 0x1Cu) >> 2u) != 0x02u)
     {
-        M6502_DummyWrite(cpu->address, cpu->target);
+        M6502_DummyWrite(cpu, cpu->address, cpu->target);
     }
 
 	const uint16_t temporary = (cpu->target >> 1u);
@@ -1577,12 +6648,12 @@ static inline void M6502_Opcode_PHA(M6502_t *cpu)
 
 static inline void M6502_Opcode_PHP(M6502_t *cpu)
 {
-	M6502_PushByte(cpu, (cpu->statusRegister | M6502_FLAG_BREAK));
+	M6502_PushByte(cpu, (M6502_PackStatus(cpu) | M6502_FLAG_BREAK));
 }
 
 static inline void M6502_Opcode_PLA(M6502_t *cpu)
 {
-    M6502_DummyRead(M6502_STACK_ADDRESS | cpu->stackPointer);
+    M6502_DummyRead(cpu, M6502_STACK_ADDRESS | cpu->stackPointer);
 
 	cpu->accumulator = M6502_PullByte(cpu);
 
@@ -1592,16 +6663,16 @@ static inline void M6502_Opcode_PLA(M6502_t *cpu)
 
 static inline void M6502_Opcode_PLP(M6502_t *cpu)
 {
-    M6502_DummyRead(M6502_STACK_ADDRESS | cpu->stackPointer);
+    M6502_DummyRead(cpu, M6502_STACK_ADDRESS | cpu->stackPointer);
 
-	cpu->statusRegister = (M6502_PullByte(cpu) | M6502_FLAG_UNUSED);
+	M6502_UnpackStatus(cpu, (M6502_PullByte(cpu) | M6502_FLAG_UNUSED));
 }
 
 static inline void M6502_Opcode_ROL(M6502_t *cpu)
 {
     if(((cpu->opcode & 0x1Cu) >> 2u) != 0x02u)
     {
-        M6502_DummyWrite(cpu->address, cpu->target);
+        M6502_DummyWrite(cpu, cpu->address, cpu->target);
     }
 
     uint16_t temporary = (cpu->target << 1u);
@@ -1618,7 +6689,7 @@ static inline void M6502_Opcode_ROR(M6502_t *cpu)
 {
     if(((cpu->opcode & 0x1Cu) >> 2u) != 0x02u)
     {
-        M6502_DummyWrite(cpu->address, cpu->target);
+        M6502_DummyWrite(cpu, cpu->address, cpu->target);
     }
 
     uint16_t temporary = (cpu->target >> 1u);
@@ -1642,23 +6713,31 @@ static inline void M6502_Opcode_RTI(M6502_t *cpu)
         cpu->interruptFlags &= ~M6502_INTERRUPT_IRQ;
     }
 
-    M6502_DummyRead(M6502_STACK_ADDRESS | cpu->stackPointer);
+    M6502_DummyRead(cpu, M6502_STACK_ADDRESS | cpu->stackPointer);
 
-    cpu->statusRegister = M6502_PullByte(cpu);
+    M6502_UnpackStatus(cpu, M6502_PullByte(cpu));
     cpu->programCounter = M6502_PullWord(cpu);
 }
 
 static inline void M6502_Opcode_RTS(M6502_t *cpu)
 {
-    M6502_DummyRead(M6502_STACK_ADDRESS | cpu->stackPointer);
+    M6502_DummyRead(cpu, M6502_STACK_ADDRESS | cpu->stackPointer);
 
     cpu->programCounter = M6502_PullWord(cpu);
 
-    M6502_DummyRead(cpu->programCounter++);
+    M6502_DummyRead(cpu, cpu->programCounter++);
 }
 
 static inline void M6502_Opcode_SBC(M6502_t *cpu)
 {
+#ifdef M6502_DECIMAL_TABLE
+    if (M6502_GetFlag(cpu, M6502_FLAG_DECIMAL) && __atomic_load_n(&M6502_DecimalReady, __ATOMIC_ACQUIRE))
+    {
+        M6502_DecimalTable_Apply(cpu, M6502_DECIMAL_SBC);
+        return;
+    }
+#endif
+
     const uint8_t carry = M6502_GetFlag(cpu, M6502_FLAG_CARRY);
     uint16_t temporary = (uint16_t)cpu->accumulator + (cpu->target ^ 0x00FFu);
     temporary += (uint16_t)carry;
@@ -1827,9 +6906,9 @@ static inline void M6502_Opcode_DCP(M6502_t *cpu)
     const uint16_t temporary = cpu->target - 1u;
     const uint16_t compare = (uint16_t)cpu->accumulator - temporary;
 
-    M6502_DummyWrite(cpu->address, cpu->target);
+    M6502_DummyWrite(cpu, cpu->address, cpu->target);
 
-    M6502_WriteMemoryByte(cpu->address, (uint8_t)(temporary & 0x00FFu));
+    M6502_Util_WriteResult(cpu, temporary);
 
     M6502_SetFlag(cpu, M6502_FLAG_CARRY, cpu->accumulator >= (uint8_t)(temporary & 0x00FFu));
     M6502_SetFlag(cpu, M6502_FLAG_ZERO, cpu->accumulator == (uint8_t)(temporary & 0x00FFu));
@@ -1838,11 +6917,11 @@ static inline void M6502_Opcode_DCP(M6502_t *cpu)
 
 static inline void M6502_Opcode_ISC(M6502_t *cpu)
 {
-    M6502_DummyWrite(cpu->address, cpu->target);
+    M6502_DummyWrite(cpu, cpu->address, cpu->target);
 
     const uint16_t temporary = ++cpu->target;
 
-    M6502_WriteMemoryByte(cpu->address, (uint8_t)(temporary & 0x00FFu));
+    M6502_Util_WriteResult(cpu, temporary);
 
     M6502_Opcode_SBC(cpu);
 }
@@ -1885,9 +6964,9 @@ static inline void M6502_Opcode_RLA(M6502_t *cpu)
     uint16_t temporary = (cpu->target << 1u);
     temporary |= M6502_GetFlag(cpu, M6502_FLAG_CARRY);
 
-    M6502_DummyWrite(cpu->address, cpu->target);
+    M6502_DummyWrite(cpu, cpu->address, cpu->target);
 
-    M6502_WriteMemoryByte(cpu->address, (uint8_t)(temporary & 0x00FFu));
+    M6502_Util_WriteResult(cpu, temporary);
 
     M6502_SetFlag(cpu, M6502_FLAG_CARRY, (uint8_t)(cpu->target >> 7u));
 
@@ -1901,11 +6980,11 @@ static inline void M6502_Opcode_RRA(M6502_t *cpu)
     uint16_t temporary = (cpu->target >> 1u);
     temporary |= (M6502_GetFlag(cpu, M6502_FLAG_CARRY) << 7u);
 
-    M6502_DummyWrite(cpu->address, cpu->target);
+    M6502_DummyWrite(cpu, cpu->address, cpu->target);
 
     M6502_SetFlag(cpu, M6502_FLAG_CARRY, (uint8_t)(cpu->target & 0x0001u));
 
-    M6502_WriteMemoryByte(cpu->address, (uint8_t)(temporary & 0x00FFu));
+    M6502_Util_WriteResult(cpu, temporary);
 
     cpu->target = temporary;
 
@@ -1916,7 +6995,7 @@ static inline void M6502_Opcode_SAX(M6502_t *cpu)
 {
     const uint8_t temporary = (cpu->accumulator & cpu->xRegister);
 
-    M6502_WriteMemoryByte(cpu->address, temporary);
+    M6502_Util_WriteResult(cpu, temporary);
 }
 
 static inline void M6502_Opcode_SBX(M6502_t *cpu)
@@ -1938,30 +7017,30 @@ static inline void M6502_Opcode_SHA(M6502_t *cpu)
     uint16_t temporary = ((uint16_t)cpu->xRegister & (uint16_t)cpu->accumulator);
     temporary &= ((cpu->address >> 8u) + 1u);
 
-    M6502_WriteMemoryByte(cpu->address, (uint8_t)(temporary & 0x00FFu));
+    M6502_Util_WriteResult(cpu, temporary);
 }
 
 static inline void M6502_Opcode_SHX(M6502_t *cpu)
 {
     uint16_t temporary = (uint16_t)cpu->xRegister & ((cpu->address >> 8u) + 1u);
 
-    M6502_WriteMemoryByte(cpu->address, (uint8_t)(temporary & 0x00FFu));
+    M6502_Util_WriteResult(cpu, temporary);
 }
 
 static inline void M6502_Opcode_SHY(M6502_t *cpu)
 {
     uint16_t temporary = ((uint16_t)cpu->yRegister & ((cpu->address >> 8u) + 1u));
 
-    M6502_WriteMemoryByte(cpu->address, (uint8_t)(temporary & 0x00FFu));
+    M6502_Util_WriteResult(cpu, temporary);
 }
 
 static inline void M6502_Opcode_SLO(M6502_t *cpu)
 {
     uint16_t temporary = (cpu->target << 1u);
 
-    M6502_DummyWrite(cpu->address, cpu->target);
+    M6502_DummyWrite(cpu, cpu->address, cpu->target);
 
-    M6502_WriteMemoryByte(cpu->address, (uint8_t)(temporary & 0x00FFu));
+    M6502_Util_WriteResult(cpu, temporary);
     M6502_CarryTest(cpu, temporary);
 
     temporary |= (uint16_t)cpu->accumulator;
@@ -1976,10 +7055,10 @@ static inline void M6502_Opcode_SRE(M6502_t *cpu)
 {
     uint16_t temporary = (cpu->target >> 1u);
 
-    M6502_DummyWrite(cpu->address, cpu->target);
+    M6502_DummyWrite(cpu, cpu->address, cpu->target);
 
     M6502_SetFlag(cpu, M6502_FLAG_CARRY, (uint8_t)(cpu->target & 0x0001u));
-    M6502_WriteMemoryByte(cpu->address, (uint8_t)(temporary & 0x00FFu));
+    M6502_Util_WriteResult(cpu, temporary);
 
     temporary ^= (uint16_t)cpu->accumulator;
 
@@ -1995,7 +7074,7 @@ static inline void M6502_Opcode_TAS(M6502_t *cpu)
 
     uint16_t temporary = (cpu->stackPointer & ((cpu->address >> 8u) + 1u));
 
-    M6502_WriteMemoryByte(cpu->address, (uint8_t)(temporary & 0x00FFu));
+    M6502_Util_WriteResult(cpu, temporary);
 }
 
 static inline void M6502_Opcode_USBC(M6502_t *cpu)
@@ -2006,7 +7085,8 @@ static inline void M6502_Opcode_USBC(M6502_t *cpu)
 
 static inline void M6502_Opcode_JAM(M6502_t *cpu)
 {
-    M6502_DummyRead(M6502_JAMMED_ADDRESS - 1u);
+    M6502_DummyRead(cpu, M6502_JAMMED_ADDRESS - 1u);
 
     cpu->jammed = 0xFFu;
+    cpu->pendingInterrupts |= M6502_ATTENTION_JAM;
 }
\ No newline at end of file
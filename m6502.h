@@ -3,7 +3,180 @@
 
 #include <stdint.h>
 
+#if defined(M6502_JIT) && !(defined(__x86_64__) && defined(__linux__) && defined(__GNUC__))
+    #undef M6502_JIT
+#endif
+
+#ifdef M6502_JIT
+    #ifndef M6502_BLOCK_CACHE
+        #define M6502_BLOCK_CACHE
+    #endif
+
+    #ifndef M6502_PAGE_TABLE
+        #define M6502_PAGE_TABLE
+    #endif
+
+    #ifndef M6502_JIT_CODE_SIZE
+        #define M6502_JIT_CODE_SIZE (4u * 1024u * 1024u)
+    #endif
+
+    #ifndef M6502_JIT_THRESHOLD
+        #define M6502_JIT_THRESHOLD 16
+    #endif
+#endif
+
+#if defined(M6502_ATOMIC) && !defined(__GNUC__)
+    #error "M6502_ATOMIC needs the GCC/Clang __atomic builtins"
+#endif
+
+#if defined(M6502_FUSION) && !defined(M6502_BLOCK_CACHE)
+    #define M6502_BLOCK_CACHE
+#endif
+
+#if defined(M6502_BATCH_SIMD) && !defined(__GNUC__)
+    /* The lane kernels are written with GCC/Clang vector extensions. */
+    #undef M6502_BATCH_SIMD
+#endif
+
+#if defined(M6502_BATCH_SIMD) && !defined(M6502_BATCH)
+    #define M6502_BATCH
+#endif
+
+#if defined(M6502_JOBS) && !(defined(__GNUC__) && defined(__unix__))
+    #error "M6502_JOBS needs POSIX threads and the GCC/Clang __atomic builtins"
+#endif
+
+#if defined(M6502_PARALLEL) && !(defined(__GNUC__) && defined(__unix__))
+    #error "M6502_PARALLEL needs POSIX threads and the GCC/Clang __atomic builtins"
+#endif
+
+#if defined(M6502_BATCH) || defined(M6502_JOBS)
+    /* Each instance (or job worker) brings its own 64 KiB image, and the core has one memory mode per build. */
+    #if defined(M6502_BUS) || defined(M6502_SYSTEM) || defined(M6502_PARALLEL)
+        #error "M6502_BATCH and M6502_JOBS run on flat 64 KiB images, which replace M6502_BUS"
+    #endif
+
+    #ifdef M6502_PINS
+        #error "M6502_BATCH and M6502_JOBS run on flat 64 KiB images, which M6502_PINS cannot see"
+    #endif
+
+    #ifndef M6502_FLAT_MEMORY
+        #define M6502_FLAT_MEMORY
+    #endif
+#endif
+
+#ifdef M6502_NES_CPU
+    #undef M6502_DECIMAL_TABLE
+#endif
+
+#ifdef M6502_PINS
+    /* Every access goes out on the pins, one per tick, so nothing may skip or batch them. */
+    #ifdef M6502_FLAT_MEMORY
+        #error "M6502_PINS puts every access on the pins, which M6502_FLAT_MEMORY bypasses"
+    #endif
+
+    #ifdef M6502_SIDE_EFFECT_FREE
+        #error "M6502_PINS puts every dummy access on the pins, which M6502_SIDE_EFFECT_FREE drops"
+    #endif
+
+    #ifdef M6502_IDLE_SKIP
+        #error "M6502_IDLE_SKIP scans the loop through the bus, outside of any tick"
+    #endif
+
+    #ifdef M6502_HLE
+        #error "M6502_HLE trap handlers do not run cycle by cycle"
+    #endif
+
+    #define M6502_PIN_RW        (1u << 24u)
+    #define M6502_PIN_SYNC      (1u << 25u)
+    #define M6502_PIN_IRQ       (1u << 26u)
+    #define M6502_PIN_NMI       (1u << 27u)
+    #define M6502_PIN_RDY       (1u << 28u)
+
+    /* IRQ line source driven by M6502_PIN_IRQ. */
+    #define M6502_IRQ_SOURCE_PIN    (1u << 31u)
+
+    #define M6502_PINS_ADDRESS(pins)        ((uint16_t)((pins) & 0xFFFFu))
+    #define M6502_PINS_DATA(pins)           ((uint8_t)(((pins) >> 16u) & 0xFFu))
+    #define M6502_PINS_SET_DATA(pins, data) (((pins) & ~0x00FF0000u) | ((uint32_t)(data) << 16u))
+#endif
+
+#if defined(M6502_SYSTEM) || defined(M6502_PARALLEL)
+    #ifdef M6502_FLAT_MEMORY
+        #error "M6502_SYSTEM and M6502_PARALLEL see cross-CPU accesses on the bus, which M6502_FLAT_MEMORY bypasses"
+    #endif
+
+    #ifndef M6502_BUS
+        #define M6502_BUS
+    #endif
+#endif
+
+#if defined(M6502_FLAT_MEMORY) && defined(M6502_BUS)
+    #error "M6502_FLAT_MEMORY and M6502_BUS are two memory modes, define one of them"
+#endif
+
+#if defined(M6502_DMA) || defined(M6502_HLE)
+    /* DMA transfers and trap handlers both hold the CPU for a run of cycles, between instructions. */
+    #define M6502_STALL
+#endif
+
+#ifdef M6502_BLOCK_CACHE
+    #ifndef M6502_BLOCK_CACHE_SIZE
+        #define M6502_BLOCK_CACHE_SIZE 2048
+    #endif
+
+    #ifndef M6502_BLOCK_LENGTH
+        #define M6502_BLOCK_LENGTH 32
+    #endif
+
+typedef struct M6502_BlockCache_s M6502_BlockCache_t;
+#endif
+
+#ifdef M6502_SCHEDULER
+    #ifndef M6502_EVENT_COUNT
+        #define M6502_EVENT_COUNT 16
+    #endif
+
+struct M6502_s;
+typedef void (*M6502_EventCallback_t)(struct M6502_s *cpu, void *context);
+
+typedef struct
+{
+    uint64_t                when;
+    M6502_EventCallback_t   callback;
+    void                    *context;
+    uint32_t                sequence;
+    uint8_t                 position;
+} M6502_Event_t;
+#endif
+
+#ifdef M6502_HLE
+    #ifndef M6502_TRAP_COUNT
+        #define M6502_TRAP_COUNT 32
+    #endif
+
+struct M6502_s;
+/* Runs in place of the guest routine and returns the cycles it would have taken, RTS included. */
+typedef uint32_t (*M6502_TrapHandler_t)(struct M6502_s *cpu, void *context);
+
 typedef struct
+{
+    M6502_TrapHandler_t     handler;
+    void                    *context;
+    uint16_t                address;
+} M6502_Trap_t;
+#endif
+
+#ifdef M6502_BUS
+typedef struct
+{
+    uint8_t     (*read)(void *context, uint16_t address);
+    void        (*write)(void *context, uint16_t address, uint8_t value);
+    void        *context;
+} M6502_Bus_t;
+#endif
+
+typedef struct M6502_s
 {
     uint16_t    programCounter;
     uint8_t     xRegister;
@@ -19,15 +192,528 @@ typedef struct
     uint8_t     pendingInterrupts;
     uint16_t    address;
     uint16_t    target;
+    /* Cycles run since M6502_Init, never wraps in practice. */
+    uint64_t    totalCycles;
+    /* Wired-OR IRQ line, one bit per source holding it low, and the NMI line level. */
+    uint32_t    irqLines;
+    uint8_t     nmiLine;
+#ifdef M6502_ATOMIC
+    /* Interrupts and stops posted by other threads, merged into pendingInterrupts by the CPU thread. */
+    uint8_t     requests;
+#endif
+#ifdef M6502_BUS
+    M6502_Bus_t bus;
+#endif
+#ifdef M6502_FLAT_MEMORY
+    uint8_t     *memory;
+#endif
+#ifdef M6502_LAZY_FLAGS
+    uint8_t     negativeResult;
+    uint8_t     zeroResult;
+    uint8_t     carryFlag;
+    uint8_t     overflowFlag;
+#endif
+#ifdef M6502_BLOCK_CACHE
+    M6502_BlockCache_t *blockCache;
+#endif
+#ifdef M6502_IDLE_SKIP
+    uint16_t    idleTarget;
+    uint16_t    idleJump;
+    uint16_t    idleCycles;
+    uint8_t     idleValid;
+    uint8_t     idleState[5];
+    /* Per page: reads cannot change while the CPU spins. */
+    uint8_t     idleSafe[0x100];
+#endif
+#ifdef M6502_SIDE_EFFECT_FREE
+    /* Per page: dummy accesses can be skipped. */
+    uint8_t     sideEffectFree[0x100];
+#endif
+#ifdef M6502_PAGE_TABLE
+    /* Per page: host pointer minus page address, or 0 to use the bus. */
+    uintptr_t   readPages[0x100];
+    uintptr_t   writePages[0x100];
+#endif
+#ifdef M6502_STALL
+    /* Cycles the CPU is held off the bus, plus the pending odd-cycle alignment. */
+    uint32_t            stallCycles;
+    uint8_t             stallAlign;
+#endif
+#ifdef M6502_PINS
+    /* Instruction in progress under M6502_Tick: the cycle cursor, the step of its sequence and the accesses its opcode queued. */
+    uint32_t            pins;
+    uint16_t            pinBase;
+    uint16_t            pinQueueAddress[4];
+    uint8_t             pinQueueData[4];
+    uint8_t             pinQueueRead[4];
+    uint8_t             pinQueueHead;
+    uint8_t             pinQueueCount;
+    uint8_t             pinCycle;
+    uint8_t             pinStep;
+    uint8_t             pinInterrupt;
+    uint8_t             pinTicking;
+    uint8_t             pinNmi;
+    uint8_t             pinResult;
+#endif
+#ifdef M6502_HLE
+    /* One bit per address, so untrapped fetches cost a single test. */
+    uint8_t         trapMap[0x10000 / 8];
+    M6502_Trap_t    traps[M6502_TRAP_COUNT];
+#endif
+#ifdef M6502_SCHEDULER
+    /* Min-heap of event slots ordered by deadline. */
+    M6502_Event_t   events[M6502_EVENT_COUNT];
+    uint8_t         eventHeap[M6502_EVENT_COUNT];
+    uint8_t         eventCount;
+    uint32_t        eventSequence;
+#endif
 } M6502_t;
 
-void M6502_Init(M6502_t *cpu);
-void M6502_Reset(M6502_t *cpu);
-void M6502_Step(M6502_t *cpu);
-void M6502_IRQ(M6502_t *cpu);
-void M6502_NMI(M6502_t *cpu);
+#ifdef M6502_BATCH
+    #ifndef M6502_BATCH_SIZE
+        #define M6502_BATCH_SIZE 64
+    #endif
+
+    #ifdef M6502_BATCH_SIMD
+        #ifndef M6502_BATCH_LANES
+            #define M6502_BATCH_LANES 16
+        #endif
+
+        #if (M6502_BATCH_LANES % 8) != 0
+            #error "M6502_BATCH_LANES must be a multiple of 8"
+        #endif
+
+        #if (M6502_BATCH_SIZE % M6502_BATCH_LANES) != 0
+            #error "M6502_BATCH_SIZE must be a multiple of M6502_BATCH_LANES"
+        #endif
+    #endif
+
+typedef struct
+{
+    /* Structure of arrays: a pass over the batch walks each register array in order. */
+    uint8_t     *memory[M6502_BATCH_SIZE];
+    uint64_t    totalCycles[M6502_BATCH_SIZE];
+    uint16_t    programCounter[M6502_BATCH_SIZE];
+    uint8_t     accumulator[M6502_BATCH_SIZE];
+    uint8_t     xRegister[M6502_BATCH_SIZE];
+    uint8_t     yRegister[M6502_BATCH_SIZE];
+    uint8_t     stackPointer[M6502_BATCH_SIZE];
+    uint8_t     status[M6502_BATCH_SIZE];
+    uint8_t     jammed[M6502_BATCH_SIZE];
+    uint8_t     interruptFlags[M6502_BATCH_SIZE];
+    uint8_t     pendingInterrupts[M6502_BATCH_SIZE];
+    uint32_t    count;
+    /* Every instance runs until its totalCycles reaches the batch clock. */
+    uint64_t    clock;
+    uint64_t    instructions;
+    /* Scratch CPU each instance is loaded into, so the tables stay shared and hot. */
+    M6502_t     cpu;
+} M6502_Batch_t;
+#endif
+
+#ifdef M6502_JOBS
+    #ifndef M6502_JOB_WORKERS
+        #define M6502_JOB_WORKERS 64
+    #endif
+
+typedef enum
+{
+    M6502_JobStatus_Stopped,    /* Reached stopAddress. */
+    M6502_JobStatus_Trapped,    /* An instruction jumped or branched to itself. */
+    M6502_JobStatus_Jammed,
+    M6502_JobStatus_Timeout     /* Ran maxCycles without stopping. */
+} M6502_JobStatus_t;
+
+typedef struct
+{
+    /* 64 KiB copied into the worker's arena before the job starts; shared read-only by any number of jobs. */
+    const uint8_t   *image;
+    uint16_t        entry;
+    uint16_t        stopAddress;
+    /* 0 runs until the job stops, traps or jams. */
+    uint64_t        maxCycles;
+} M6502_Job_t;
+
+typedef struct
+{
+    M6502_JobStatus_t   status;
+    /* The stop address, or the trap PC when trapped. */
+    uint16_t            programCounter;
+    uint8_t             accumulator;
+    uint8_t             xRegister;
+    uint8_t             yRegister;
+    uint8_t             stackPointer;
+    uint8_t             statusRegister;
+    uint64_t            cycles;
+    uint64_t            instructions;
+} M6502_JobResult_t;
+
+typedef struct
+{
+    /* Jobs [begin, end) still queued on this worker, packed as end << 32 | begin; thieves take the top half. */
+    uint64_t    range __attribute__((aligned(64)));
+    uint8_t     *arena;
+    /* Core to pin the thread to, or -1. */
+    int         core;
+    /* Totals for the last M6502_RunJobs. */
+    uint32_t    jobs;
+    uint32_t    steals;
+    uint64_t    instructions;
+    struct M6502_JobPool_s *pool;
+} M6502_JobWorker_t;
+
+typedef struct M6502_JobPool_s
+{
+    const M6502_Job_t   *jobs;
+    M6502_JobResult_t   *results;
+    uint32_t            count;
+    uint32_t            workerCount;
+    M6502_JobWorker_t   workers[M6502_JOB_WORKERS];
+} M6502_JobPool_t;
+#endif
+
+#ifdef M6502_SYSTEM
+    #ifndef M6502_SYSTEM_CPUS
+        #define M6502_SYSTEM_CPUS 4
+    #endif
+
+typedef struct
+{
+    /* The first CPU leads; the others trail it and are rolled forward when it touches a shared address. */
+    M6502_t     *cpus[M6502_SYSTEM_CPUS];
+    uint32_t    count;
+    /* Longest the leader runs ahead without a shared access before the others catch up. */
+    uint32_t    quantum;
+    /* The leader runs until its totalCycles reaches the system clock. */
+    uint64_t    clock;
+    /* Catch-ups triggered by shared accesses and M6502_SyncSystem. */
+    uint64_t    syncs;
+    /* The leader's own bus, called after the shared address check. */
+    M6502_Bus_t bus;
+    /* One bit per address of the leader's map. */
+    uint8_t     sharedMap[0x10000 / 8];
+} M6502_System_t;
+#endif
+
+#ifdef M6502_PARALLEL
+    #ifndef M6502_PARALLEL_CPUS
+        #define M6502_PARALLEL_CPUS 4
+    #endif
+
+    #ifndef M6502_PARALLEL_QUEUE
+        #define M6502_PARALLEL_QUEUE 1024
+    #endif
+
+    #if (M6502_PARALLEL_QUEUE & (M6502_PARALLEL_QUEUE - 1)) != 0
+        #error "M6502_PARALLEL_QUEUE must be a power of two"
+    #endif
+
+typedef struct
+{
+    /* The sender's cycle at the access plus the latency; delivered before the receiver's first instruction at or after it. */
+    uint64_t    when;
+    uint16_t    address;
+    uint8_t     value;
+    uint8_t     from;
+} M6502_Message_t;
+
+typedef void (*M6502_DeliverHandler_t)(struct M6502_s *cpu, void *context, const M6502_Message_t *message);
+
+typedef struct
+{
+    /* Single producer, single consumer: tail belongs to the sender, head to the receiver. */
+    uint32_t        tail __attribute__((aligned(64)));
+    uint32_t        head __attribute__((aligned(64)));
+    M6502_Message_t messages[M6502_PARALLEL_QUEUE];
+} M6502_Queue_t;
+
+typedef struct
+{
+    /* Published after every instruction: nothing this CPU sends from now on is stamped earlier. */
+    uint64_t                time __attribute__((aligned(64)));
+    M6502_t                 *cpu;
+    M6502_DeliverHandler_t  deliver;
+    void                    *context;
+    /* The CPU may run up to, not including, horizon; due is the earliest queued message. */
+    uint64_t                horizon;
+    uint64_t                due;
+    /* Instructions in the last M6502_RunParallel. */
+    uint64_t                instructions;
+    struct M6502_Parallel_s *system;
+} M6502_ParallelNode_t;
+
+typedef struct M6502_Parallel_s
+{
+    M6502_ParallelNode_t    nodes[M6502_PARALLEL_CPUS];
+    /* Indexed [from][to]. */
+    M6502_Queue_t           queues[M6502_PARALLEL_CPUS][M6502_PARALLEL_CPUS];
+    uint32_t                count;
+    /* Minimum cycles between a send and its delivery, the lookahead every CPU may run ahead by. */
+    uint32_t                latency;
+    /* Every CPU runs until its totalCycles reaches the clock. */
+    uint64_t                clock;
+} M6502_Parallel_t;
+#endif
+
+typedef enum
+{
+    M6502_AddressMode_None,
+    M6502_AddressMode_Implied,
+    M6502_AddressMode_Accumulator,
+    M6502_AddressMode_Immediate,
+    M6502_AddressMode_Relative,
+    M6502_AddressMode_Absolute,
+    M6502_AddressMode_AbsoluteX,
+    M6502_AddressMode_AbsoluteY,
+    M6502_AddressMode_ZeroPage,
+    M6502_AddressMode_ZeroPageX,
+    M6502_AddressMode_ZeroPageY,
+    M6502_AddressMode_Indirect,
+    M6502_AddressMode_IndirectX,
+    M6502_AddressMode_IndirectY
+} M6502_AddressMode_t;
+
+typedef enum
+{
+    M6502_Access_None,
+    M6502_Access_Read,
+    M6502_Access_Write,
+    M6502_Access_Modify
+} M6502_Access_t;
+
+typedef enum
+{
+    M6502_Instruction_ADC,
+    M6502_Instruction_AND,
+    M6502_Instruction_ASL,
+    M6502_Instruction_BCC,
+    M6502_Instruction_BCS,
+    M6502_Instruction_BEQ,
+    M6502_Instruction_BIT,
+    M6502_Instruction_BMI,
+    M6502_Instruction_BNE,
+    M6502_Instruction_BPL,
+    M6502_Instruction_BRK,
+    M6502_Instruction_BVC,
+    M6502_Instruction_BVS,
+    M6502_Instruction_CLC,
+    M6502_Instruction_CLD,
+    M6502_Instruction_CLI,
+    M6502_Instruction_CLV,
+    M6502_Instruction_CMP,
+    M6502_Instruction_CPX,
+    M6502_Instruction_CPY,
+    M6502_Instruction_DEC,
+    M6502_Instruction_DEX,
+    M6502_Instruction_DEY,
+    M6502_Instruction_EOR,
+    M6502_Instruction_INC,
+    M6502_Instruction_INX,
+    M6502_Instruction_INY,
+    M6502_Instruction_JMP,
+    M6502_Instruction_JSR,
+    M6502_Instruction_LDA,
+    M6502_Instruction_LDX,
+    M6502_Instruction_LDY,
+    M6502_Instruction_LSR,
+    M6502_Instruction_NOP,
+    M6502_Instruction_ORA,
+    M6502_Instruction_PHA,
+    M6502_Instruction_PHP,
+    M6502_Instruction_PLA,
+    M6502_Instruction_PLP,
+    M6502_Instruction_ROL,
+    M6502_Instruction_ROR,
+    M6502_Instruction_RTI,
+    M6502_Instruction_RTS,
+    M6502_Instruction_SBC,
+    M6502_Instruction_SEC,
+    M6502_Instruction_SED,
+    M6502_Instruction_SEI,
+    M6502_Instruction_STA,
+    M6502_Instruction_STX,
+    M6502_Instruction_STY,
+    M6502_Instruction_TAX,
+    M6502_Instruction_TAY,
+    M6502_Instruction_TSX,
+    M6502_Instruction_TXA,
+    M6502_Instruction_TXS,
+    M6502_Instruction_TYA,
+    M6502_Instruction_ALR,
+    M6502_Instruction_ANC,
+    M6502_Instruction_ANE,
+    M6502_Instruction_ARR,
+    M6502_Instruction_DCP,
+    M6502_Instruction_ISC,
+    M6502_Instruction_LAS,
+    M6502_Instruction_LAX,
+    M6502_Instruction_LXA,
+    M6502_Instruction_RLA,
+    M6502_Instruction_RRA,
+    M6502_Instruction_SAX,
+    M6502_Instruction_SBX,
+    M6502_Instruction_SHA,
+    M6502_Instruction_SHX,
+    M6502_Instruction_SHY,
+    M6502_Instruction_SLO,
+    M6502_Instruction_SRE,
+    M6502_Instruction_TAS,
+    M6502_Instruction_USBC,
+    M6502_Instruction_JAM
+} M6502_Instruction_t;
+
+typedef struct
+{
+    const char  *mnemonic;
+    uint8_t     instruction;
+    uint8_t     addressMode;
+    uint8_t     access;
+    uint8_t     cycles;
+} M6502_OpcodeInfo_t;
+
+void     M6502_Init(M6502_t *cpu);
+void     M6502_Reset(M6502_t *cpu);
+void     M6502_Step(M6502_t *cpu);
+uint32_t M6502_Run(M6502_t *cpu, uint32_t cycles);
+#ifdef M6502_PINS
+uint32_t M6502_Tick(M6502_t *cpu, uint32_t pins);
+#endif
+void     M6502_IRQ(M6502_t *cpu);
+void     M6502_NMI(M6502_t *cpu);
+void     M6502_SetIRQLine(M6502_t *cpu, uint32_t sources, uint8_t asserted);
+void     M6502_SetNMILine(M6502_t *cpu, uint8_t asserted);
+void     M6502_RequestStop(M6502_t *cpu);
+
+uint8_t  M6502_GetStatus(const M6502_t *cpu);
+void     M6502_SetStatus(M6502_t *cpu, uint8_t status);
+
+const M6502_OpcodeInfo_t *M6502_GetOpcodeInfo(uint8_t opcode);
+
+#ifdef M6502_BLOCK_CACHE
+typedef struct
+{
+    void        (*handler)(M6502_t *cpu, uint16_t operand);
+    uint16_t    operand;
+    uint16_t    next;
+    uint8_t     opcode;
+    uint8_t     cycles;
+    /* Non-zero: the op may reach the bus or write, so the run loop checks after it. */
+    uint8_t     check;
+#ifdef M6502_FUSION
+    /* Non-zero: this op and the next one run as one fused handler. */
+    uint8_t     fusion;
+#endif
+} M6502_MicroOp_t;
+
+typedef struct
+{
+    uint16_t        start;
+    uint8_t         firstPage;
+    uint8_t         lastPage;
+    uint32_t        firstGeneration;
+    uint32_t        lastGeneration;
+    uint8_t         length;
+    /* Upper bound: base cycles plus a page crossing or taken branch per op. */
+    uint16_t        cycles;
+#ifdef M6502_JIT
+    uint16_t        hits;
+    uint32_t        (*native)(M6502_t *cpu, uint32_t remaining);
+#endif
+    M6502_MicroOp_t ops[M6502_BLOCK_LENGTH];
+} M6502_Block_t;
 
+struct M6502_BlockCache_s
+{
+    uint16_t        lookup[0x10000];
+    uint32_t        pageGeneration[0x100];
+    uint8_t         codePages[0x100];
+    uint32_t        invalidations;
+    uint16_t        used;
+#ifdef M6502_JIT
+    uint8_t         *code;
+    uint32_t        codeStart;
+    uint32_t        codeUsed;
+    /* Non-zero once the code space could not be mapped or protected: the JIT stays off. */
+    uint8_t         codeFailed;
+#endif
+    M6502_Block_t   blocks[M6502_BLOCK_CACHE_SIZE];
+};
+
+void M6502_AttachBlockCache(M6502_t *cpu, M6502_BlockCache_t *cache);
+void M6502_InvalidateBlockCache(M6502_t *cpu, uint16_t address, uint16_t length);
+#endif
+
+#ifdef M6502_PAGE_TABLE
+void M6502_MapMemory(M6502_t *cpu, uint16_t address, uint32_t length, uint8_t *memory, uint8_t readOnly);
+#endif
+
+#ifdef M6502_DMA
+void M6502_StartDMA(M6502_t *cpu, uint16_t source, uint8_t *destination, uint16_t length);
+void M6502_Stall(M6502_t *cpu, uint32_t cycles);
+#endif
+
+#ifdef M6502_SCHEDULER
+int  M6502_ScheduleEvent(M6502_t *cpu, uint64_t when, M6502_EventCallback_t callback, void *context);
+void M6502_CancelEvent(M6502_t *cpu, int event);
+void M6502_RetimeEvent(M6502_t *cpu, int event, uint64_t when);
+#endif
+
+#ifdef M6502_HLE
+int  M6502_SetTrap(M6502_t *cpu, uint16_t address, M6502_TrapHandler_t handler, void *context);
+void M6502_ClearTrap(M6502_t *cpu, uint16_t address);
+#endif
+
+#ifdef M6502_BATCH
+void     M6502_InitBatch(M6502_Batch_t *batch);
+int      M6502_AddBatchCpu(M6502_Batch_t *batch, uint8_t *memory);
+void     M6502_GetBatchCpu(const M6502_Batch_t *batch, uint32_t index, M6502_t *cpu);
+void     M6502_SetBatchCpu(M6502_Batch_t *batch, uint32_t index, const M6502_t *cpu);
+uint64_t M6502_RunBatch(M6502_Batch_t *batch, uint32_t cycles);
+#endif
+
+#ifdef M6502_JOBS
+void     M6502_InitJobPool(M6502_JobPool_t *pool);
+int      M6502_AddJobWorker(M6502_JobPool_t *pool, uint8_t *arena, int core);
+uint64_t M6502_RunJobs(M6502_JobPool_t *pool, const M6502_Job_t *jobs, M6502_JobResult_t *results, uint32_t count);
+#endif
+
+#ifdef M6502_SYSTEM
+void     M6502_InitSystem(M6502_System_t *system, uint32_t quantum);
+int      M6502_AddSystemCpu(M6502_System_t *system, M6502_t *cpu);
+void     M6502_SetShared(M6502_System_t *system, uint16_t address, uint32_t length, uint8_t shared);
+void     M6502_SyncSystem(M6502_System_t *system);
+uint32_t M6502_RunSystem(M6502_System_t *system, uint32_t cycles);
+#endif
+
+#ifdef M6502_PARALLEL
+void     M6502_InitParallel(M6502_Parallel_t *system, uint32_t latency);
+int      M6502_AddParallelCpu(M6502_Parallel_t *system, M6502_t *cpu, M6502_DeliverHandler_t deliver, void *context);
+int      M6502_PostMessage(M6502_Parallel_t *system, uint32_t from, uint32_t to, uint16_t address, uint8_t value);
+uint64_t M6502_RunParallel(M6502_Parallel_t *system, uint32_t cycles, uint8_t threaded);
+#endif
+
+#ifdef M6502_IDLE_SKIP
+void M6502_SetIdleSafe(M6502_t *cpu, uint16_t address, uint32_t length, uint8_t idleSafe);
+#endif
+
+#ifdef M6502_SIDE_EFFECT_FREE
+void M6502_SetSideEffectFree(M6502_t *cpu, uint16_t address, uint32_t length, uint8_t sideEffectFree);
+#endif
+
+#if !defined(M6502_BUS) && !defined(M6502_FLAT_MEMORY)
 uint8_t  M6502_ExternalReadMemory(uint16_t address);
 void     M6502_ExternalWriteMemory(uint16_t address, uint8_t value);
+#endif
+
+#endif /* __M6502_H__ */
 
-#endif /* __M6502_H__ */
\ No newline at end of file
+/*
+ * Unity build: define M6502_IMPLEMENTATION in exactly one file before
+ * including m6502.h, and m6502.c is compiled into that file. m6502.c still has
+ * to sit next to m6502.h. The bus callbacks may then be static inline functions
+ * declared ahead of the include, and get inlined into the core.
+ */
+#if defined(M6502_IMPLEMENTATION) && !defined(__M6502_IMPLEMENTATION__)
+#define __M6502_IMPLEMENTATION__
+#include "m6502.c"
+#endif
\ No newline at end of file
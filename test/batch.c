@@ -0,0 +1,227 @@
+#define PROGRAM_FILE "6502_functional_test.bin"
+#define PROGRAM_FILE_START 0x0000
+#define PROGRAM_START 0x0400
+#define SUCCESS_PC 0x3469
+
+#ifndef BATCH_SLICE
+    #define BATCH_SLICE 29780
+#endif
+
+#ifndef BATCH_SLICES
+    #define BATCH_SLICES 100
+#endif
+
+/* Lane i starts this many cycles into the functional test, so the lanes sit at different instructions. */
+#ifndef BATCH_STAGGER
+    #define BATCH_STAGGER 7919
+#endif
+
+/* The divergence program runs in short slices, so lanes are compared while they are split. */
+#ifndef DIVERGE_SLICE
+    #define DIVERGE_SLICE 997
+#endif
+
+#ifndef DIVERGE_SLICES
+    #define DIVERGE_SLICES 400
+#endif
+
+#define DIVERGE_START 0x0400
+#define DIVERGE_SUBROUTINE 0x0500
+#define DIVERGE_DATA 0x2000
+#define DIVERGE_OUTPUT 0x3000
+
+#include <string.h>
+
+#include "test.h"
+
+#ifndef M6502_BATCH
+    #error "batch.c needs M6502_BATCH"
+#endif
+
+static uint8_t batchMemory[M6502_BATCH_SIZE][MEMORY_SIZE];
+static uint8_t referenceMemory[M6502_BATCH_SIZE][MEMORY_SIZE];
+static M6502_t reference[M6502_BATCH_SIZE];
+static M6502_Batch_t batch;
+
+static uint16_t cursor;
+
+/* Brings a reference CPU up to the batch clock with plain M6502_Run calls. */
+void RunReference(M6502_t *cpu, const uint64_t clock)
+{
+    while (cpu->totalCycles < clock)
+    {
+        M6502_Run(cpu, (uint32_t)(clock - cpu->totalCycles));
+    }
+}
+
+void CompareLane(const uint32_t index, const uint32_t slice)
+{
+    M6502_t lane;
+    const M6502_t *cpu = &reference[index];
+
+    M6502_GetBatchCpu(&batch, index, &lane);
+
+    if ((lane.programCounter != cpu->programCounter)
+        || (lane.accumulator != cpu->accumulator)
+        || (lane.xRegister != cpu->xRegister)
+        || (lane.yRegister != cpu->yRegister)
+        || (lane.stackPointer != cpu->stackPointer)
+        || (M6502_GetStatus(&lane) != M6502_GetStatus(cpu))
+        || (lane.totalCycles != cpu->totalCycles)
+        || (memcmp(batchMemory[index], referenceMemory[index], MEMORY_SIZE) != 0))
+    {
+        printf("[Batch] Lane %u differs after slice %u! - PC: 0x%04x/0x%04x cycles: %llu/%llu\n",
+            (unsigned)index, (unsigned)slice,
+            lane.programCounter, cpu->programCounter,
+            (unsigned long long)lane.totalCycles, (unsigned long long)cpu->totalCycles);
+        exit(1);
+    }
+}
+
+void Emit(const uint8_t value)
+{
+    memory[cursor++] = value;
+}
+
+void EmitWord(const uint16_t value)
+{
+    Emit((uint8_t)value);
+    Emit((uint8_t)(value >> 8));
+}
+
+/*
+ * Every lane runs this from the same cycle, but its data decides which side of each branch it takes,
+ * how long its delay loop runs and whether it adds in decimal mode, so lanes split and rejoin all the time.
+ * Both sides call the subroutine, so lanes that meet in it return to different places.
+ */
+void BuildDivergeProgram(void)
+{
+    ClearMemory();
+
+    cursor = DIVERGE_START;
+    Emit(0xA2); Emit(0x00);                 /* LDX #$00 */
+    const uint16_t loop = cursor;
+    Emit(0xBD); EmitWord(DIVERGE_DATA);     /* LDA DIVERGE_DATA,X */
+    Emit(0x29); Emit(0x07);                 /* AND #$07 */
+    Emit(0xA8);                             /* TAY */
+    Emit(0xC9); Emit(0x04);                 /* CMP #$04 */
+    Emit(0x90); Emit(0x00);                 /* BCC low */
+    const uint16_t toLow = cursor;
+    Emit(0xA5); Emit(0x13);                 /* LDA $13 */
+    Emit(0xF0); Emit(0x01);                 /* BEQ +1 */
+    Emit(0xF8);                             /* SED */
+    Emit(0xBD); EmitWord(DIVERGE_DATA);     /* LDA DIVERGE_DATA,X */
+    Emit(0x65); Emit(0x10);                 /* ADC $10 */
+    Emit(0xD8);                             /* CLD */
+    Emit(0x0A);                             /* ASL A */
+    Emit(0x9D); EmitWord(DIVERGE_OUTPUT);   /* STA DIVERGE_OUTPUT,X */
+    Emit(0x20); EmitWord(DIVERGE_SUBROUTINE);   /* JSR DIVERGE_SUBROUTINE */
+    Emit(0x4C); EmitWord(0x0000);           /* JMP join */
+    const uint16_t toJoin = cursor;
+    memory[toLow - 1] = (uint8_t)(cursor - toLow);
+    Emit(0xBD); EmitWord(DIVERGE_DATA);     /* low: LDA DIVERGE_DATA,X */
+    Emit(0xE9); Emit(0x01);                 /* SBC #$01 */
+    Emit(0x45); Emit(0x11);                 /* EOR $11 */
+    Emit(0x4A);                             /* LSR A */
+    Emit(0x9D); EmitWord(DIVERGE_OUTPUT);   /* STA DIVERGE_OUTPUT,X */
+    Emit(0x20); EmitWord(DIVERGE_SUBROUTINE);   /* JSR DIVERGE_SUBROUTINE */
+    memory[toJoin - 2] = (uint8_t)cursor;
+    memory[toJoin - 1] = (uint8_t)(cursor >> 8);
+    Emit(0x88);                             /* join: DEY */
+    Emit(0x10); Emit(0xFD);                 /* BPL join */
+    Emit(0xE8);                             /* INX */
+    Emit(0xD0); Emit((uint8_t)(loop - (cursor + 1)));   /* BNE loop */
+    Emit(0xE6); Emit(0x12);                 /* INC $12 */
+    Emit(0x4C); EmitWord(DIVERGE_START);    /* JMP DIVERGE_START */
+
+    cursor = DIVERGE_SUBROUTINE;
+    Emit(0x48);                             /* PHA */
+    Emit(0xA5); Emit(0x12);                 /* LDA $12 */
+    Emit(0x18);                             /* CLC */
+    Emit(0x69); Emit(0x03);                 /* ADC #$03 */
+    Emit(0x85); Emit(0x12);                 /* STA $12 */
+    Emit(0x68);                             /* PLA */
+    Emit(0x60);                             /* RTS */
+}
+
+/* Lanes come in pairs with the same data, so some groups stay whole while the others split. */
+void FillDivergeData(uint8_t *image, const uint32_t lane)
+{
+    uint32_t seed = 0x6502u + (lane >> 1);
+
+    for (uint32_t index = 0; index < 0x100; ++index)
+    {
+        seed = (seed * 1103515245u) + 12345u;
+        image[DIVERGE_DATA + index] = (uint8_t)(seed >> 16);
+    }
+
+    image[0x10] = (uint8_t)(lane * 37);
+    image[0x11] = (uint8_t)(lane * 11 + 5);
+    image[0x13] = (uint8_t)((lane >> 1) & 1);
+}
+
+/* Each lane joins as a copy of its reference, which has run stagger cycles per lane index first. */
+void StartLanes(const uint32_t stagger, const uint8_t diverge)
+{
+    M6502_InitBatch(&batch);
+
+    for (uint32_t index = 0; index < M6502_BATCH_SIZE; ++index)
+    {
+        M6502_t *cpu = &reference[index];
+
+        memcpy(referenceMemory[index], memory, MEMORY_SIZE);
+
+        if (diverge)
+        {
+            FillDivergeData(referenceMemory[index], index);
+        }
+
+        cpu->memory = referenceMemory[index];
+        M6502_Init(cpu);
+        cpu->programCounter = PROGRAM_START;
+        M6502_Run(cpu, 0);
+        RunReference(cpu, (uint64_t)index * stagger);
+
+        memcpy(batchMemory[index], referenceMemory[index], MEMORY_SIZE);
+        M6502_AddBatchCpu(&batch, batchMemory[index]);
+
+        M6502_t lane = *cpu;
+        lane.memory = batchMemory[index];
+        M6502_SetBatchCpu(&batch, index, &lane);
+    }
+}
+
+void RunSlices(const uint32_t slices, const uint32_t cycles)
+{
+    for (uint32_t slice = 0; slice < slices; ++slice)
+    {
+        M6502_RunBatch(&batch, cycles);
+
+        for (uint32_t index = 0; index < batch.count; ++index)
+        {
+            RunReference(&reference[index], batch.clock);
+            CompareLane(index, slice);
+        }
+    }
+}
+
+int main(void)
+{
+    ClearMemory();
+
+    if(!OpenFileTest())
+    {
+        return 1;
+    }
+
+    StartLanes(BATCH_STAGGER, 0);
+    RunSlices(BATCH_SLICES, BATCH_SLICE);
+
+    BuildDivergeProgram();
+    StartLanes(0, 1);
+    RunSlices(DIVERGE_SLICES, DIVERGE_SLICE);
+
+    printf("[Batch] Passed!\n");
+
+    return 0;
+}
@@ -0,0 +1,323 @@
+#define PROGRAM_FILE "6502_functional_test.bin"
+#define PROGRAM_FILE_START 0x0000
+#define PROGRAM_START 0x0400
+#define SUCCESS_PC 0x3469
+
+#ifndef BENCHMARK_ROUNDS
+    #define BENCHMARK_ROUNDS 10
+#endif
+
+#ifndef BENCHMARK_SLICE
+    #define BENCHMARK_SLICE 29780
+#endif
+
+#ifndef BENCHMARK_LOOP_CYCLES
+    #define BENCHMARK_LOOP_CYCLES 500000000ull
+#endif
+
+#define LOOP_START 0x0200
+
+#if defined(M6502_JIT)
+    #define BENCHMARK_DISPATCH "jit"
+#elif defined(M6502_BLOCK_CACHE)
+    #define BENCHMARK_DISPATCH "block cache"
+#elif defined(M6502_COMPUTED_GOTO)
+    #define BENCHMARK_DISPATCH "computed goto"
+#else
+    #define BENCHMARK_DISPATCH "handler table"
+#endif
+
+#if defined(M6502_FLAT_MEMORY)
+    #define BENCHMARK_MEMORY "flat memory"
+#elif defined(M6502_PAGE_TABLE)
+    #define BENCHMARK_MEMORY "page table"
+#elif defined(M6502_BUS)
+    #define BENCHMARK_MEMORY "bus"
+#else
+    #define BENCHMARK_MEMORY "external callbacks"
+#endif
+
+#ifdef M6502_IMPLEMENTATION
+    #define BENCHMARK_BUILD "unity"
+#else
+    #define BENCHMARK_BUILD "separate"
+#endif
+
+#include <string.h>
+#include <time.h>
+
+#include "test.h"
+
+#ifdef M6502_BATCH
+static uint8_t batchMemory[M6502_BATCH_SIZE][MEMORY_SIZE];
+static M6502_Batch_t batch;
+
+/* Runs M6502_BATCH_SIZE copies of the functional test side by side. */
+void BatchBenchmark(void)
+{
+    uint64_t instructions = 0;
+
+    ClearMemory();
+
+    if(!OpenFileTest())
+    {
+        exit(1);
+    }
+
+    M6502_InitBatch(&batch);
+
+    for (uint32_t index = 0; index < M6502_BATCH_SIZE; ++index)
+    {
+        M6502_t cpu;
+
+        memcpy(batchMemory[index], memory, MEMORY_SIZE);
+        M6502_AddBatchCpu(&batch, batchMemory[index]);
+
+        M6502_GetBatchCpu(&batch, index, &cpu);
+        cpu.programCounter = PROGRAM_START;
+        M6502_SetBatchCpu(&batch, index, &cpu);
+    }
+
+    const clock_t start = clock();
+    uint32_t running = batch.count;
+
+    while (running > 0)
+    {
+        instructions += M6502_RunBatch(&batch, BENCHMARK_SLICE);
+        running = 0;
+
+        for (uint32_t index = 0; index < batch.count; ++index)
+        {
+            running += (batch.programCounter[index] != SUCCESS_PC);
+        }
+    }
+
+    const double seconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+    printf("[Benchmark] batch of %u: %llu instructions in %.3fs (%.2f MIPS aggregate)\n",
+        (unsigned)batch.count,
+        (unsigned long long)instructions,
+        seconds,
+        (double)instructions / seconds / 1000000.0);
+}
+#endif
+
+#ifdef M6502_JOBS
+#include <unistd.h>
+
+#ifndef BENCHMARK_JOBS
+    #define BENCHMARK_JOBS 16
+#endif
+
+static uint8_t jobArenas[M6502_JOB_WORKERS][MEMORY_SIZE];
+static M6502_Job_t jobs[BENCHMARK_JOBS];
+static M6502_JobResult_t jobResults[BENCHMARK_JOBS];
+static M6502_JobPool_t jobPool;
+
+/* Runs BENCHMARK_JOBS copies of the functional test on one pinned worker per online core. */
+void JobsBenchmark(void)
+{
+    ClearMemory();
+
+    if(!OpenFileTest())
+    {
+        exit(1);
+    }
+
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+
+    if ((cores < 1) || (cores > M6502_JOB_WORKERS))
+    {
+        cores = (cores < 1) ? 1 : M6502_JOB_WORKERS;
+    }
+
+    M6502_InitJobPool(&jobPool);
+
+    for (int core = 0; core < cores; ++core)
+    {
+        M6502_AddJobWorker(&jobPool, jobArenas[core], core);
+    }
+
+    for (uint32_t index = 0; index < BENCHMARK_JOBS; ++index)
+    {
+        jobs[index].image       = memory;
+        jobs[index].entry       = PROGRAM_START;
+        jobs[index].stopAddress = SUCCESS_PC;
+        jobs[index].maxCycles   = 0;
+    }
+
+    struct timespec start, end;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    const uint64_t instructions = M6502_RunJobs(&jobPool, jobs, jobResults, BENCHMARK_JOBS);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    for (uint32_t index = 0; index < BENCHMARK_JOBS; ++index)
+    {
+        if (jobResults[index].status != M6502_JobStatus_Stopped)
+        {
+            printf("[Benchmark] Job %u trapped! - PC: 0x%04x\n", (unsigned)index, jobResults[index].programCounter);
+            exit(1);
+        }
+    }
+
+    const double seconds = (double)(end.tv_sec - start.tv_sec) + (double)(end.tv_nsec - start.tv_nsec) / 1e9;
+
+    printf("[Benchmark] %u jobs on %ld workers: %llu instructions in %.3fs (%.2f MIPS aggregate)\n",
+        (unsigned)BENCHMARK_JOBS,
+        cores,
+        (unsigned long long)instructions,
+        seconds,
+        (double)instructions / seconds / 1000000.0);
+}
+#endif
+
+/* A tight indexed add-and-copy loop, the kind of code the block cache is for. */
+void LoopBenchmark(void)
+{
+    static const uint8_t program[] = {
+        0xA2, 0x00,                 /* LDX #$00 */
+        0xBD, 0x00, 0x30,           /* LDA $3000,X */
+        0x18,                       /* CLC */
+        0x69, 0x01,                 /* ADC #$01 */
+        0x9D, 0x00, 0x40,           /* STA $4000,X */
+        0xE8,                       /* INX */
+        0xD0, 0xF4,                 /* BNE $0202 */
+        0x4C, 0x00, 0x02            /* JMP $0200 */
+    };
+
+    ClearMemory();
+    memcpy(&memory[LOOP_START], program, sizeof(program));
+
+    M6502_t cpu;
+
+    ConnectBus(&cpu);
+    M6502_Init(&cpu);
+    cpu.programCounter = LOOP_START;
+    ConfigureCpu(&cpu);
+
+    uint64_t cycles = 0;
+    const clock_t start = clock();
+
+    while (cycles < BENCHMARK_LOOP_CYCLES)
+    {
+        cycles += M6502_Run(&cpu, BENCHMARK_SLICE);
+    }
+
+    const double seconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+    printf("[Benchmark] %s, %s, %s, loop: %llu cycles in %.3fs (%.2f MHz)\n",
+        BENCHMARK_DISPATCH,
+        BENCHMARK_MEMORY,
+        BENCHMARK_BUILD,
+        (unsigned long long)cycles,
+        seconds,
+        (double)cycles / seconds / 1000000.0);
+}
+
+/* Steps one instruction at a time, untimed, to get the average cycles per instruction. */
+double CyclesPerInstruction(void)
+{
+    uint64_t cycles = 0;
+    uint64_t instructions = 0;
+
+    ClearMemory();
+
+    if(!OpenFileTest())
+    {
+        exit(1);
+    }
+
+    M6502_t cpu;
+
+    ConnectBus(&cpu);
+    M6502_Init(&cpu);
+    cpu.programCounter = PROGRAM_START;
+    ConfigureCpu(&cpu);
+    M6502_Run(&cpu, 0);
+
+    while (cpu.programCounter != SUCCESS_PC)
+    {
+        const uint16_t previousProgramCounter = cpu.programCounter;
+
+        cycles += M6502_Run(&cpu, 1);
+        ++instructions;
+
+        if(cpu.programCounter == previousProgramCounter)
+        {
+            printf("[Benchmark] Trap! - PC: 0x%04x\n", cpu.programCounter);
+            exit(1);
+        }
+    }
+
+    return (double)cycles / (double)instructions;
+}
+
+int main(void)
+{
+#ifdef M6502_BATCH
+    BatchBenchmark();
+#endif
+
+#ifdef M6502_JOBS
+    JobsBenchmark();
+#endif
+
+    LoopBenchmark();
+
+    uint64_t totalCycles = 0;
+    double totalSeconds = 0.0;
+    const double cyclesPerInstruction = CyclesPerInstruction();
+
+    for (int round = 0; round < BENCHMARK_ROUNDS; ++round)
+    {
+        ClearMemory();
+
+        if(!OpenFileTest())
+        {
+            return 1;
+        }
+
+        M6502_t cpu;
+
+        ConnectBus(&cpu);
+        M6502_Init(&cpu);
+        cpu.programCounter = PROGRAM_START;
+        ConfigureCpu(&cpu);
+
+        const clock_t start = clock();
+
+        do
+        {
+            totalCycles += M6502_Run(&cpu, BENCHMARK_SLICE);
+
+            if(cpu.programCounter == SUCCESS_PC) break;
+
+            const uint16_t previousProgramCounter = cpu.programCounter;
+
+            totalCycles += M6502_Run(&cpu, 1);
+
+            if(cpu.programCounter == previousProgramCounter)
+            {
+                printf("[Benchmark] Trap! - PC: 0x%04x\n", cpu.programCounter);
+                exit(1);
+            }
+
+        } while (1);
+
+        totalSeconds += (double)(clock() - start) / CLOCKS_PER_SEC;
+    }
+
+    const double megahertz = (double)totalCycles / totalSeconds / 1000000.0;
+
+    printf("[Benchmark] %s, %s, %s: %llu cycles in %.3fs (%.2f MHz, %.2f MIPS)\n",
+        BENCHMARK_DISPATCH,
+        BENCHMARK_MEMORY,
+        BENCHMARK_BUILD,
+        (unsigned long long)totalCycles,
+        totalSeconds,
+        megahertz,
+        megahertz / cyclesPerInstruction);
+
+    return 0;
+}
@@ -17,14 +17,16 @@ int main(void)
         return 1;
     }
 
-    M6502_Init(&cpu, PROGRAM_START);
+    ConnectBus(&cpu);
+    M6502_Init(&cpu);
+    cpu.programCounter = PROGRAM_START;
+    ConfigureCpu(&cpu);
+    M6502_Run(&cpu, 0);
 
     uint16_t previousProgramCounter = 0x0000;
 
     do
     {
-        cpu.cycles = 0;
-        
         if(cpu.programCounter == SUCCESS_PC) break;
 
         if(cpu.programCounter == previousProgramCounter)
@@ -35,7 +37,7 @@ int main(void)
         
         previousProgramCounter = cpu.programCounter; 
 
-        M6502_Step(&cpu);
+        RunInstruction(&cpu);
 
     } while (1);
     
@@ -0,0 +1,112 @@
+#define ADC_PROGRAM 0x0200
+#define SBC_PROGRAM 0x0300
+
+#define OPERAND 0x10
+#define INPUT_A 0x11
+#define INPUT_P 0x12
+#define RESULT_A 0x13
+#define RESULT_P 0x14
+#define NEXT_PROGRAM 0x16
+
+#include "test.h"
+
+#if !defined(M6502_DECIMAL_TABLE) || !defined(M6502_IMPLEMENTATION)
+    #error "decimal_table.c needs M6502_DECIMAL_TABLE and M6502_IMPLEMENTATION, to switch the table off between runs"
+#endif
+
+/* Loads P and A from zero page, runs the instruction, stores A and P back and jumps to the next case. */
+void WriteProgram(const uint16_t base, const uint8_t opcode)
+{
+    static const uint8_t program[] = {
+        0xA5, INPUT_P,              /* LDA INPUT_P */
+        0x48,                       /* PHA */
+        0x28,                       /* PLP */
+        0xA5, INPUT_A,              /* LDA INPUT_A */
+        0x00, OPERAND,              /* ADC/SBC OPERAND */
+        0x08,                       /* PHP */
+        0x85, RESULT_A,             /* STA RESULT_A */
+        0x68,                       /* PLA */
+        0x85, RESULT_P,             /* STA RESULT_P */
+        0x6C, NEXT_PROGRAM, 0x00,   /* JMP (NEXT_PROGRAM) */
+    };
+
+    for (uint16_t index = 0; index < sizeof(program); ++index)
+    {
+        memory[base + index] = program[index];
+    }
+
+    memory[base + 6] = opcode;
+}
+
+/* Runs one program from the current PC until it jumps to the next one, then returns A and P. */
+uint16_t RunCase(M6502_t *cpu, const uint16_t next)
+{
+    uint32_t instructions = 0;
+
+    memory[NEXT_PROGRAM] = (uint8_t)next;
+    memory[NEXT_PROGRAM + 1] = (uint8_t)(next >> 8);
+
+    do
+    {
+        RunInstruction(cpu);
+
+        if (++instructions > 16)
+        {
+            printf("[Decimal Table] Trap! - PC: 0x%04x\n", cpu->programCounter);
+            exit(1);
+        }
+    } while (cpu->programCounter != next);
+
+    return (uint16_t)((memory[RESULT_P] << 8) | memory[RESULT_A]);
+}
+
+int main(void)
+{
+    ClearMemory();
+
+    WriteProgram(ADC_PROGRAM, 0x65);
+    WriteProgram(SBC_PROGRAM, 0xE5);
+
+    M6502_t cpu;
+
+    ConnectBus(&cpu);
+    M6502_Init(&cpu);
+    cpu.programCounter = ADC_PROGRAM;
+    ConfigureCpu(&cpu);
+    M6502_Run(&cpu, 0);
+
+    /* Every accumulator, operand and carry, for ADC then SBC, with D set: once from the table, once computed. */
+    for (uint32_t index = 0; index < 0x40000; ++index)
+    {
+        const uint8_t subtract = (uint8_t)(index >> 17);
+        const uint8_t carry = (uint8_t)((index >> 16) & 1);
+        const uint8_t a = (uint8_t)(index >> 8);
+        const uint8_t b = (uint8_t)index;
+        const uint16_t program = subtract ? SBC_PROGRAM : ADC_PROGRAM;
+        const uint16_t next = ((index + 1) >> 17) ? SBC_PROGRAM : ADC_PROGRAM;
+
+        memory[OPERAND] = b;
+        memory[INPUT_A] = a;
+        memory[INPUT_P] = (uint8_t)(0x08 | carry);
+
+        M6502_DecimalReady = 1u;
+        const uint16_t table = RunCase(&cpu, program);
+
+        M6502_DecimalReady = 0u;
+        const uint16_t computed = RunCase(&cpu, next);
+
+        if (table != computed)
+        {
+            printf("[Decimal Table] %s 0x%02x, 0x%02x with carry %u: table A=0x%02x P=0x%02x, computed A=0x%02x P=0x%02x\n",
+                subtract ? "SBC" : "ADC", a, b, carry,
+                table & 0xFF, table >> 8, computed & 0xFF, computed >> 8);
+            exit(1);
+        }
+    }
+
+    M6502_DecimalReady = 1u;
+
+    printf("[Decimal Table] Passed!\n");
+
+    return 0;
+}
@@ -0,0 +1,270 @@
+#define FEEDBACK_PORT 0x4014
+
+#define NOP_LOOP 0x0400
+#define FLIP_JUMP 0x0480
+#define PORT_PROGRAM 0x0500
+#define IRQ_HANDLER 0x0600
+#define SOURCE_PAGE 0x03
+#define PAGE_VARIABLE 0x10
+
+/* One idle cycle, then a read and a write per byte, plus one when the stall starts on an odd cycle. */
+#define OAM_STALL 513
+
+#define IRQ_CYCLES 7
+
+#include <string.h>
+
+#include "test.h"
+
+#ifndef M6502_DMA
+    #error "dma.c needs M6502_DMA"
+#endif
+
+M6502_t cpu;
+uint8_t oam[256];
+
+void Fail(const char *message, const uint64_t expected)
+{
+    printf("[DMA] %s - PC: 0x%04x cycles: %llu, expected %llu\n", message, cpu.programCounter,
+        (unsigned long long)cpu.totalCycles, (unsigned long long)expected);
+    exit(1);
+}
+
+/* The program's OAM DMA register, as on the NES. */
+void FeedbackWrite(uint8_t value)
+{
+    M6502_StartDMA(&cpu, (uint16_t)(value << 8), oam, 256);
+}
+
+void BuildProgram(void)
+{
+    ClearMemory();
+
+    for (uint16_t index = 0; index < 0x100; ++index)
+    {
+        memory[(SOURCE_PAGE << 8) + index] = (uint8_t)(index * 5 + 1);
+    }
+
+    /* NOPs keep the cycle parity, the JMP at FLIP_JUMP flips it. */
+    memset(&memory[NOP_LOOP], 0xEA, FLIP_JUMP - NOP_LOOP);
+    memory[FLIP_JUMP + 0] = 0x4C;
+    memory[FLIP_JUMP + 1] = (uint8_t)NOP_LOOP;
+    memory[FLIP_JUMP + 2] = (uint8_t)(NOP_LOOP >> 8);
+
+    memory[PAGE_VARIABLE] = SOURCE_PAGE;
+    memory[PORT_PROGRAM + 0] = 0xA5;        /* LDA PAGE_VARIABLE */
+    memory[PORT_PROGRAM + 1] = PAGE_VARIABLE;
+    memory[PORT_PROGRAM + 2] = 0x8D;        /* STA FEEDBACK_PORT */
+    memory[PORT_PROGRAM + 3] = (uint8_t)FEEDBACK_PORT;
+    memory[PORT_PROGRAM + 4] = (uint8_t)(FEEDBACK_PORT >> 8);
+    memory[PORT_PROGRAM + 5] = 0xEA;        /* NOP */
+    memory[PORT_PROGRAM + 6] = 0x4C;        /* JMP NOP_LOOP */
+    memory[PORT_PROGRAM + 7] = (uint8_t)NOP_LOOP;
+    memory[PORT_PROGRAM + 8] = (uint8_t)(NOP_LOOP >> 8);
+
+    memory[IRQ_HANDLER] = 0x40;             /* RTI */
+    memory[0xFFFE] = (uint8_t)IRQ_HANDLER;
+    memory[0xFFFF] = (uint8_t)(IRQ_HANDLER >> 8);
+}
+
+/* Parks the CPU in the NOP loop on an instruction boundary with the given cycle parity. */
+void Align(const uint8_t parity)
+{
+    if ((cpu.totalCycles & 1) != parity)
+    {
+        cpu.programCounter = FLIP_JUMP;
+        M6502_Run(&cpu, 1);
+    }
+
+    cpu.programCounter = NOP_LOOP;
+}
+
+/* The CPU stays halted for exactly stall cycles, split into slices, then runs a NOP. */
+void ExpectStall(const uint32_t stall, const uint32_t slice)
+{
+    const uint64_t start = cpu.totalCycles;
+    uint32_t left = stall;
+
+    while (left > 0)
+    {
+        M6502_Run(&cpu, (left < slice) ? left : slice);
+        left = (uint32_t)(start + stall - cpu.totalCycles);
+
+        if (cpu.programCounter != NOP_LOOP)
+        {
+            Fail("CPU ran during the stall", start + stall);
+        }
+    }
+
+    if (cpu.totalCycles != start + stall)
+    {
+        Fail("Stall ended late", start + stall);
+    }
+
+    M6502_Run(&cpu, 1);
+
+    if ((cpu.programCounter != NOP_LOOP + 1) || (cpu.totalCycles != start + stall + 2))
+    {
+        Fail("No NOP right after the stall", start + stall + 2);
+    }
+}
+
+void TestStallCycles(void)
+{
+    static const uint32_t slices[] = { 1000, 100, 7, 1 };
+
+    for (uint32_t index = 0; index < sizeof(slices) / sizeof(slices[0]); ++index)
+    {
+        for (uint8_t parity = 0; parity < 2; ++parity)
+        {
+            Align(parity);
+            memset(oam, 0, sizeof(oam));
+            M6502_StartDMA(&cpu, SOURCE_PAGE << 8, oam, 256);
+
+            if (memcmp(oam, &memory[SOURCE_PAGE << 8], sizeof(oam)) != 0)
+            {
+                Fail("DMA copied the wrong bytes", 0);
+            }
+
+            ExpectStall(OAM_STALL + parity, slices[index]);
+        }
+
+        /* A plain stall has no alignment cycle. */
+        Align(1);
+        M6502_Stall(&cpu, 100);
+        ExpectStall(100, slices[index]);
+    }
+}
+
+/* An IRQ raised before or during the stall is taken right after it, never inside it. */
+void ExpectIrqAfterStall(const uint32_t before)
+{
+    Align(1);
+
+    const uint64_t start = cpu.totalCycles;
+    const uint64_t end = start + OAM_STALL + 1;
+
+    M6502_StartDMA(&cpu, SOURCE_PAGE << 8, oam, 256);
+
+    if (before > 0)
+    {
+        M6502_Run(&cpu, before);
+    }
+
+    M6502_IRQ(&cpu);
+    M6502_Run(&cpu, (uint32_t)(end - cpu.totalCycles));
+
+    if ((cpu.programCounter != NOP_LOOP) || (cpu.totalCycles != end))
+    {
+        Fail("IRQ taken during the stall", end);
+    }
+
+    M6502_Run(&cpu, 1);
+
+    if ((cpu.programCounter != IRQ_HANDLER) || (cpu.totalCycles != end + IRQ_CYCLES))
+    {
+        Fail("IRQ not taken right after the stall", end + IRQ_CYCLES);
+    }
+
+    /* RTI back to the loop. */
+    M6502_Run(&cpu, 1);
+}
+
+#ifdef M6502_SCHEDULER
+void RaiseIrq(M6502_t *target, void *context)
+{
+    (void)context;
+
+    M6502_IRQ(target);
+}
+
+/* A device event in the middle of the stall raises the IRQ inside the same M6502_Run call. */
+void TestScheduledIrq(void)
+{
+    Align(0);
+
+    const uint64_t end = cpu.totalCycles + OAM_STALL;
+
+    M6502_StartDMA(&cpu, SOURCE_PAGE << 8, oam, 256);
+    M6502_ScheduleEvent(&cpu, cpu.totalCycles + 300, RaiseIrq, NULL);
+    M6502_Run(&cpu, OAM_STALL + 1);
+
+    if ((cpu.programCounter != IRQ_HANDLER) || (cpu.totalCycles != end + IRQ_CYCLES))
+    {
+        Fail("Scheduled IRQ not taken right after the stall", end + IRQ_CYCLES);
+    }
+
+    M6502_Run(&cpu, 1);
+}
+#endif
+
+#if !defined(M6502_FLAT_MEMORY) && !defined(M6502_PAGE_TABLE)
+/* A write to the DMA register stalls after the storing instruction, aligned on the cycle it ends, inside the same M6502_Run call. */
+void TestPortWrite(const uint8_t parity)
+{
+    Align(parity);
+    memset(oam, 0, sizeof(oam));
+    cpu.programCounter = PORT_PROGRAM;
+
+    /* LDA and STA take 7 cycles, so the stall starts off the parity of totalCycles. */
+    const uint64_t start = cpu.totalCycles + 7;
+    const uint64_t end = start + OAM_STALL + (start & 1);
+
+    M6502_Run(&cpu, 8);
+
+    if ((cpu.programCounter != PORT_PROGRAM + 5) || (cpu.totalCycles != start + 1)
+        || (memcmp(oam, &memory[SOURCE_PAGE << 8], sizeof(oam)) != 0))
+    {
+        Fail("Port write did not start the DMA", start + 1);
+    }
+
+    M6502_IRQ(&cpu);
+    M6502_Run(&cpu, (uint32_t)(end - cpu.totalCycles));
+
+    if ((cpu.programCounter != PORT_PROGRAM + 5) || (cpu.totalCycles != end))
+    {
+        Fail("CPU ran during the port DMA", end);
+    }
+
+    M6502_Run(&cpu, 1);
+
+    if ((cpu.programCounter != IRQ_HANDLER) || (cpu.totalCycles != end + IRQ_CYCLES))
+    {
+        Fail("IRQ not taken right after the port DMA", end + IRQ_CYCLES);
+    }
+
+    M6502_Run(&cpu, 1);
+}
+#endif
+
+int main(void)
+{
+    BuildProgram();
+
+    ConnectBus(&cpu);
+    M6502_Init(&cpu);
+    cpu.programCounter = NOP_LOOP;
+    ConfigureCpu(&cpu);
+    M6502_Run(&cpu, 0);
+    M6502_SetStatus(&cpu, M6502_GetStatus(&cpu) & ~0x04);
+
+    TestStallCycles();
+
+    ExpectIrqAfterStall(0);
+    ExpectIrqAfterStall(1);
+    ExpectIrqAfterStall(200);
+    ExpectIrqAfterStall(OAM_STALL);
+
+#ifdef M6502_SCHEDULER
+    TestScheduledIrq();
+#endif
+
+#if !defined(M6502_FLAT_MEMORY) && !defined(M6502_PAGE_TABLE)
+    TestPortWrite(0);
+    TestPortWrite(1);
+#endif
+
+    printf("[DMA] Passed!\n");
+
+    return 0;
+}
@@ -0,0 +1,269 @@
+#define PROGRAM_FILE "6502_functional_test.bin"
+#define PROGRAM_FILE_START 0x0000
+#define PROGRAM_START 0x0400
+#define SUCCESS_PC 0x3469
+
+/* The pair loop runs this long before the functional test takes over. */
+#ifndef FUSION_PAIR_CYCLES
+    #define FUSION_PAIR_CYCLES 4000000
+#endif
+
+/* Slices are 1 to FUSION_MAX_SLICE cycles, so they end on every instruction of a pair. */
+#ifndef FUSION_MAX_SLICE
+    #define FUSION_MAX_SLICE 64
+#endif
+
+/* Both CPUs take an IRQ every this many slices of the pair loop. */
+#define FUSION_IRQ_SLICES 97
+
+#define PAIR_START 0x0400
+#define PAIR_LOOP 0x04E0
+#define PAIR_IRQ 0x0700
+
+#include <string.h>
+
+#include "test.h"
+
+#ifndef M6502_FUSION
+    #error "fusion.c needs M6502_FUSION"
+#endif
+
+#if !defined(M6502_FLAT_MEMORY) && !defined(M6502_BUS) && !defined(M6502_PAGE_TABLE)
+    #error "fusion.c needs M6502_FLAT_MEMORY, M6502_BUS or M6502_PAGE_TABLE to give each CPU its own memory"
+#endif
+
+static uint8_t fusedMemory[MEMORY_SIZE];
+static uint8_t referenceMemory[MEMORY_SIZE];
+static M6502_t fused;
+static M6502_t reference;
+
+/* Cycles reported by M6502_Run since StartCpus, one count per CPU. */
+static uint64_t fusedCycles;
+static uint64_t referenceCycles;
+
+static uint16_t cursor;
+static uint32_t seed = 0x6502u;
+
+void Emit(const uint8_t value)
+{
+    memory[cursor++] = value;
+}
+
+uint32_t NextSlice(void)
+{
+    seed = (seed * 1103515245u) + 12345u;
+
+    return 1u + ((seed >> 16u) % FUSION_MAX_SLICE);
+}
+
+/* A compare or decrement, then a branch over one NOP, so taken and not taken cost different cycles. */
+void EmitPair(const uint8_t first, const uint8_t operandBytes, const uint16_t operand, const uint8_t branch)
+{
+    Emit(first);
+
+    if (operandBytes > 0)
+    {
+        Emit((uint8_t)operand);
+    }
+
+    if (operandBytes > 1)
+    {
+        Emit((uint8_t)(operand >> 8));
+    }
+
+    Emit(branch);
+    Emit(0x01);
+    Emit(0xEA);
+}
+
+/* Loops over every fused pair, with indexed copies and one branch that crosses a page. */
+void BuildPairProgram(void)
+{
+    static const uint8_t compares[][3] = {
+        { 0xC9, 1, 0x40 }, { 0xC5, 1, 0x06 }, { 0xCD, 2, 0x00 },
+        { 0xE0, 1, 0x20 }, { 0xE4, 1, 0x06 }, { 0xEC, 2, 0x00 },
+        { 0xC0, 1, 0x10 }, { 0xC4, 1, 0x06 }, { 0xCC, 2, 0x00 },
+    };
+
+    ClearMemory();
+
+    /* ($02) and ($04) point just below a page boundary for the (zp),Y copy. */
+    memory[0x02] = 0xF0;
+    memory[0x03] = 0x22;
+    memory[0x04] = 0xF8;
+    memory[0x05] = 0x32;
+
+    for (uint32_t index = 0; index < 0x400; ++index)
+    {
+        memory[0x2000 + index] = (uint8_t)((index * 7) ^ (index >> 3));
+    }
+
+    memory[0xFFFE] = (uint8_t)PAIR_IRQ;
+    memory[0xFFFF] = (uint8_t)(PAIR_IRQ >> 8);
+
+    cursor = PAIR_IRQ;
+    Emit(0xE6); Emit(0xE0);                 /* INC $E0 */
+    Emit(0x40);                             /* RTI */
+
+    cursor = PAIR_START;
+    Emit(0x58);                             /* CLI */
+    Emit(0xA2); Emit(0x00);                 /* LDX #$00 */
+    Emit(0xA0); Emit(0x00);                 /* LDY #$00 */
+    Emit(0x4C); Emit((uint8_t)PAIR_LOOP); Emit((uint8_t)(PAIR_LOOP >> 8));
+
+    cursor = PAIR_LOOP;
+    Emit(0xBD); Emit(0xF0); Emit(0x20);     /* LDA $20F0,X */
+    Emit(0x9D); Emit(0xF8); Emit(0x30);     /* STA $30F8,X */
+    Emit(0xB9); Emit(0xF0); Emit(0x21);     /* LDA $21F0,Y */
+    Emit(0x99); Emit(0xF8); Emit(0x31);     /* STA $31F8,Y */
+    Emit(0xB5); Emit(0x10);                 /* LDA $10,X */
+    Emit(0x95); Emit(0x80);                 /* STA $80,X */
+    Emit(0xB1); Emit(0x02);                 /* LDA ($02),Y */
+    Emit(0x91); Emit(0x04);                 /* STA ($04),Y */
+
+    for (uint32_t index = 0; index < sizeof(compares) / sizeof(compares[0]); ++index)
+    {
+        const uint16_t operand = (compares[index][1] == 2) ? 0x0200 : compares[index][2];
+
+        EmitPair(compares[index][0], compares[index][1], operand, 0xD0);
+        EmitPair(compares[index][0], compares[index][1], operand, 0xF0);
+    }
+
+    EmitPair(0xCA, 0, 0, 0xD0);             /* DEX, BNE */
+    EmitPair(0xCA, 0, 0, 0xF0);             /* DEX, BEQ */
+    EmitPair(0x88, 0, 0, 0xD0);             /* DEY, BNE */
+    EmitPair(0x88, 0, 0, 0xF0);             /* DEY, BEQ */
+
+    /* The branch of this pair sits at the end of a page, so taking it crosses into the next. */
+    while ((uint16_t)(cursor + 4) != 0x05FF)
+    {
+        Emit(0xEA);
+    }
+
+    EmitPair(0xC9, 1, 0x80, 0xD0);
+
+    Emit(0xE8); Emit(0xE8); Emit(0xE8);     /* INX x3 */
+    Emit(0xC8);                             /* INY */
+    Emit(0xE6); Emit(0x06);                 /* INC $06 */
+    Emit(0xEE); Emit(0x00); Emit(0x02);     /* INC $0200 */
+    Emit(0x69); Emit(0x07);                 /* ADC #$07 */
+    Emit(0x4C); Emit((uint8_t)PAIR_LOOP); Emit((uint8_t)(PAIR_LOOP >> 8));
+}
+
+void ConnectMemory(M6502_t *cpu, uint8_t *image)
+{
+#if defined(M6502_FLAT_MEMORY)
+    cpu->memory         = image;
+#elif defined(M6502_BUS)
+    cpu->bus.read       = BusRead;
+    cpu->bus.write      = BusWrite;
+    cpu->bus.context    = image;
+#else
+    (void)cpu;
+    (void)image;
+#endif
+}
+
+/* The reference runs the same build with no block cache attached, so it never fuses. */
+void StartCpus(void)
+{
+    memcpy(fusedMemory, memory, MEMORY_SIZE);
+    memcpy(referenceMemory, memory, MEMORY_SIZE);
+
+    M6502_t *cpus[2] = { &fused, &reference };
+    uint8_t *images[2] = { fusedMemory, referenceMemory };
+
+    for (uint32_t index = 0; index < 2; ++index)
+    {
+        ConnectMemory(cpus[index], images[index]);
+        M6502_Init(cpus[index]);
+        cpus[index]->programCounter = PROGRAM_START;
+#if defined(M6502_PAGE_TABLE) && !defined(M6502_FLAT_MEMORY) && !defined(M6502_BUS)
+        M6502_MapMemory(cpus[index], 0x0000, MEMORY_SIZE, images[index], 0);
+#endif
+#ifdef M6502_SIDE_EFFECT_FREE
+        M6502_SetSideEffectFree(cpus[index], 0x0000, MEMORY_SIZE, 1);
+#endif
+        M6502_Run(cpus[index], 0);
+    }
+
+    M6502_AttachBlockCache(&fused, &blockCache);
+
+    fusedCycles     = 0u;
+    referenceCycles = 0u;
+}
+
+void RunBoth(const uint32_t cycles)
+{
+    fusedCycles     += M6502_Run(&fused, cycles);
+    referenceCycles += M6502_Run(&reference, cycles);
+}
+
+void Compare(const char *phase, const uint32_t slice, const uint8_t withMemory)
+{
+    if ((fused.programCounter != reference.programCounter)
+        || (fused.accumulator != reference.accumulator)
+        || (fused.xRegister != reference.xRegister)
+        || (fused.yRegister != reference.yRegister)
+        || (fused.stackPointer != reference.stackPointer)
+        || (M6502_GetStatus(&fused) != M6502_GetStatus(&reference))
+        || (fusedCycles != referenceCycles)
+        || (withMemory && (memcmp(fusedMemory, referenceMemory, MEMORY_SIZE) != 0)))
+    {
+        printf("[Fusion] %s differs after slice %u! - PC: 0x%04x/0x%04x cycles: %llu/%llu\n",
+            phase, (unsigned)slice,
+            fused.programCounter, reference.programCounter,
+            (unsigned long long)fusedCycles, (unsigned long long)referenceCycles);
+        exit(1);
+    }
+}
+
+int main(void)
+{
+    BuildPairProgram();
+    StartCpus();
+
+    uint32_t slice = 0;
+
+    while (referenceCycles < FUSION_PAIR_CYCLES)
+    {
+        if ((slice % FUSION_IRQ_SLICES) == 0)
+        {
+            M6502_IRQ(&fused);
+            M6502_IRQ(&reference);
+        }
+
+        const uint32_t cycles = NextSlice();
+
+        RunBoth(cycles);
+        Compare("Pair loop", slice, (slice % 64) == 0);
+        ++slice;
+    }
+
+    Compare("Pair loop", slice, 1);
+
+    ClearMemory();
+
+    if(!OpenFileTest())
+    {
+        return 1;
+    }
+
+    StartCpus();
+    slice = 0;
+
+    while (reference.programCounter != SUCCESS_PC)
+    {
+        const uint32_t cycles = NextSlice();
+
+        RunBoth(cycles);
+        Compare("Functional test", slice, (slice % 4096) == 0);
+        ++slice;
+    }
+
+    Compare("Functional test", slice, 1);
+
+    printf("[Fusion] Passed!\n");
+
+    return 0;
+}
@@ -2,10 +2,31 @@
 #define PROGRAM_FILE_START 0x000a
 #define PROGRAM_START 0x0400
 #define SUCCESS_PC 0x06F5
+#define FEEDBACK_PORT 0xBFFC
+
+#ifndef INTERRUPT_SLICE
+    #define INTERRUPT_SLICE 1000
+#endif
 
 #include "test.h"
 
-int main(void)
+const uint8_t IRQ_BIT = (1 << 0);
+const uint8_t NMI_BIT = (1 << 1);
+
+/* Set while the lines follow the port from the write callback, in the middle of a slice. */
+M6502_t *feedbackCpu = NULL;
+
+void FeedbackWrite(uint8_t value)
+{
+    if (feedbackCpu != NULL)
+    {
+        M6502_SetIRQLine(feedbackCpu, IRQ_BIT, value & IRQ_BIT);
+        M6502_SetNMILine(feedbackCpu, value & NMI_BIT);
+    }
+}
+
+/* The main loop polls the port between instructions. */
+void PolledTest(void)
 {
     ClearMemory();
 
@@ -13,44 +34,27 @@ int main(void)
 
     if(!OpenFileTest())
     {
-        return 1;
+        exit(1);
     }
 
-    M6502_Init(&cpu, PROGRAM_START);
-
-    const uint8_t IRQ_BIT = (1 << 0);
-    const uint8_t NMI_BIT = (1 << 1);
+    ConnectBus(&cpu);
+    M6502_Init(&cpu);
+    cpu.programCounter = PROGRAM_START;
+    ConfigureCpu(&cpu);
+    M6502_Run(&cpu, 0);
 
     uint16_t previousProgramCounter = 0x0000;
-    uint8_t previousFeedback = 0x00;
     uint8_t feedback = 0x00;
 
-    previousFeedback = M6502_ExternalReadMemory(0xBFFC);
+    /* The feedback port drives the IRQ and NMI lines, it starts released. */
+    M6502_ExternalWriteMemory(FEEDBACK_PORT, 0x00);
 
     do
     {
-        cpu.cycles = 0;
+        feedback = M6502_ExternalReadMemory(FEEDBACK_PORT);
 
-        feedback = M6502_ExternalReadMemory(0xBFFC);
-
-        if ((feedback & NMI_BIT) && !(previousFeedback & NMI_BIT))
-        {
-            M6502_NMI(&cpu);
-            previousFeedback |= NMI_BIT;
-        }
-        else if ((feedback & IRQ_BIT) && !(previousFeedback & IRQ_BIT))
-        {
-            M6502_IRQ(&cpu);
-	        previousFeedback |= IRQ_BIT;
-        }
-        else if ((previousFeedback & NMI_BIT) && !(feedback & NMI_BIT))
-        {
-            previousFeedback &= ~NMI_BIT;
-        }
-        else if ((previousFeedback & IRQ_BIT) && !(feedback & IRQ_BIT))
-        {
-            previousFeedback &= ~IRQ_BIT;
-        }
+        M6502_SetIRQLine(&cpu, IRQ_BIT, feedback & IRQ_BIT);
+        M6502_SetNMILine(&cpu, feedback & NMI_BIT);
 
         if(cpu.programCounter == SUCCESS_PC) break;
 
@@ -62,10 +66,66 @@ int main(void)
         
         previousProgramCounter = cpu.programCounter; 
         
-        M6502_Step(&cpu);
+        RunInstruction(&cpu);
+
+    } while (1);
+}
+
+#if !defined(M6502_FLAT_MEMORY) && !defined(M6502_PINS)
+/* Lines change inside M6502_Run, mid-block with the block cache or JIT, and through the request queue with M6502_ATOMIC. */
+void CallbackTest(void)
+{
+    ClearMemory();
+
+    M6502_t cpu;
+
+    if(!OpenFileTest())
+    {
+        exit(1);
+    }
+
+    ConnectBus(&cpu);
+    M6502_Init(&cpu);
+    cpu.programCounter = PROGRAM_START;
+    ConfigureCpu(&cpu);
+#ifdef M6502_PAGE_TABLE
+    /* The port page has to reach the write callback. */
+    M6502_MapMemory(&cpu, FEEDBACK_PORT & 0xFF00, 0x100, NULL, 0);
+#endif
+
+    feedbackCpu = &cpu;
+    M6502_ExternalWriteMemory(FEEDBACK_PORT, 0x00);
+
+    do
+    {
+        M6502_Run(&cpu, INTERRUPT_SLICE);
+
+        if(cpu.programCounter == SUCCESS_PC) break;
+
+        const uint16_t previousProgramCounter = cpu.programCounter;
+
+        M6502_Run(&cpu, 1);
+
+        if(cpu.programCounter == previousProgramCounter)
+        {
+            printf("[Interrupt] Trap in slices! - PC: 0x%04x\n", cpu.programCounter);
+            exit(1);
+        }
 
     } while (1);
-    
+
+    feedbackCpu = NULL;
+}
+#endif
+
+int main(void)
+{
+    PolledTest();
+
+#if !defined(M6502_FLAT_MEMORY) && !defined(M6502_PINS)
+    CallbackTest();
+#endif
+
     printf("[Interrupt] Passed!\n");
 
     return 0;
@@ -0,0 +1,300 @@
+#define PROGRAM_START 0x0400
+#define STOP_ADDRESS 0x3000
+
+#define IMAGES 16
+#define ENTRIES 256
+#define JOB_COUNT (IMAGES * ENTRIES)
+
+/* Each entry point loads a loop count and jumps to one of these, which decides how the job ends. */
+#define WORK_STOP 0x2000
+#define WORK_TRAP 0x2100
+#define WORK_JAM 0x2200
+#define WORK_FOREVER 0x2300
+#define TRAP_ADDRESS 0x3100
+
+#include <string.h>
+
+#include "test.h"
+
+#ifndef M6502_JOBS
+    #error "jobs.c needs M6502_JOBS"
+#endif
+
+#if M6502_JOB_WORKERS < 16
+    #error "jobs.c runs up to 16 workers"
+#endif
+
+static uint8_t images[IMAGES][MEMORY_SIZE];
+static uint8_t arenas[16][MEMORY_SIZE];
+static M6502_Job_t jobs[JOB_COUNT];
+static M6502_JobResult_t results[JOB_COUNT];
+static M6502_JobResult_t expected[JOB_COUNT];
+static M6502_JobPool_t pool;
+
+static uint8_t *image;
+static uint16_t cursor;
+
+void Emit(const uint8_t value)
+{
+    image[cursor++] = value;
+}
+
+void EmitWord(const uint16_t value)
+{
+    Emit((uint8_t)value);
+    Emit((uint8_t)(value >> 8));
+}
+
+/* X times Y rounds of a sum over the image's own data, then the given ending. */
+void EmitWork(const uint16_t address, const uint8_t ending)
+{
+    cursor = address;
+    const uint16_t loop = cursor;
+    Emit(0x18);                             /* CLC */
+    Emit(0xA5); Emit(0x10);                 /* LDA $10 */
+    Emit(0x75); Emit(0x20);                 /* ADC $20,X */
+    Emit(0x85); Emit(0x10);                 /* STA $10 */
+    Emit(0xCA);                             /* DEX */
+    Emit(0xD0); Emit((uint8_t)(loop - (cursor + 1)));   /* BNE loop */
+    Emit(0x88);                             /* DEY */
+    Emit(0xD0); Emit((uint8_t)(loop - (cursor + 1)));   /* BNE loop */
+
+    switch (ending)
+    {
+        case 0:
+            Emit(0x4C); EmitWord(STOP_ADDRESS);     /* JMP STOP_ADDRESS */
+            break;
+        case 1:
+            Emit(0x4C); EmitWord(TRAP_ADDRESS);     /* JMP TRAP_ADDRESS */
+            break;
+        case 2:
+            Emit(0x02);                             /* JAM */
+            break;
+        default:
+            Emit(0x4C); EmitWord(loop);             /* JMP loop */
+            break;
+    }
+}
+
+void BuildImages(void)
+{
+    static const uint16_t works[4] = { WORK_STOP, WORK_TRAP, WORK_JAM, WORK_FOREVER };
+
+    for (uint32_t index = 0; index < IMAGES; ++index)
+    {
+        image = images[index];
+        memset(image, 0, MEMORY_SIZE);
+
+        for (uint32_t offset = 0; offset < 0x100; ++offset)
+        {
+            image[0x20 + offset] = (uint8_t)((offset * 13) ^ (index * 29));
+        }
+
+        for (uint8_t ending = 0; ending < 4; ++ending)
+        {
+            EmitWork(works[ending], ending);
+        }
+
+        cursor = TRAP_ADDRESS;
+        Emit(0x4C); EmitWord(TRAP_ADDRESS);         /* JMP TRAP_ADDRESS */
+
+        cursor = STOP_ADDRESS;
+        Emit(0xEA);                                 /* NOP, never run */
+
+        /* Every eighth entry loops a long time, so the even split up front leaves the workers unbalanced. */
+        for (uint32_t entry = 0; entry < ENTRIES; ++entry)
+        {
+            cursor = (uint16_t)(PROGRAM_START + entry * 8);
+            Emit(0xA2); Emit((uint8_t)(entry * 7 + 1));             /* LDX */
+            Emit(0xA0); Emit((entry % 8 == 0) ? 24 : (uint8_t)(entry % 3 + 1));   /* LDY */
+            Emit(0x4C); EmitWord(works[entry % 4]);                 /* JMP work */
+        }
+    }
+}
+
+/* The long jobs are bunched at the front, all in the first worker's share. */
+void BuildJobs(void)
+{
+    for (uint32_t index = 0; index < JOB_COUNT; ++index)
+    {
+        const uint32_t entry = (index * 97) % ENTRIES;
+        M6502_Job_t *job = &jobs[index];
+
+        job->image          = images[index % IMAGES];
+        job->entry          = (uint16_t)(PROGRAM_START + entry * 8);
+        job->stopAddress    = STOP_ADDRESS;
+        job->maxCycles      = (entry % 4 == 3) ? (2000u + entry * 37u) : 0u;
+    }
+
+    for (uint32_t index = 0, front = 0; index < JOB_COUNT; ++index)
+    {
+        if ((jobs[index].entry - PROGRAM_START) % 64 == 0)
+        {
+            const M6502_Job_t job = jobs[front];
+
+            jobs[front++] = jobs[index];
+            jobs[index] = job;
+        }
+    }
+}
+
+/* The job one instruction at a time on a CPU of its own, with M6502_Run. */
+void RunReference(const M6502_Job_t *job, M6502_JobResult_t *result)
+{
+    static uint8_t reference[MEMORY_SIZE];
+    M6502_t cpu;
+
+    memcpy(reference, job->image, MEMORY_SIZE);
+    cpu.memory = reference;
+    M6502_Init(&cpu);
+    cpu.programCounter = job->entry;
+    cpu.cycles = 0;
+    result->instructions = 0;
+
+    for (;;)
+    {
+        if (cpu.programCounter == job->stopAddress)
+        {
+            result->status = M6502_JobStatus_Stopped;
+            break;
+        }
+
+        if ((job->maxCycles != 0) && (cpu.totalCycles >= job->maxCycles))
+        {
+            result->status = M6502_JobStatus_Timeout;
+            break;
+        }
+
+        const uint16_t programCounter = cpu.programCounter;
+
+        M6502_Run(&cpu, 1);
+        result->instructions++;
+
+        if (cpu.jammed == 0xFF)
+        {
+            result->status = M6502_JobStatus_Jammed;
+            break;
+        }
+
+        if (cpu.programCounter == programCounter)
+        {
+            result->status = M6502_JobStatus_Trapped;
+            break;
+        }
+    }
+
+    result->programCounter  = cpu.programCounter;
+    result->accumulator     = cpu.accumulator;
+    result->xRegister       = cpu.xRegister;
+    result->yRegister       = cpu.yRegister;
+    result->stackPointer    = cpu.stackPointer;
+    result->statusRegister  = M6502_GetStatus(&cpu);
+    result->cycles          = cpu.totalCycles;
+}
+
+void Fail(const char *message, const uint32_t workers, const uint32_t index)
+{
+    printf("[Jobs] %s (%u workers, job %u)\n", message, (unsigned)workers, (unsigned)index);
+    exit(1);
+}
+
+/* Every job ran exactly once, on the right slot: no result is left unwritten and the totals add up. */
+void TestWorkers(const uint32_t workers, const uint32_t count)
+{
+    M6502_InitJobPool(&pool);
+
+    for (uint32_t index = 0; index < workers; ++index)
+    {
+        M6502_AddJobWorker(&pool, arenas[index], -1);
+    }
+
+    /* An impossible result, so a job that never ran stands out. */
+    memset(results, 0xA5, sizeof(results));
+
+    const uint64_t instructions = M6502_RunJobs(&pool, jobs, results, count);
+    uint64_t resultInstructions = 0;
+    uint64_t workerInstructions = 0;
+    uint32_t workerJobs = 0;
+
+    for (uint32_t index = 0; index < count; ++index)
+    {
+        if (memcmp(&results[index], &expected[index], sizeof(M6502_JobResult_t)) != 0)
+        {
+            printf("[Jobs] Status %u PC 0x%04x cycles %llu, expected status %u PC 0x%04x cycles %llu\n",
+                (unsigned)results[index].status, results[index].programCounter,
+                (unsigned long long)results[index].cycles,
+                (unsigned)expected[index].status, expected[index].programCounter,
+                (unsigned long long)expected[index].cycles);
+            Fail("Wrong result", workers, index);
+        }
+
+        resultInstructions += results[index].instructions;
+    }
+
+    for (uint32_t index = count; index < JOB_COUNT; ++index)
+    {
+        const uint8_t *bytes = (const uint8_t *)&results[index];
+
+        for (size_t offset = 0; offset < sizeof(M6502_JobResult_t); ++offset)
+        {
+            if (bytes[offset] != 0xA5)
+            {
+                Fail("Result written past the job count", workers, index);
+            }
+        }
+    }
+
+    for (uint32_t index = 0; index < workers; ++index)
+    {
+        workerJobs += pool.workers[index].jobs;
+        workerInstructions += pool.workers[index].instructions;
+    }
+
+    if ((workerJobs != count) || (instructions != resultInstructions) || (workerInstructions != resultInstructions))
+    {
+        printf("[Jobs] %u jobs and %llu instructions run, expected %u and %llu\n", (unsigned)workerJobs,
+            (unsigned long long)instructions, (unsigned)count, (unsigned long long)resultInstructions);
+        Fail("A job ran more than once", workers, count);
+    }
+}
+
+int main(void)
+{
+    BuildImages();
+    BuildJobs();
+
+    uint32_t statuses[4] = { 0 };
+
+    for (uint32_t index = 0; index < JOB_COUNT; ++index)
+    {
+        /* Padding bytes take part in the comparison, so both sides start from the same fill. */
+        memset(&expected[index], 0xA5, sizeof(M6502_JobResult_t));
+        RunReference(&jobs[index], &expected[index]);
+        statuses[expected[index].status]++;
+    }
+
+    for (uint32_t status = 0; status < 4; ++status)
+    {
+        if (statuses[status] == 0)
+        {
+            Fail("A status never came up", 0, status);
+        }
+    }
+
+    TestWorkers(1, JOB_COUNT);
+    TestWorkers(3, JOB_COUNT);
+    TestWorkers(16, JOB_COUNT);
+    TestWorkers(16, JOB_COUNT - 1);
+    TestWorkers(16, 5);
+    TestWorkers(7, 1);
+    TestWorkers(4, 0);
+
+    for (uint32_t round = 0; round < 8; ++round)
+    {
+        TestWorkers(2 + round * 2, JOB_COUNT - round * 31);
+    }
+
+    printf("[Jobs] Passed!\n");
+
+    return 0;
+}
@@ -0,0 +1,252 @@
+#define NOP_LOOP 0x0400
+#define NMI_HANDLER 0x0600
+#define IRQ_HANDLER 0x0700
+#define NMI_COUNT 0x20
+#define IRQ_COUNT 0x21
+
+/* A handler entry never takes longer than this many instructions to show in its counter. */
+#define SETTLE_INSTRUCTIONS 20
+
+#define TIMER_IRQ (1u << 0)
+#define APU_IRQ (1u << 1)
+
+#include <string.h>
+
+#include "test.h"
+
+M6502_t cpu;
+
+void Expect(const char *message, const uint8_t nmis, const uint8_t irqs)
+{
+    if ((memory[NMI_COUNT] != nmis) || (memory[IRQ_COUNT] != irqs))
+    {
+        printf("[Lines] %s - PC: 0x%04x NMIs: %u, expected %u, IRQs: %u, expected %u\n", message,
+            cpu.programCounter, memory[NMI_COUNT], nmis, memory[IRQ_COUNT], irqs);
+        exit(1);
+    }
+}
+
+void BuildProgram(void)
+{
+    ClearMemory();
+
+    memset(&memory[NOP_LOOP], 0xEA, 0x100);
+    memory[NOP_LOOP + 0x100] = 0x4C;        /* JMP NOP_LOOP */
+    memory[NOP_LOOP + 0x101] = (uint8_t)NOP_LOOP;
+    memory[NOP_LOOP + 0x102] = (uint8_t)(NOP_LOOP >> 8);
+
+    memory[NMI_HANDLER + 0] = 0xE6;         /* INC NMI_COUNT */
+    memory[NMI_HANDLER + 1] = NMI_COUNT;
+    memory[NMI_HANDLER + 2] = 0x40;         /* RTI */
+
+    memory[IRQ_HANDLER + 0] = 0xE6;         /* INC IRQ_COUNT */
+    memory[IRQ_HANDLER + 1] = IRQ_COUNT;
+    memory[IRQ_HANDLER + 2] = 0x40;         /* RTI */
+
+    memory[0xFFFA] = (uint8_t)NMI_HANDLER;
+    memory[0xFFFB] = (uint8_t)(NMI_HANDLER >> 8);
+    memory[0xFFFE] = (uint8_t)IRQ_HANDLER;
+    memory[0xFFFF] = (uint8_t)(IRQ_HANDLER >> 8);
+}
+
+void Run(const uint32_t instructions)
+{
+    for (uint32_t index = 0; index < instructions; ++index)
+    {
+        RunInstruction(&cpu);
+    }
+}
+
+/* Runs until the handlers have been entered exactly this often, whatever the build samples the lines on. */
+void RunUntil(const char *message, const uint8_t nmis, const uint8_t irqs)
+{
+    for (uint32_t index = 0; index < SETTLE_INSTRUCTIONS * 4; ++index)
+    {
+        if ((memory[NMI_COUNT] == nmis) && (memory[IRQ_COUNT] == irqs))
+        {
+            return;
+        }
+
+        RunInstruction(&cpu);
+    }
+
+    Expect(message, nmis, irqs);
+}
+
+/* Gives the CPU time to take anything still pending, and expects it took nothing. */
+void Settle(const char *message, const uint8_t nmis, const uint8_t irqs)
+{
+    Run(SETTLE_INSTRUCTIONS);
+    Expect(message, nmis, irqs);
+}
+
+/* Starts each case back in the NOP loop with both counters at zero. */
+void Restart(void)
+{
+    memory[NMI_COUNT] = 0;
+    memory[IRQ_COUNT] = 0;
+    cpu.programCounter = NOP_LOOP;
+}
+
+/* The NMI line is taken once per rising edge, however long it stays high and whatever else toggles. */
+void TestNmiEdge(void)
+{
+    Restart();
+
+    M6502_SetNMILine(&cpu, 1);
+    RunUntil("NMI not taken on the rising edge", 1, 0);
+    Settle("NMI taken again while the line stayed high", 1, 0);
+
+    M6502_SetNMILine(&cpu, 1);
+    M6502_SetIRQLine(&cpu, TIMER_IRQ, 0);
+    Settle("NMI taken when the high line was driven high again", 1, 0);
+
+    M6502_SetNMILine(&cpu, 0);
+    Settle("NMI taken on the falling edge", 1, 0);
+
+    M6502_SetNMILine(&cpu, 1);
+    RunUntil("NMI not taken on the second rising edge", 2, 0);
+
+    /* An edge is latched even when the line drops before the CPU looks. */
+    M6502_SetNMILine(&cpu, 0);
+    M6502_SetNMILine(&cpu, 1);
+    M6502_SetNMILine(&cpu, 0);
+    RunUntil("Short NMI pulse lost", 3, 0);
+    Settle("Short NMI pulse taken twice", 3, 0);
+
+    /* Two pulses before the CPU looks share the one latch. */
+    M6502_SetNMILine(&cpu, 1);
+    M6502_SetNMILine(&cpu, 0);
+    M6502_SetNMILine(&cpu, 1);
+    M6502_SetNMILine(&cpu, 0);
+    RunUntil("NMI pulses lost", 4, 0);
+    Settle("Two NMI pulses before the CPU looked taken twice", 4, 0);
+
+    /* An edge inside the handler is taken once the handler returns, never on top of it. */
+    const uint8_t stackPointer = cpu.stackPointer;
+
+    M6502_SetNMILine(&cpu, 1);
+
+    for (uint32_t index = 0; (index < SETTLE_INSTRUCTIONS) && (cpu.stackPointer == stackPointer); ++index)
+    {
+        RunInstruction(&cpu);
+    }
+
+    M6502_SetNMILine(&cpu, 0);
+    M6502_SetNMILine(&cpu, 1);
+
+    for (uint32_t index = 0; index < SETTLE_INSTRUCTIONS; ++index)
+    {
+        RunInstruction(&cpu);
+
+        if ((uint8_t)(stackPointer - cpu.stackPointer) > 3)
+        {
+            printf("[Lines] NMI nested inside its own handler - PC: 0x%04x S: 0x%02x\n", cpu.programCounter,
+                cpu.stackPointer);
+            exit(1);
+        }
+    }
+
+    Expect("NMI edge inside the handler not taken once", 6, 0);
+
+    M6502_SetNMILine(&cpu, 0);
+}
+
+/* The IRQ is taken again after every RTI while any source holds the line, through any toggles. */
+void TestIrqLevel(void)
+{
+    Restart();
+
+    M6502_SetIRQLine(&cpu, TIMER_IRQ, 1);
+    RunUntil("IRQ not held while the timer holds the line", 0, 4);
+
+    /* Asserting a held source again, or releasing one that is not held, changes nothing. */
+    M6502_SetIRQLine(&cpu, TIMER_IRQ, 1);
+    M6502_SetIRQLine(&cpu, APU_IRQ, 0);
+    RunUntil("IRQ dropped by a source that did not hold it", 0, 6);
+
+    /* NMI line toggles leave the IRQ level alone. */
+    M6502_SetNMILine(&cpu, 1);
+    M6502_SetNMILine(&cpu, 0);
+    RunUntil("NMI not taken while the IRQ was held", 1, 6);
+    RunUntil("IRQ dropped by an NMI line toggle", 1, 8);
+
+    /* The APU takes over before the timer lets go, so the line never goes high. */
+    M6502_SetIRQLine(&cpu, APU_IRQ, 1);
+    M6502_SetIRQLine(&cpu, TIMER_IRQ, 0);
+    RunUntil("IRQ dropped while the APU still held the line", 1, 10);
+
+    /* Letting go and pulling the line again before the CPU looks keeps it held. */
+    M6502_SetIRQLine(&cpu, APU_IRQ, 0);
+    M6502_SetIRQLine(&cpu, APU_IRQ, 1);
+    RunUntil("IRQ dropped by a release the APU took back", 1, 12);
+
+    /* An entry already under way may still finish, nothing after it. */
+    M6502_SetIRQLine(&cpu, APU_IRQ, 0);
+    Run(SETTLE_INSTRUCTIONS);
+    Restart();
+    Settle("IRQ taken after every source let go", 0, 0);
+}
+
+/* A held line waits for the I flag, and a line released while masked is never taken. */
+void TestIrqMasked(void)
+{
+    Restart();
+
+    M6502_SetStatus(&cpu, M6502_GetStatus(&cpu) | 0x04);
+    M6502_SetIRQLine(&cpu, TIMER_IRQ, 1);
+    Settle("IRQ taken with the I flag set", 0, 0);
+
+    M6502_SetStatus(&cpu, M6502_GetStatus(&cpu) & ~0x04);
+    RunUntil("Held IRQ not taken once the I flag cleared", 0, 1);
+
+    M6502_SetIRQLine(&cpu, TIMER_IRQ, 0);
+    Run(SETTLE_INSTRUCTIONS);
+    Restart();
+
+    M6502_SetStatus(&cpu, M6502_GetStatus(&cpu) | 0x04);
+    M6502_SetIRQLine(&cpu, TIMER_IRQ, 1);
+    Run(5);
+    M6502_SetIRQLine(&cpu, TIMER_IRQ, 0);
+    M6502_SetStatus(&cpu, M6502_GetStatus(&cpu) & ~0x04);
+    Settle("IRQ released while masked was taken", 0, 0);
+}
+
+/* M6502_IRQ latches a single request, which the last source letting go of the line withdraws. */
+void TestIrqRequest(void)
+{
+    Restart();
+
+    M6502_IRQ(&cpu);
+    M6502_SetIRQLine(&cpu, APU_IRQ, 0);
+    RunUntil("M6502_IRQ not taken", 0, 1);
+    Settle("M6502_IRQ taken more than once", 0, 1);
+
+    M6502_SetStatus(&cpu, M6502_GetStatus(&cpu) | 0x04);
+    M6502_IRQ(&cpu);
+    M6502_SetIRQLine(&cpu, TIMER_IRQ, 1);
+    M6502_SetIRQLine(&cpu, TIMER_IRQ, 0);
+    M6502_SetStatus(&cpu, M6502_GetStatus(&cpu) & ~0x04);
+    Settle("M6502_IRQ survived the line going high", 0, 1);
+}
+
+int main(void)
+{
+    BuildProgram();
+
+    ConnectBus(&cpu);
+    M6502_Init(&cpu);
+    cpu.programCounter = NOP_LOOP;
+    ConfigureCpu(&cpu);
+    M6502_Run(&cpu, 0);
+    M6502_SetStatus(&cpu, M6502_GetStatus(&cpu) & ~0x04);
+
+    TestNmiEdge();
+    TestIrqLevel();
+    TestIrqMasked();
+    TestIrqRequest();
+
+    printf("[Lines] Passed!\n");
+
+    return 0;
+}
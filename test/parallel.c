@@ -0,0 +1,375 @@
+#define PROGRAM_START 0x0400
+
+/* Writes to the outbox are sent to the other CPU's inbox, LATENCY cycles later. */
+#define OUTBOX 0x1800
+#define INBOX 0x1810
+#define PORT_SIZE 0x20
+#define LATENCY 40
+
+#define LOG_SIZE 0x20000
+#define RUN_CYCLES 300000
+
+#include <string.h>
+
+#include "test.h"
+
+#if !defined(M6502_SYSTEM) || !defined(M6502_PARALLEL)
+    #error "parallel.c needs M6502_SYSTEM and M6502_PARALLEL"
+#endif
+
+typedef struct
+{
+    uint64_t    time;
+    uint16_t    address;
+    uint8_t     value;
+} Read_t;
+
+struct Machine_s;
+
+/* One CPU's memory, the inbox reads it made, and under M6502_SYSTEM the messages on their way to it. */
+typedef struct
+{
+    uint8_t             memory[MEMORY_SIZE];
+    uint8_t             index;
+    struct Machine_s    *machine;
+    Read_t              log[LOG_SIZE];
+    uint32_t            logCount;
+    M6502_Message_t     queue[LOG_SIZE];
+    uint32_t            queueHead;
+    uint32_t            queueTail;
+} Node_t;
+
+typedef struct Machine_s
+{
+    M6502_t     cpus[2];
+    Node_t      nodes[2];
+    uint8_t     parallel;
+} Machine_t;
+
+static Machine_t expected;
+static Machine_t machine;
+static M6502_System_t cpuSystem;
+static M6502_Parallel_t cpuParallel;
+
+static uint8_t hostImage[MEMORY_SIZE];
+static uint8_t driveImage[MEMORY_SIZE];
+static uint8_t *image;
+static uint16_t cursor;
+static uint32_t seed = 0x6502u;
+
+void Emit(const uint8_t value)
+{
+    image[cursor++] = value;
+}
+
+void EmitWord(const uint16_t value)
+{
+    Emit((uint8_t)value);
+    Emit((uint8_t)(value >> 8));
+}
+
+uint32_t NextSlice(const uint32_t limit)
+{
+    seed = (seed * 1103515245u) + 12345u;
+
+    return 1u + ((seed >> 16u) % limit);
+}
+
+/* The host sends a counter, waits a little longer each round, then adds up whatever the drive last answered. */
+void BuildHost(void)
+{
+    image = hostImage;
+    cursor = PROGRAM_START;
+
+    Emit(0xA2); Emit(0x00);                 /* LDX #$00 */
+    const uint16_t loop = cursor;
+    Emit(0xE8);                             /* INX */
+    Emit(0x8E); EmitWord(OUTBOX);           /* STX OUTBOX */
+    Emit(0x8A);                             /* TXA */
+    Emit(0x29); Emit(0x0F);                 /* AND #$0F */
+    Emit(0xA8);                             /* TAY */
+    Emit(0x88);                             /* delay: DEY */
+    Emit(0x10); Emit(0xFD);                 /* BPL delay */
+    Emit(0xAD); EmitWord(INBOX);            /* LDA INBOX */
+    Emit(0x9D); EmitWord(0x0200);           /* STA $0200,X */
+    Emit(0x18);                             /* CLC */
+    Emit(0x6D); EmitWord(INBOX + 1);        /* ADC INBOX + 1 */
+    Emit(0x65); Emit(0x10);                 /* ADC $10 */
+    Emit(0x85); Emit(0x10);                 /* STA $10 */
+    Emit(0x4C); EmitWord(loop);             /* JMP loop */
+}
+
+/* The drive answers every new value with three times it, and counts its polls in a second outbox byte. */
+void BuildDrive(void)
+{
+    image = driveImage;
+    cursor = PROGRAM_START;
+
+    const uint16_t loop = cursor;
+    Emit(0xE6); Emit(0x11);                 /* INC $11 */
+    Emit(0xA5); Emit(0x11);                 /* LDA $11 */
+    Emit(0x8D); EmitWord(OUTBOX + 1);       /* STA OUTBOX + 1 */
+    Emit(0xAD); EmitWord(INBOX);            /* LDA INBOX */
+    Emit(0xC5); Emit(0x10);                 /* CMP $10 */
+    Emit(0xF0); Emit((uint8_t)(loop - (cursor + 1)));   /* BEQ loop */
+    Emit(0x85); Emit(0x10);                 /* STA $10 */
+    Emit(0x0A);                             /* ASL A */
+    Emit(0x65); Emit(0x10);                 /* ADC $10 */
+    Emit(0x8D); EmitWord(OUTBOX);           /* STA OUTBOX */
+    Emit(0xA4); Emit(0x10);                 /* LDY $10 */
+    Emit(0x99); EmitWord(0x0300);           /* STA $0300,Y */
+    Emit(0x4C); EmitWord(loop);             /* JMP loop */
+}
+
+uint8_t IsPort(const uint16_t address)
+{
+    return ((address >= OUTBOX) && (address < OUTBOX + PORT_SIZE)) ? 1 : 0;
+}
+
+/* Under M6502_SYSTEM the inbox takes what is due when it is read; the other CPU has caught up, so nothing due is still unsent. */
+void Receive(Node_t *node)
+{
+    const uint64_t now = node->machine->cpus[node->index].totalCycles;
+
+    while ((node->queueHead != node->queueTail) && (node->queue[node->queueHead].when <= now))
+    {
+        node->memory[node->queue[node->queueHead].address] = node->queue[node->queueHead].value;
+        node->queueHead++;
+    }
+}
+
+uint8_t NodeRead(void *context, const uint16_t address)
+{
+    Node_t *node = (Node_t *)context;
+
+    if (!IsPort(address))
+    {
+        return node->memory[address];
+    }
+
+    if (!node->machine->parallel)
+    {
+        Receive(node);
+    }
+
+    if (node->logCount == LOG_SIZE)
+    {
+        printf("[Parallel] Read log full\n");
+        exit(1);
+    }
+
+    Read_t *read = &node->log[node->logCount++];
+
+    read->time      = node->machine->cpus[node->index].totalCycles;
+    read->address   = address;
+    read->value     = node->memory[address];
+
+    return read->value;
+}
+
+void NodeWrite(void *context, const uint16_t address, const uint8_t value)
+{
+    Node_t *node = (Node_t *)context;
+    Machine_t *owner = node->machine;
+
+    if (!IsPort(address))
+    {
+        node->memory[address] = value;
+        return;
+    }
+
+    const uint8_t to = node->index ^ 1u;
+    const uint16_t inbox = (uint16_t)(address - OUTBOX + INBOX);
+
+    if (owner->parallel)
+    {
+        if (M6502_PostMessage(&cpuParallel, node->index, to, inbox, value) != 0)
+        {
+            printf("[Parallel] Message lost\n");
+            exit(1);
+        }
+
+        return;
+    }
+
+    Node_t *receiver = &owner->nodes[to];
+
+    if (receiver->queueTail == LOG_SIZE)
+    {
+        printf("[Parallel] Message queue full\n");
+        exit(1);
+    }
+
+    M6502_Message_t *message = &receiver->queue[receiver->queueTail++];
+
+    message->when       = owner->cpus[node->index].totalCycles + LATENCY;
+    message->address    = inbox;
+    message->value      = value;
+    message->from       = node->index;
+}
+
+void Deliver(M6502_t *cpu, void *context, const M6502_Message_t *message)
+{
+    (void)cpu;
+
+    ((Node_t *)context)->memory[message->address] = message->value;
+}
+
+void StartMachine(Machine_t *target, const uint8_t parallel)
+{
+    const uint8_t *images[2] = { hostImage, driveImage };
+
+    target->parallel = parallel;
+
+    for (uint8_t index = 0; index < 2; ++index)
+    {
+        Node_t *node = &target->nodes[index];
+        M6502_t *cpu = &target->cpus[index];
+
+        memcpy(node->memory, images[index], MEMORY_SIZE);
+        node->index         = index;
+        node->machine       = target;
+        node->logCount      = 0;
+        node->queueHead     = 0;
+        node->queueTail     = 0;
+
+        cpu->bus.read       = NodeRead;
+        cpu->bus.write      = NodeWrite;
+        cpu->bus.context    = node;
+        M6502_Init(cpu);
+        cpu->programCounter = PROGRAM_START;
+    }
+}
+
+/* Runs M6502_RunSystem in slices until the host has run at least until cycles. */
+void RunSystem(Machine_t *target, const uint32_t quantum, const uint32_t maxSlice, const uint64_t until)
+{
+    StartMachine(target, 0);
+    M6502_InitSystem(&cpuSystem, quantum);
+    M6502_AddSystemCpu(&cpuSystem, &target->cpus[0]);
+    M6502_AddSystemCpu(&cpuSystem, &target->cpus[1]);
+    M6502_SetShared(&cpuSystem, OUTBOX, PORT_SIZE, 1);
+
+    while (target->cpus[0].totalCycles < until)
+    {
+        const uint64_t left = until - target->cpus[0].totalCycles;
+        const uint32_t slice = NextSlice(maxSlice);
+
+        M6502_RunSystem(&cpuSystem, (slice < left) ? slice : (uint32_t)left);
+    }
+}
+
+/* Both CPUs stop on the first instruction boundary at or after until, which the system run gives for the host. */
+void RunParallel(Machine_t *target, const uint8_t threaded, const uint32_t maxSlice, const uint64_t until)
+{
+    StartMachine(target, 1);
+    M6502_InitParallel(&cpuParallel, LATENCY);
+    M6502_AddParallelCpu(&cpuParallel, &target->cpus[0], Deliver, &target->nodes[0]);
+    M6502_AddParallelCpu(&cpuParallel, &target->cpus[1], Deliver, &target->nodes[1]);
+
+    while (cpuParallel.clock < until)
+    {
+        const uint64_t left = until - cpuParallel.clock;
+        const uint32_t slice = NextSlice(maxSlice);
+
+        M6502_RunParallel(&cpuParallel, (slice < left) ? slice : (uint32_t)left, threaded);
+    }
+}
+
+void Fail(const char *run, const char *message, const uint32_t index)
+{
+    printf("[Parallel] %s: %s (CPU %u)\n", run, message, (unsigned)index);
+    exit(1);
+}
+
+/* Inbox bytes nobody has read yet hold whatever each scheduler has delivered so far, so they are left out. */
+void Compare(const char *run)
+{
+    for (uint32_t index = 0; index < 2; ++index)
+    {
+        const M6502_t *got = &machine.cpus[index];
+        const M6502_t *cpu = &expected.cpus[index];
+        const Node_t *gotNode = &machine.nodes[index];
+        const Node_t *node = &expected.nodes[index];
+
+        if ((got->programCounter != cpu->programCounter)
+            || (got->accumulator != cpu->accumulator)
+            || (got->xRegister != cpu->xRegister)
+            || (got->yRegister != cpu->yRegister)
+            || (got->stackPointer != cpu->stackPointer)
+            || (M6502_GetStatus(got) != M6502_GetStatus(cpu))
+            || (got->totalCycles != cpu->totalCycles))
+        {
+            printf("[Parallel] PC: 0x%04x/0x%04x cycles: %llu/%llu\n", got->programCounter, cpu->programCounter,
+                (unsigned long long)got->totalCycles, (unsigned long long)cpu->totalCycles);
+            Fail(run, "Registers differ", index);
+        }
+
+        if ((memcmp(gotNode->memory, node->memory, INBOX) != 0)
+            || (memcmp(&gotNode->memory[INBOX + PORT_SIZE / 2], &node->memory[INBOX + PORT_SIZE / 2],
+                MEMORY_SIZE - INBOX - PORT_SIZE / 2) != 0))
+        {
+            Fail(run, "Memory differs", index);
+        }
+
+        if (gotNode->logCount != node->logCount)
+        {
+            printf("[Parallel] %u port reads, expected %u\n", (unsigned)gotNode->logCount, (unsigned)node->logCount);
+            Fail(run, "Port read count differs", index);
+        }
+
+        for (uint32_t entry = 0; entry < node->logCount; ++entry)
+        {
+            const Read_t *read = &gotNode->log[entry];
+            const Read_t *want = &node->log[entry];
+
+            if ((read->time != want->time) || (read->address != want->address) || (read->value != want->value))
+            {
+                printf("[Parallel] Read 0x%04x = 0x%02x at cycle %llu, expected 0x%04x = 0x%02x at cycle %llu\n",
+                    read->address, read->value, (unsigned long long)read->time,
+                    want->address, want->value, (unsigned long long)want->time);
+                Fail(run, "Port read differs", index);
+            }
+        }
+    }
+}
+
+int main(void)
+{
+    BuildHost();
+    BuildDrive();
+
+    /* The reference run settles where the host stops; every other run has to stop there too. */
+    RunSystem(&expected, 0, 50000, RUN_CYCLES);
+
+    const uint64_t until = expected.cpus[0].totalCycles;
+
+    if ((expected.nodes[0].memory[0x10] == 0) || (expected.nodes[1].logCount == 0))
+    {
+        Fail("System", "The CPUs never talked", 0);
+    }
+
+    static const uint32_t quanta[] = { 1, 7, 100, 20000 };
+
+    for (uint32_t index = 0; index < sizeof(quanta) / sizeof(quanta[0]); ++index)
+    {
+        RunSystem(&machine, quanta[index], 5000, until);
+        Compare("System");
+    }
+
+    RunParallel(&machine, 0, 50000, until);
+    Compare("Parallel, one thread");
+
+    RunParallel(&machine, 0, 3, until);
+    Compare("Parallel, one thread, short slices");
+
+    for (uint32_t round = 0; round < 4; ++round)
+    {
+        RunParallel(&machine, 1, (round & 1) ? 997 : 50000, until);
+        Compare("Parallel, threads");
+    }
+
+    printf("[Parallel] Passed!\n");
+
+    return 0;
+}
@@ -0,0 +1,288 @@
+#define PROGRAM_START 0x0400
+
+#define CALL_COUNT 64
+
+/* NOP takes 2 cycles, so a callback runs at most 1 cycle after its deadline. */
+#define NOP_CYCLES 2
+
+/* A loop of loads with and without page crossings, taken branches and a jump; it never writes. */
+#define STEP_PROGRAM 0x8000
+#define STEP_SLICES 20000
+
+#include <string.h>
+
+#include "test.h"
+
+#ifndef M6502_SCHEDULER
+    #error "scheduler.c needs M6502_SCHEDULER"
+#endif
+
+#if M6502_EVENT_COUNT < 8
+    #error "scheduler.c keeps up to 7 events pending at once"
+#endif
+
+typedef struct
+{
+    uint32_t    id;
+    uint64_t    when;
+    uint64_t    fired;
+} Entry_t;
+
+static Entry_t calls[CALL_COUNT];
+static uint32_t callCount;
+
+static uint64_t deadlines[CALL_COUNT];
+static int handles[CALL_COUNT];
+
+static uint32_t seed = 0x6502u;
+
+void Fail(const char *message, const uint32_t index)
+{
+    printf("[Scheduler] %s (entry %u)\n", message, (unsigned)index);
+    exit(1);
+}
+
+void Record(M6502_t *cpu, void *context)
+{
+    const uint32_t id = (uint32_t)(uintptr_t)context;
+
+    if (callCount == CALL_COUNT)
+    {
+        Fail("Too many callbacks", callCount);
+    }
+
+    calls[callCount].id    = id;
+    calls[callCount].when  = deadlines[id];
+    calls[callCount].fired = cpu->totalCycles;
+    ++callCount;
+}
+
+void Schedule(M6502_t *cpu, const uint32_t id, const uint64_t when, M6502_EventCallback_t callback)
+{
+    deadlines[id] = when;
+    handles[id] = M6502_ScheduleEvent(cpu, when, callback, (void *)(uintptr_t)id);
+
+    if (handles[id] < 0)
+    {
+        Fail("No free event slot", id);
+    }
+}
+
+/* Every callback ran on time, ids in the expected order. */
+void Expect(const uint32_t *ids, const uint32_t count)
+{
+    if (callCount != count)
+    {
+        printf("[Scheduler] %u callbacks ran, expected %u\n", (unsigned)callCount, (unsigned)count);
+        exit(1);
+    }
+
+    for (uint32_t index = 0; index < count; ++index)
+    {
+        if (calls[index].id != ids[index])
+        {
+            printf("[Scheduler] Callback %u ran as number %u, expected %u\n",
+                (unsigned)calls[index].id, (unsigned)index, (unsigned)ids[index]);
+            exit(1);
+        }
+
+        if ((calls[index].fired < calls[index].when) || (calls[index].fired >= calls[index].when + NOP_CYCLES))
+        {
+            printf("[Scheduler] Callback %u for cycle %llu ran at %llu\n", (unsigned)calls[index].id,
+                (unsigned long long)calls[index].when, (unsigned long long)calls[index].fired);
+            exit(1);
+        }
+    }
+
+    callCount = 0;
+}
+
+/* Deadlines in scrambled order come out sorted, whatever the M6502_Run budgets. */
+void TestOrdered(M6502_t *cpu, const uint32_t budget)
+{
+    uint32_t ids[M6502_EVENT_COUNT];
+    const uint64_t start = cpu->totalCycles;
+
+    for (uint32_t index = 0; index < M6502_EVENT_COUNT; ++index)
+    {
+        const uint32_t rank = (index * 7) % M6502_EVENT_COUNT;
+
+        Schedule(cpu, index, start + 1 + rank * 13, Record);
+        ids[rank] = index;
+    }
+
+    if (M6502_ScheduleEvent(cpu, start, Record, NULL) != -1)
+    {
+        Fail("A full scheduler accepted an event", M6502_EVENT_COUNT);
+    }
+
+    while (cpu->totalCycles < start + 1 + M6502_EVENT_COUNT * 13)
+    {
+        M6502_Run(cpu, budget);
+    }
+
+    Expect(ids, M6502_EVENT_COUNT);
+}
+
+/* Events due on the same cycle run in the order they were scheduled, and a retimed one goes last. */
+void TestSameCycle(M6502_t *cpu)
+{
+    static const uint32_t ids[] = { 1, 3, 4, 6, 0, 5, 2 };
+    const uint64_t when = cpu->totalCycles + 50;
+
+    Schedule(cpu, 0, when + 20, Record);
+    Schedule(cpu, 1, when, Record);
+    Schedule(cpu, 2, when, Record);
+    Schedule(cpu, 3, when, Record);
+    Schedule(cpu, 4, when, Record);
+    Schedule(cpu, 5, when + 20, Record);
+    Schedule(cpu, 6, when + 40, Record);
+
+    M6502_RetimeEvent(cpu, handles[6], when);
+    M6502_RetimeEvent(cpu, handles[2], when + 20);
+    deadlines[6] = when;
+    deadlines[2] = when + 20;
+
+    M6502_Run(cpu, 100);
+
+    Expect(ids, sizeof(ids) / sizeof(ids[0]));
+}
+
+/* Schedules id + 1 for now (already due) and id + 2 for later, and cancels id + 3. */
+void Chain(M6502_t *cpu, void *context)
+{
+    const uint32_t id = (uint32_t)(uintptr_t)context;
+
+    Record(cpu, context);
+
+    Schedule(cpu, id + 1, cpu->totalCycles, Record);
+    Schedule(cpu, id + 2, cpu->totalCycles + 30, Record);
+    M6502_CancelEvent(cpu, handles[id + 3]);
+}
+
+/* Like the timer in the README: reschedules itself until it has run five times. */
+void Periodic(M6502_t *cpu, void *context)
+{
+    const uint32_t id = (uint32_t)(uintptr_t)context;
+
+    Record(cpu, context);
+
+    if (id < 14)
+    {
+        Schedule(cpu, id + 1, deadlines[id] + 100, Periodic);
+    }
+}
+
+void TestFromCallback(M6502_t *cpu)
+{
+    static const uint32_t chain[] = { 0, 4, 1, 2, 5 };
+    static const uint32_t periodic[] = { 10, 11, 12, 13, 14 };
+    const uint64_t when = cpu->totalCycles + 20;
+
+    /* 4 is due with 0; 1 is scheduled by 0 for the same cycle and runs after it, 3 never runs. */
+    Schedule(cpu, 0, when, Chain);
+    Schedule(cpu, 3, when, Record);
+    Schedule(cpu, 4, when, Record);
+    Schedule(cpu, 5, when + 60, Record);
+
+    M6502_Run(cpu, 200);
+
+    Expect(chain, sizeof(chain) / sizeof(chain[0]));
+
+    Schedule(cpu, 10, cpu->totalCycles + 10, Periodic);
+
+    M6502_Run(cpu, 1000);
+
+    Expect(periodic, sizeof(periodic) / sizeof(periodic[0]));
+}
+
+uint32_t NextRandom(void)
+{
+    seed = (seed * 1103515245u) + 12345u;
+
+    return seed >> 16u;
+}
+
+/* Random runs of M6502_Step and M6502_Run agree with one M6502_Run per instruction on PC and totalCycles. */
+void TestStepRun(M6502_t *cpu)
+{
+    static const uint8_t program[] = {
+        0xA2, 0x00,                 /* LDX #$00 */
+        0xBD, 0xF0, 0x12,           /* LDA $12F0,X */
+        0x69, 0x33,                 /* ADC #$33 */
+        0xB1, 0x10,                 /* LDA ($10),Y */
+        0xC8,                       /* INY */
+        0xE8,                       /* INX */
+        0xD0, 0xF5,                 /* BNE $8002 */
+        0x4C, 0x00, 0x80            /* JMP $8000 */
+    };
+
+    memcpy(&memory[STEP_PROGRAM], program, sizeof(program));
+    cpu->programCounter = STEP_PROGRAM;
+
+    /* The program leaves memory alone, so a copy can run it as the reference. */
+    M6502_t reference = *cpu;
+
+    for (uint32_t slice = 0; slice < STEP_SLICES; ++slice)
+    {
+        const uint32_t random = NextRandom();
+
+        if ((random & 1u) != 0u)
+        {
+            M6502_Run(cpu, 1u + ((random >> 1u) % 40u));
+        }
+        else
+        {
+            for (uint32_t step = 0; step < 1u + ((random >> 1u) % 9u); ++step)
+            {
+                M6502_Step(cpu);
+            }
+        }
+
+        /* Only between instructions: mid-instruction, the PC is already past it. */
+        if (cpu->cycles != 0u)
+        {
+            continue;
+        }
+
+        while (reference.totalCycles < cpu->totalCycles)
+        {
+            M6502_Run(&reference, 1);
+        }
+
+        if ((cpu->programCounter != reference.programCounter) || (cpu->totalCycles != reference.totalCycles))
+        {
+            printf("[Scheduler] Step and Run differ after slice %u! - PC: 0x%04x/0x%04x cycles: %llu/%llu\n",
+                (unsigned)slice, cpu->programCounter, reference.programCounter,
+                (unsigned long long)cpu->totalCycles, (unsigned long long)reference.totalCycles);
+            exit(1);
+        }
+    }
+}
+
+int main(void)
+{
+    M6502_t cpu;
+
+    for (size_t index = 0; index < MEMORY_SIZE; ++index)
+    {
+        memory[index] = 0xEA;
+    }
+
+    ConnectBus(&cpu);
+    M6502_Init(&cpu);
+    cpu.programCounter = PROGRAM_START;
+    ConfigureCpu(&cpu);
+    M6502_Run(&cpu, 0);
+
+    TestOrdered(&cpu, 1000);
+    TestOrdered(&cpu, 3);
+    TestOrdered(&cpu, 1);
+    TestSameCycle(&cpu);
+    TestFromCallback(&cpu);
+    TestStepRun(&cpu);
+
+    printf("[Scheduler] Passed!\n");
+
+    return 0;
+}
@@ -0,0 +1,354 @@
+#define PROGRAM_START 0x0400
+
+#define SHARED_BASE 0x1800
+#define SHARED_SIZE 0x10
+#define MAILBOX 0x1800
+#define ACK 0x1801
+#define DRIVE_IRQ_PORT 0x1802
+#define DRIVE_IRQ_ACK 0x1803
+#define DRIVE_HANDLER 0x0500
+
+#define DRIVE_IRQ (1u << 0)
+
+#define LOG_SIZE 0x40000
+#define RUN_CYCLES 200000
+
+#include <string.h>
+
+#include "test.h"
+
+#ifndef M6502_SYSTEM
+    #error "system.c needs M6502_SYSTEM"
+#endif
+
+typedef struct
+{
+    uint64_t    time;
+    uint16_t    address;
+    uint8_t     value;
+    uint8_t     cpu;
+    uint8_t     write;
+} Access_t;
+
+struct Machine_s;
+
+typedef struct
+{
+    uint8_t             memory[MEMORY_SIZE];
+    uint8_t             index;
+    struct Machine_s    *machine;
+} Node_t;
+
+/* A host and a drive CPU, each with its own memory, and the port they share. */
+typedef struct Machine_s
+{
+    M6502_t     cpus[2];
+    Node_t      nodes[2];
+    uint8_t     shared[SHARED_SIZE];
+    Access_t    log[LOG_SIZE];
+    uint32_t    logCount;
+} Machine_t;
+
+static Machine_t reference;
+static Machine_t machine;
+static M6502_System_t cpuSystem;
+
+static uint8_t hostImage[MEMORY_SIZE];
+static uint8_t driveImage[MEMORY_SIZE];
+static uint8_t *image;
+static uint16_t cursor;
+static uint32_t seed = 0x6502u;
+
+void Emit(const uint8_t value)
+{
+    image[cursor++] = value;
+}
+
+void EmitWord(const uint16_t value)
+{
+    Emit((uint8_t)value);
+    Emit((uint8_t)(value >> 8));
+}
+
+uint32_t NextSlice(const uint32_t limit)
+{
+    seed = (seed * 1103515245u) + 12345u;
+
+    return 1u + ((seed >> 16u) % limit);
+}
+
+/* The host writes a counter to the mailbox, waits a little longer each time and reads back the drive's answer; every 16th round it interrupts the drive. */
+void BuildHost(void)
+{
+    image = hostImage;
+    cursor = PROGRAM_START;
+
+    Emit(0xA2); Emit(0x00);                 /* LDX #$00 */
+    const uint16_t loop = cursor;
+    Emit(0xE8);                             /* INX */
+    Emit(0x8E); EmitWord(MAILBOX);          /* STX MAILBOX */
+    Emit(0x8A);                             /* TXA */
+    Emit(0x29); Emit(0x07);                 /* AND #$07 */
+    Emit(0xA8);                             /* TAY */
+    Emit(0x88);                             /* delay: DEY */
+    Emit(0x10); Emit(0xFD);                 /* BPL delay */
+    Emit(0xAD); EmitWord(ACK);              /* LDA ACK */
+    Emit(0x9D); EmitWord(0x0200);           /* STA $0200,X */
+    Emit(0x8A);                             /* TXA */
+    Emit(0x29); Emit(0x0F);                 /* AND #$0F */
+    Emit(0xD0); Emit((uint8_t)(loop - (cursor + 1)));   /* BNE loop */
+    Emit(0x8E); EmitWord(DRIVE_IRQ_PORT);   /* STX DRIVE_IRQ_PORT */
+    Emit(0x4C); EmitWord(loop);             /* JMP loop */
+}
+
+/* The drive polls the mailbox and echoes every new value; its IRQ handler counts and acknowledges. */
+void BuildDrive(void)
+{
+    image = driveImage;
+    cursor = PROGRAM_START;
+
+    Emit(0x58);                             /* CLI */
+    const uint16_t loop = cursor;
+    Emit(0xAD); EmitWord(MAILBOX);          /* LDA MAILBOX */
+    Emit(0xC5); Emit(0x10);                 /* CMP $10 */
+    Emit(0xF0); Emit(0xF9);                 /* BEQ loop */
+    Emit(0x85); Emit(0x10);                 /* STA $10 */
+    Emit(0x8D); EmitWord(ACK);              /* STA ACK */
+    Emit(0x4C); EmitWord(loop);             /* JMP loop */
+
+    cursor = DRIVE_HANDLER;
+    Emit(0xE6); Emit(0x11);                 /* INC $11 */
+    Emit(0x8D); EmitWord(DRIVE_IRQ_ACK);    /* STA DRIVE_IRQ_ACK */
+    Emit(0x40);                             /* RTI */
+
+    driveImage[0xFFFE] = (uint8_t)DRIVE_HANDLER;
+    driveImage[0xFFFF] = (uint8_t)(DRIVE_HANDLER >> 8);
+}
+
+void Log(Node_t *node, const uint16_t address, const uint8_t value, const uint8_t write)
+{
+    Machine_t *owner = node->machine;
+
+    if (owner->logCount == LOG_SIZE)
+    {
+        printf("[System] Access log full\n");
+        exit(1);
+    }
+
+    Access_t *access = &owner->log[owner->logCount++];
+
+    access->time    = owner->cpus[node->index].totalCycles;
+    access->address = address;
+    access->value   = value;
+    access->cpu     = node->index;
+    access->write   = write;
+}
+
+uint8_t IsShared(const uint16_t address)
+{
+    return ((address >= SHARED_BASE) && (address < SHARED_BASE + SHARED_SIZE)) ? 1 : 0;
+}
+
+/* The vector fetch is logged too, so the drive's IRQ shows up at the cycle it is taken. */
+uint8_t NodeRead(void *context, const uint16_t address)
+{
+    Node_t *node = (Node_t *)context;
+
+    if (IsShared(address))
+    {
+        const uint8_t value = node->machine->shared[address - SHARED_BASE];
+
+        Log(node, address, value, 0);
+        return value;
+    }
+
+    if (address == 0xFFFE)
+    {
+        Log(node, address, node->memory[address], 0);
+    }
+
+    return node->memory[address];
+}
+
+void NodeWrite(void *context, const uint16_t address, const uint8_t value)
+{
+    Node_t *node = (Node_t *)context;
+    Machine_t *owner = node->machine;
+
+    if (!IsShared(address))
+    {
+        node->memory[address] = value;
+        return;
+    }
+
+    owner->shared[address - SHARED_BASE] = value;
+    Log(node, address, value, 1);
+
+    if (address == DRIVE_IRQ_PORT)
+    {
+        M6502_SetIRQLine(&owner->cpus[1], DRIVE_IRQ, 1);
+    }
+    else if (address == DRIVE_IRQ_ACK)
+    {
+        M6502_SetIRQLine(&owner->cpus[1], DRIVE_IRQ, 0);
+    }
+}
+
+void StartMachine(Machine_t *target)
+{
+    const uint8_t *images[2] = { hostImage, driveImage };
+
+    memset(target->shared, 0, sizeof(target->shared));
+    target->logCount = 0;
+
+    for (uint8_t index = 0; index < 2; ++index)
+    {
+        Node_t *node = &target->nodes[index];
+        M6502_t *cpu = &target->cpus[index];
+
+        memcpy(node->memory, images[index], MEMORY_SIZE);
+        node->index         = index;
+        node->machine       = target;
+
+        cpu->bus.read       = NodeRead;
+        cpu->bus.write      = NodeWrite;
+        cpu->bus.context    = node;
+        M6502_Init(cpu);
+        cpu->programCounter = PROGRAM_START;
+    }
+}
+
+/* Instruction by instruction, always the CPU furthest behind, the host first on a tie: what the system must match. */
+void StepReference(const uint64_t until)
+{
+    for (;;)
+    {
+        M6502_t *host = &reference.cpus[0];
+        M6502_t *drive = &reference.cpus[1];
+
+        if ((host->totalCycles >= until) && (drive->totalCycles >= until))
+        {
+            return;
+        }
+
+        M6502_Run((drive->totalCycles < host->totalCycles) ? drive : host, 1);
+    }
+}
+
+void Fail(const char *message, const uint32_t quantum, const uint32_t entry)
+{
+    printf("[System] %s (quantum %u, access %u)\n", message, (unsigned)quantum, (unsigned)entry);
+    exit(1);
+}
+
+/* Accesses to the port happen in cycle order, the host first on a tie, so every read sees every write made before it. */
+void CheckOrder(const uint32_t quantum)
+{
+    for (uint32_t entry = 1; entry < machine.logCount; ++entry)
+    {
+        const Access_t *before = &machine.log[entry - 1];
+        const Access_t *after = &machine.log[entry];
+
+        if ((after->time < before->time) || ((after->time == before->time) && (after->cpu < before->cpu)))
+        {
+            printf("[System] CPU %u at cycle %llu went after CPU %u at cycle %llu\n", after->cpu,
+                (unsigned long long)after->time, before->cpu, (unsigned long long)before->time);
+            Fail("Port accesses out of order", quantum, entry);
+        }
+    }
+}
+
+void Compare(const uint32_t quantum)
+{
+    if (machine.logCount != reference.logCount)
+    {
+        printf("[System] %u port accesses, expected %u\n", (unsigned)machine.logCount, (unsigned)reference.logCount);
+        Fail("Access count differs", quantum, 0);
+    }
+
+    for (uint32_t entry = 0; entry < machine.logCount; ++entry)
+    {
+        const Access_t *got = &machine.log[entry];
+        const Access_t *expected = &reference.log[entry];
+
+        if ((got->time != expected->time) || (got->address != expected->address) || (got->value != expected->value)
+            || (got->cpu != expected->cpu) || (got->write != expected->write))
+        {
+            printf("[System] CPU %u %s 0x%04x = 0x%02x at cycle %llu, expected CPU %u %s 0x%04x = 0x%02x at cycle %llu\n",
+                got->cpu, got->write ? "wrote" : "read", got->address, got->value, (unsigned long long)got->time,
+                expected->cpu, expected->write ? "wrote" : "read", expected->address, expected->value,
+                (unsigned long long)expected->time);
+            Fail("Port access differs", quantum, entry);
+        }
+    }
+
+    for (uint32_t index = 0; index < 2; ++index)
+    {
+        const M6502_t *got = &machine.cpus[index];
+        const M6502_t *expected = &reference.cpus[index];
+
+        if ((got->programCounter != expected->programCounter)
+            || (got->accumulator != expected->accumulator)
+            || (got->xRegister != expected->xRegister)
+            || (got->yRegister != expected->yRegister)
+            || (got->stackPointer != expected->stackPointer)
+            || (M6502_GetStatus(got) != M6502_GetStatus(expected))
+            || (got->totalCycles != expected->totalCycles)
+            || (memcmp(machine.nodes[index].memory, reference.nodes[index].memory, MEMORY_SIZE) != 0))
+        {
+            printf("[System] CPU %u differs - PC: 0x%04x/0x%04x cycles: %llu/%llu\n", (unsigned)index,
+                got->programCounter, expected->programCounter,
+                (unsigned long long)got->totalCycles, (unsigned long long)expected->totalCycles);
+            Fail("Final state differs", quantum, machine.logCount);
+        }
+    }
+}
+
+/* Runs the system in slices of up to maxSlice cycles and checks it against the stepped reference. */
+void TestQuantum(const uint32_t quantum, const uint32_t maxSlice)
+{
+    StartMachine(&machine);
+    M6502_InitSystem(&cpuSystem, quantum);
+    M6502_AddSystemCpu(&cpuSystem, &machine.cpus[0]);
+    M6502_AddSystemCpu(&cpuSystem, &machine.cpus[1]);
+    M6502_SetShared(&cpuSystem, SHARED_BASE, SHARED_SIZE, 1);
+
+    uint32_t total = 0;
+
+    while (total < RUN_CYCLES)
+    {
+        total += M6502_RunSystem(&cpuSystem, NextSlice(maxSlice));
+    }
+
+    CheckOrder(quantum);
+
+    StartMachine(&reference);
+    M6502_Run(&reference.cpus[0], 0);
+    M6502_Run(&reference.cpus[1], 0);
+    StepReference(machine.cpus[0].totalCycles);
+
+    Compare(quantum);
+
+    /* The drive has to have answered and taken its interrupts for the comparison to mean anything. */
+    if ((machine.nodes[1].memory[0x11] == 0) || (machine.nodes[0].memory[0x0280] == 0) || (cpuSystem.syncs == 0))
+    {
+        Fail("The CPUs never talked", quantum, machine.logCount);
+    }
+}
+
+int main(void)
+{
+    BuildHost();
+    BuildDrive();
+
+    TestQuantum(0, 50000);
+    TestQuantum(0, 3);
+    TestQuantum(1, 1000);
+    TestQuantum(7, 100);
+    TestQuantum(100, 20000);
+    TestQuantum(20000, 50000);
+
+    printf("[System] Passed!\n");
+
+    return 0;
+}
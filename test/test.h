@@ -2,13 +2,8 @@
 #include <stdio.h>
 #include <stdlib.h>
 
-#include "../m6502.h"
-
-#ifndef PROGRAM_FILE
-    #define PROGRAM_FILE ""
-    #error "MISSING PROGRAM_FILE"
-#endif
-
+/* Tests that write their own programs leave PROGRAM_FILE undefined. */
+#ifdef PROGRAM_FILE
 #ifndef PROGRAM_FILE_START
     #define PROGRAM_FILE_START 0x0000
 #endif
@@ -26,19 +21,118 @@
     #define SUCCESS_PC 0x0000
     #error "MISSING SUCCESS_PC"
 #endif
+#endif
 
 #define MEMORY_SIZE 0x10000
 
 uint8_t memory[MEMORY_SIZE];
 
+#ifdef FEEDBACK_PORT
+/* Defined by the test: writes to the port reach it from inside the write callback. */
+void FeedbackWrite(uint8_t value);
+#endif
+
+#ifdef M6502_IMPLEMENTATION
+/* The core is compiled into this file, so the callbacks can be inlined. */
+static inline uint8_t M6502_ExternalReadMemory(uint16_t address)
+#else
 uint8_t M6502_ExternalReadMemory(uint16_t address)
+#endif
 {
     return memory[address];
 }
 
+#ifdef M6502_IMPLEMENTATION
+static inline void M6502_ExternalWriteMemory(uint16_t address, uint8_t value)
+#else
 void M6502_ExternalWriteMemory(uint16_t address, uint8_t value)
+#endif
 {
     memory[address] = value;
+
+#ifdef FEEDBACK_PORT
+    if (address == FEEDBACK_PORT)
+    {
+        FeedbackWrite(value);
+    }
+#endif
+}
+
+#include "../m6502.h"
+
+#ifdef M6502_BLOCK_CACHE
+M6502_BlockCache_t blockCache;
+#endif
+
+#ifdef M6502_BUS
+uint8_t BusRead(void *context, uint16_t address)
+{
+    return ((uint8_t *)context)[address];
+}
+
+void BusWrite(void *context, uint16_t address, uint8_t value)
+{
+    ((uint8_t *)context)[address] = value;
+
+#ifdef FEEDBACK_PORT
+    if (address == FEEDBACK_PORT)
+    {
+        FeedbackWrite(value);
+    }
+#endif
+}
+#endif
+
+void ConnectBus(M6502_t *cpu)
+{
+#if defined(M6502_FLAT_MEMORY)
+    cpu->memory         = memory;
+#elif defined(M6502_BUS)
+    cpu->bus.read       = BusRead;
+    cpu->bus.write      = BusWrite;
+    cpu->bus.context    = memory;
+#else
+    (void)cpu;
+#endif
+}
+
+#ifdef M6502_PINS
+uint32_t pins = 0;
+
+/* Plays the memory side of the bus for one clock cycle. */
+void Tick(M6502_t *cpu)
+{
+    pins = M6502_Tick(cpu, pins);
+
+    const uint16_t address = M6502_PINS_ADDRESS(pins);
+
+    if (pins & M6502_PIN_RW)
+    {
+        pins = M6502_PINS_SET_DATA(pins, memory[address]);
+    }
+    else
+    {
+        memory[address] = M6502_PINS_DATA(pins);
+    }
+}
+#endif
+
+/* Runs one instruction or interrupt sequence, cycle by cycle when M6502_PINS is set. */
+void RunInstruction(M6502_t *cpu)
+{
+#ifdef M6502_PINS
+    if (cpu->pinCycle == 0)
+    {
+        Tick(cpu);
+    }
+
+    do
+    {
+        Tick(cpu);
+    } while (!(pins & M6502_PIN_SYNC) && (cpu->jammed != 0xFF));
+#else
+    M6502_Run(cpu, 1);
+#endif
 }
 
 uint8_t GetFlag(uint8_t status, uint8_t flag)
@@ -46,6 +140,23 @@ uint8_t GetFlag(uint8_t status, uint8_t flag)
     return ((status & flag) > 0) ? 1 : 0;
 }
 
+void ConfigureCpu(M6502_t *cpu)
+{
+#ifdef M6502_BLOCK_CACHE
+    M6502_AttachBlockCache(cpu, &blockCache);
+#endif
+#ifdef M6502_PAGE_TABLE
+    M6502_MapMemory(cpu, 0x0000, MEMORY_SIZE, memory, 0);
+#endif
+#ifdef M6502_SIDE_EFFECT_FREE
+    M6502_SetSideEffectFree(cpu, 0x0000, MEMORY_SIZE, 1);
+#endif
+#ifdef M6502_IDLE_SKIP
+    M6502_SetIdleSafe(cpu, 0x0000, MEMORY_SIZE, 1);
+#endif
+    (void)cpu;
+}
+
 void ClearMemory()
 {
     for (size_t index = 0; index < MEMORY_SIZE; ++index)
@@ -54,6 +165,7 @@ void ClearMemory()
     }
 }
 
+#ifdef PROGRAM_FILE
 uint8_t OpenFileTest()
 {
     FILE *fp = fopen(PROGRAM_FILE, "rb");
@@ -69,5 +181,13 @@ uint8_t OpenFileTest()
 
     fclose(fp);
 
+    if (result == 0)
+    {
+        printf(PROGRAM_FILE);
+        printf(" is empty!\n");
+        return 0;
+    }
+
     return 1;
-}
\ No newline at end of file
+}
+#endif
\ No newline at end of file